@@ -0,0 +1,64 @@
+#include "mem_units/alignment.hpp"
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    std::vector<bytes> request_sizes() {
+        std::mt19937_64 random(42);
+        std::vector<bytes> sizes(4'096);
+        for (auto &size : sizes) {
+            size = bytes(random() >> 30);
+        }
+        return sizes;
+    }
+}
+
+static void BM_RawMaskAlignUp(benchmark::State& state) {
+    const auto sizes = request_sizes();
+    constexpr std::uint64_t alignment = 2 * 1'024 * 1'024;
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            benchmark::DoNotOptimize((size.count() + alignment - 1) & ~(alignment - 1));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_RawMaskAlignUp);
+
+static void BM_AlignUp(benchmark::State& state) {
+    const auto sizes = request_sizes();
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            benchmark::DoNotOptimize(align_up(size, 2_mb));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_AlignUp);
+
+static void BM_AlignUpToPageSize(benchmark::State& state) {
+    const auto sizes = request_sizes();
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            benchmark::DoNotOptimize(align_up(size, page_size()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_AlignUpToPageSize);
+
+static void BM_PagesIn(benchmark::State& state) {
+    const auto sizes = request_sizes();
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            benchmark::DoNotOptimize(pages_in(size, 4_kb));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_PagesIn);
@@ -0,0 +1,108 @@
+#include "mem_units/arena.hpp"
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdlib>
+#include <memory_resource>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    constexpr std::size_t allocations_per_round = 1'024;
+    constexpr std::array<std::size_t, 8> allocation_sizes{16, 24, 48, 64, 100, 128, 200, 256};
+}
+
+static void BM_MallocRound(benchmark::State& state) {
+    std::array<void *, allocations_per_round> pointers;
+    for (auto _ : state) {
+        for (std::size_t index = 0; index < allocations_per_round; ++index) {
+            pointers[index] = std::malloc(allocation_sizes[index % allocation_sizes.size()]);
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (auto *pointer : pointers) {
+            std::free(pointer);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * allocations_per_round);
+}
+BENCHMARK(BM_MallocRound);
+
+static void BM_MonotonicBufferResourceRound(benchmark::State& state) {
+    std::vector<std::byte> buffer(512 * 1'024);
+    std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    for (auto _ : state) {
+        for (std::size_t index = 0; index < allocations_per_round; ++index) {
+            benchmark::DoNotOptimize(resource.allocate(allocation_sizes[index % allocation_sizes.size()]));
+        }
+        resource.release();
+    }
+    state.SetItemsProcessed(state.iterations() * allocations_per_round);
+}
+BENCHMARK(BM_MonotonicBufferResourceRound);
+
+static void BM_MonotonicArenaRound(benchmark::State& state) {
+    monotonic_arena<512_kb> arena;
+    for (auto _ : state) {
+        for (std::size_t index = 0; index < allocations_per_round; ++index) {
+            benchmark::DoNotOptimize(arena.allocate(allocation_sizes[index % allocation_sizes.size()]));
+        }
+        arena.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * allocations_per_round);
+}
+BENCHMARK(BM_MonotonicArenaRound);
+
+static void BM_MallocBlockChurn(benchmark::State& state) {
+    std::array<void *, allocations_per_round> pointers{};
+    for (auto &pointer : pointers) {
+        pointer = std::malloc(256);
+    }
+    std::size_t index = 0;
+    for (auto _ : state) {
+        std::free(pointers[index]);
+        pointers[index] = std::malloc(256);
+        benchmark::DoNotOptimize(pointers[index]);
+        index = (index + 7) % allocations_per_round;
+    }
+    for (auto *pointer : pointers) {
+        std::free(pointer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MallocBlockChurn);
+
+static void BM_PoolResourceBlockChurn(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource resource;
+    std::array<void *, allocations_per_round> pointers{};
+    for (auto &pointer : pointers) {
+        pointer = resource.allocate(256);
+    }
+    std::size_t index = 0;
+    for (auto _ : state) {
+        resource.deallocate(pointers[index], 256);
+        pointers[index] = resource.allocate(256);
+        benchmark::DoNotOptimize(pointers[index]);
+        index = (index + 7) % allocations_per_round;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PoolResourceBlockChurn);
+
+static void BM_BlockPoolBlockChurn(benchmark::State& state) {
+    block_pool<256_b, 1_mb> pool;
+    std::array<void *, allocations_per_round> pointers{};
+    for (auto &pointer : pointers) {
+        pointer = pool.allocate();
+    }
+    std::size_t index = 0;
+    for (auto _ : state) {
+        pool.deallocate(pointers[index]);
+        pointers[index] = pool.allocate();
+        benchmark::DoNotOptimize(pointers[index]);
+        index = (index + 7) % allocations_per_round;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BlockPoolBlockChurn);
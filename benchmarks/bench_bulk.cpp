@@ -0,0 +1,104 @@
+#include "mem_units/bulk.hpp"
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace afs::mem_units;
+
+namespace {
+    std::vector<bytes> heap_dump(const std::size_t size) {
+        std::mt19937_64 random(size);
+        std::vector<bytes> sizes;
+        sizes.reserve(size);
+        for (std::size_t index = 0; index < size; ++index) {
+            sizes.emplace_back(random() >> 24);
+        }
+        return sizes;
+    }
+}
+
+static void BM_ElementwiseSum(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        bytes total{};
+        for (const auto size : sizes) {
+            total += size;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ElementwiseSum)->Range(1 << 10, 1 << 20);
+
+static void BM_BulkSum(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sum<bytes>(sizes));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BulkSum)->Range(1 << 10, 1 << 20);
+
+static void BM_ElementwiseConvert(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    std::vector<bits> converted(sizes.size());
+    for (auto _ : state) {
+        std::ranges::transform(sizes, converted.begin(), [](const bytes size) { return memory_unit_cast<bits>(size); });
+        benchmark::DoNotOptimize(converted.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ElementwiseConvert)->Range(1 << 10, 1 << 20);
+
+static void BM_BulkConvert(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    std::vector<bits> converted(sizes.size());
+    for (auto _ : state) {
+        convert<bits, bytes>(sizes, converted);
+        benchmark::DoNotOptimize(converted.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BulkConvert)->Range(1 << 10, 1 << 20);
+
+static void BM_ElementwiseCountGreater(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    const auto threshold = memory_unit_cast<bytes>(kilobytes(1ULL << 28));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::ranges::count_if(sizes, [&](const bytes size) { return size > threshold; }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ElementwiseCountGreater)->Range(1 << 10, 1 << 20);
+
+static void BM_BulkCountGreater(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    const kilobytes threshold(1ULL << 28);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(count_greater<bytes>(sizes, threshold));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BulkCountGreater)->Range(1 << 10, 1 << 20);
+
+static void BM_ElementwiseMax(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(*std::max_element(sizes.begin(), sizes.end()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ElementwiseMax)->Range(1 << 10, 1 << 20);
+
+static void BM_BulkMax(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(max<bytes>(sizes));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BulkMax)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,138 @@
+#include "mem_units/byte_bounded_queue.hpp"
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    /// Payloads from 100 bytes to 1 megabyte, mostly small ones.
+    std::vector<std::vector<char> > mixed_payloads() {
+        std::mt19937_64 random(42);
+        std::lognormal_distribution<double> distribution(7.0, 2.0);
+        std::vector<std::vector<char> > payloads(256);
+        for (auto &payload : payloads) {
+            payload.resize(std::clamp<std::size_t>(static_cast<std::size_t>(distribution(random)), 100, 1 << 20));
+        }
+        return payloads;
+    }
+
+    /// A byte bounded queue like a first attempt would look like: a deque behind a mutex and two conditions.
+    class locked_queue {
+        std::mutex _mutex;
+        std::condition_variable _not_full;
+        std::condition_variable _not_empty;
+        std::deque<std::vector<char> > _items;
+        std::uint64_t _queued = 0;
+        std::uint64_t _capacity;
+
+    public:
+        explicit locked_queue(const bytes capacity) : _capacity(capacity.count()) {}
+
+        void push(std::vector<char> &&item) {
+            std::unique_lock lock(_mutex);
+            _not_full.wait(lock, [&] { return _capacity - _queued >= item.size(); });
+            _queued += item.size();
+            _items.push_back(std::move(item));
+            _not_empty.notify_one();
+        }
+
+        std::vector<char> pop() {
+            std::unique_lock lock(_mutex);
+            _not_empty.wait(lock, [&] { return not _items.empty(); });
+            auto item = std::move(_items.front());
+            _items.pop_front();
+            _queued -= item.size();
+            _not_full.notify_all();
+            return item;
+        }
+    };
+
+    /// Return a thread echoing the items popped from \a requests by \a pop back to \a replies.
+    template<typename Queue, typename Pop>
+    std::jthread echo(Queue &requests, Queue &replies, Pop pop) {
+        return std::jthread([&requests, &replies, pop](const std::stop_token &stop) {
+            while (not stop.stop_requested()) {
+                auto item = pop(requests);
+                if (item.empty()) {
+                    return;
+                }
+                replies.push(std::move(item));
+            }
+        });
+    }
+}
+
+// half of the threads produce, the other half consume
+static void BM_LockedQueueThroughput(benchmark::State& state) {
+    static locked_queue queue(bytes(16_mb));
+    auto payloads = mixed_payloads();
+    std::size_t next = 0;
+    std::uint64_t transferred = 0;
+    for (auto _ : state) {
+        if (state.thread_index() % 2 == 0) {
+            auto &payload = payloads[next++ % payloads.size()];
+            transferred += payload.size();
+            queue.push(std::vector<char>(std::move(payload)));
+        } else {
+            payloads[next++ % payloads.size()] = queue.pop();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<std::int64_t>(transferred));
+}
+BENCHMARK(BM_LockedQueueThroughput)->Threads(2)->Threads(8)->UseRealTime();
+
+static void BM_ByteBoundedQueueThroughput(benchmark::State& state) {
+    static byte_bounded_queue<std::vector<char> > queue(16_mb);
+    auto payloads = mixed_payloads();
+    std::size_t next = 0;
+    std::uint64_t transferred = 0;
+    for (auto _ : state) {
+        if (state.thread_index() % 2 == 0) {
+            auto &payload = payloads[next++ % payloads.size()];
+            transferred += payload.size();
+            queue.push(std::vector<char>(std::move(payload)));
+        } else {
+            payloads[next++ % payloads.size()] = *queue.pop();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<std::int64_t>(transferred));
+}
+BENCHMARK(BM_ByteBoundedQueueThroughput)->Threads(2)->Threads(8)->UseRealTime();
+
+// round trip of an item to a thread echoing it back
+static void BM_LockedQueueLatency(benchmark::State& state) {
+    locked_queue requests(bytes(16_mb));
+    locked_queue replies(bytes(16_mb));
+    auto echoing = echo(requests, replies, [](locked_queue &queue) { return queue.pop(); });
+    std::vector<char> payload(1'000);
+    for (auto _ : state) {
+        requests.push(std::move(payload));
+        payload = replies.pop();
+    }
+    requests.push({});
+}
+BENCHMARK(BM_LockedQueueLatency)->UseRealTime();
+
+static void BM_ByteBoundedQueueLatency(benchmark::State& state) {
+    byte_bounded_queue<std::vector<char> > requests(16_mb);
+    byte_bounded_queue<std::vector<char> > replies(16_mb);
+    auto echoing = echo(requests, replies, [](byte_bounded_queue<std::vector<char> > &queue) {
+        return queue.pop().value_or(std::vector<char>{});
+    });
+    std::vector<char> payload(1'000);
+    for (auto _ : state) {
+        requests.push(std::move(payload));
+        payload = *replies.pop();
+    }
+    requests.close();
+}
+BENCHMARK(BM_ByteBoundedQueueLatency)->UseRealTime();
@@ -0,0 +1,96 @@
+#include "mem_units/checked.hpp"
+#include <benchmark/benchmark.h>
+
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace afs::mem_units;
+
+namespace {
+    constexpr std::size_t sample_count = 4'096;
+
+    /// Counts of which \a overflow_percent percent overflow when added to themselves or converted to bits.
+    std::vector<bytes> make_units(const std::int64_t overflow_percent) {
+        std::mt19937_64 random(42);
+        std::uniform_int_distribution<std::int64_t> percent(0, 99);
+        std::vector<bytes> units;
+        units.reserve(sample_count);
+        for (std::size_t index = 0; index < sample_count; ++index) {
+            units.emplace_back(percent(random) < overflow_percent ? std::numeric_limits<std::uint64_t>::max() - index
+                                                                  : index);
+        }
+        return units;
+    }
+}
+
+static void BM_ThrowingAdd(benchmark::State& state) {
+    const auto units = make_units(state.range(0));
+    std::size_t failures = 0;
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            try {
+                benchmark::DoNotOptimize(unit + unit);
+            } catch (const std::overflow_error &) {
+                ++failures;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(failures);
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_ThrowingAdd)->Arg(0)->Arg(1)->Arg(50);
+
+static void BM_CheckedAdd(benchmark::State& state) {
+    const auto units = make_units(state.range(0));
+    std::size_t failures = 0;
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            const auto sum = checked_add(unit, unit);
+            if (sum) {
+                benchmark::DoNotOptimize(*sum);
+            } else {
+                ++failures;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(failures);
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_CheckedAdd)->Arg(0)->Arg(1)->Arg(50);
+
+static void BM_ThrowingCast(benchmark::State& state) {
+    const auto units = make_units(state.range(0));
+    std::size_t failures = 0;
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            try {
+                benchmark::DoNotOptimize(memory_unit_cast<bits>(unit));
+            } catch (const std::overflow_error &) {
+                ++failures;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(failures);
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_ThrowingCast)->Arg(0)->Arg(1)->Arg(50);
+
+static void BM_CheckedCast(benchmark::State& state) {
+    const auto units = make_units(state.range(0));
+    std::size_t failures = 0;
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            const auto converted = checked_cast<bits>(unit);
+            if (converted) {
+                benchmark::DoNotOptimize(*converted);
+            } else {
+                ++failures;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(failures);
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_CheckedCast)->Arg(0)->Arg(1)->Arg(50);
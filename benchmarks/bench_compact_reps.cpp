@@ -0,0 +1,46 @@
+#include "mem_units/memory_accumulator.hpp"
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    /// Table of block sizes between 4kb and 32mb, like a per-block size table of an allocator.
+    template<MemoryUnitType MemoryUnit>
+    std::vector<MemoryUnit> block_table(const std::size_t size) {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<std::uint32_t> kilobytes_per_block(4, 32'768);
+        std::vector<MemoryUnit> table;
+        table.reserve(size);
+        for (std::size_t index = 0; index < size; ++index) {
+            table.emplace_back(memory_unit_cast<MemoryUnit>(kilobytes(kilobytes_per_block(random))));
+        }
+        return table;
+    }
+
+    /// Sums up the table and counts the blocks greater than 1mb, i.e. scans every entry once.
+    template<MemoryUnitType MemoryUnit>
+    void BM_ScanBlockTable(benchmark::State& state) {
+        const auto table = block_table<MemoryUnit>(state.range(0));
+        const auto threshold = memory_unit_cast<MemoryUnit>(1_mb);
+        for (auto _ : state) {
+            memory_accumulator<kilobytes> total;
+            std::size_t large_blocks = 0;
+            for (const auto &size : table) {
+                total += size;
+                large_blocks += threshold.count() < size.count();
+            }
+            benchmark::DoNotOptimize(total.result());
+            benchmark::DoNotOptimize(large_blocks);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(MemoryUnit));
+    }
+}
+
+BENCHMARK(BM_ScanBlockTable<kilobytes>)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_ScanBlockTable<kilobytes32>)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_ScanBlockTable<kilobytes16>)->Range(1 << 12, 1 << 24);
@@ -0,0 +1,96 @@
+#include "mem_units.hpp"
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <variant>
+#include <vector>
+
+using namespace afs::mem_units;
+
+namespace {
+    using any_unit = std::variant<bits, bytes, kilobytes, megabytes>;
+
+    std::vector<std::uint64_t> random_counts(const std::size_t size) {
+        std::mt19937_64 random(size);
+        std::vector<std::uint64_t> counts(size);
+        std::ranges::generate(counts, [&] { return random() >> 24; });
+        return counts;
+    }
+
+    std::vector<any_unit> random_mixed_units(const std::size_t size) {
+        std::mt19937_64 random(size);
+        std::vector<any_unit> units;
+        units.reserve(size);
+        for (std::size_t index = 0; index < size; ++index) {
+            const std::uint64_t count = random() >> 24;
+            switch (index % 4) {
+                case 0: units.emplace_back(bits(count)); break;
+                case 1: units.emplace_back(bytes(count)); break;
+                case 2: units.emplace_back(kilobytes(count)); break;
+                default: units.emplace_back(megabytes(count)); break;
+            }
+        }
+        return units;
+    }
+}
+
+static void BM_SortRawCounts(benchmark::State& state) {
+    const auto counts = random_counts(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sorted = counts;
+        state.ResumeTiming();
+        std::ranges::sort(sorted);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortRawCounts)->Range(1 << 10, 1 << 20);
+
+static void BM_SortBytes(benchmark::State& state) {
+    std::vector<bytes> units;
+    std::ranges::transform(random_counts(state.range(0)), std::back_inserter(units),
+                           [](const std::uint64_t count) { return bytes(count); });
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sorted = units;
+        state.ResumeTiming();
+        std::ranges::sort(sorted);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortBytes)->Range(1 << 10, 1 << 20);
+
+static void BM_SortMixedUnitsExact(benchmark::State& state) {
+    const auto units = random_mixed_units(state.range(0));
+    const auto less = [](const any_unit &lhs, const any_unit &rhs) {
+        return std::visit([](const auto &l, const auto &r) { return l < r; }, lhs, rhs);
+    };
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sorted = units;
+        state.ResumeTiming();
+        std::ranges::sort(sorted, less);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortMixedUnitsExact)->Range(1 << 10, 1 << 20);
+
+static void BM_SortMixedUnitsByCast(benchmark::State& state) {
+    const auto units = random_mixed_units(state.range(0));
+    const auto in_bits = [](const any_unit &unit) {
+        return std::visit([](const auto &u) { return memory_unit_cast<bits>(u).count(); }, unit);
+    };
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sorted = units;
+        state.ResumeTiming();
+        std::ranges::sort(sorted, {}, in_bits);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortMixedUnitsByCast)->Range(1 << 10, 1 << 20);
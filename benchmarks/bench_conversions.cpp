@@ -0,0 +1,107 @@
+#include "mem_units.hpp"
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <vector>
+
+using namespace afs::mem_units;
+
+namespace {
+    constexpr std::size_t sample_count = 4'096;
+
+    std::vector<std::uint64_t> make_counts() {
+        std::vector<std::uint64_t> counts(sample_count);
+        std::iota(counts.begin(), counts.end(), std::uint64_t{1});
+        return counts;
+    }
+
+    template<MemoryUnitType MemoryUnit>
+    std::vector<MemoryUnit> make_units() {
+        std::vector<MemoryUnit> units;
+        units.reserve(sample_count);
+        for (const auto count : make_counts()) {
+            units.emplace_back(count);
+        }
+        return units;
+    }
+}
+
+static void BM_HandWrittenShiftLeft(benchmark::State& state) {
+    const auto counts = make_counts();
+    for (auto _ : state) {
+        for (const auto count : counts) {
+            benchmark::DoNotOptimize(count << 10);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_HandWrittenShiftLeft);
+
+static void BM_HandWrittenCheckedShiftLeft(benchmark::State& state) {
+    const auto counts = make_counts();
+    for (auto _ : state) {
+        for (const auto count : counts) {
+            if (count > (std::numeric_limits<std::uint64_t>::max() >> 10)) {
+                throw std::overflow_error("Conversion would cause an overflow!");
+            }
+            benchmark::DoNotOptimize(count << 10);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_HandWrittenCheckedShiftLeft);
+
+static void BM_CastKilobytesToBytes(benchmark::State& state) {
+    const auto units = make_units<kilobytes>();
+    for (auto _ : state) {
+        for (const auto& unit : units) {
+            benchmark::DoNotOptimize(memory_unit_cast<bytes>(unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_CastKilobytesToBytes);
+
+static void BM_UncheckedCastKilobytesToBytes(benchmark::State& state) {
+    const auto units = make_units<unchecked_kilobytes>();
+    for (auto _ : state) {
+        for (const auto& unit : units) {
+            benchmark::DoNotOptimize(memory_unit_cast<unchecked_bytes>(unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_UncheckedCastKilobytesToBytes);
+
+static void BM_HandWrittenShiftRight(benchmark::State& state) {
+    const auto counts = make_counts();
+    for (auto _ : state) {
+        for (const auto count : counts) {
+            benchmark::DoNotOptimize(count >> 20);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_HandWrittenShiftRight);
+
+static void BM_CastBytesToMegabytes(benchmark::State& state) {
+    const auto units = make_units<bytes>();
+    for (auto _ : state) {
+        for (const auto& unit : units) {
+            benchmark::DoNotOptimize(memory_unit_cast<megabytes>(unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_CastBytesToMegabytes);
+
+static void BM_CastBitsToBytes(benchmark::State& state) {
+    const auto units = make_units<bits>();
+    for (auto _ : state) {
+        for (const auto& unit : units) {
+            benchmark::DoNotOptimize(memory_unit_cast<bytes>(unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_CastBitsToBytes);
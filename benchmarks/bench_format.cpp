@@ -0,0 +1,100 @@
+#include "mem_units/format.hpp"
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+using namespace afs::mem_units;
+
+namespace {
+    constexpr std::size_t sample_count = 1'024;
+
+    template<MemoryUnitType MemoryUnit>
+    std::vector<MemoryUnit> make_units() {
+        std::vector<MemoryUnit> units;
+        units.reserve(sample_count);
+        for (std::uint64_t count = 1; count <= sample_count; ++count) {
+            units.emplace_back(count * 7'919);
+        }
+        return units;
+    }
+
+    /// The formatter before it wrote directly to the format context, building a string first.
+    std::string legacy_format(const bits &value) {
+        return std::format("{}{}", value.count(), memory_unit_suffix<bits>());
+    }
+}
+
+static void BM_LegacyFormatBits(benchmark::State& state) {
+    const auto units = make_units<bits>();
+    std::array<char, 64> buffer{};
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            const auto formatted = legacy_format(unit);
+            benchmark::DoNotOptimize(std::ranges::copy(formatted, buffer.data()).out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_LegacyFormatBits);
+
+static void BM_FormatRawCountWithSuffix(benchmark::State& state) {
+    const auto units = make_units<bits>();
+    std::array<char, 64> buffer{};
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            benchmark::DoNotOptimize(std::format_to(buffer.data(), "{}bit", unit.count()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_FormatRawCountWithSuffix);
+
+static void BM_FormatBits(benchmark::State& state) {
+    const auto units = make_units<bits>();
+    std::array<char, 64> buffer{};
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            benchmark::DoNotOptimize(std::format_to(buffer.data(), "{}", unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_FormatBits);
+
+static void BM_FormatScaledBytes(benchmark::State& state) {
+    const auto units = make_units<bytes>();
+    std::array<char, 64> buffer{};
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            benchmark::DoNotOptimize(std::format_to(buffer.data(), "{:h}", unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_FormatScaledBytes);
+
+static void BM_FormatScaledBytesWithPrecision(benchmark::State& state) {
+    const auto units = make_units<bytes>();
+    std::array<char, 64> buffer{};
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            benchmark::DoNotOptimize(std::format_to(buffer.data(), "{:.2h}", unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_FormatScaledBytesWithPrecision);
+
+static void BM_FormatKilobytesAsMegabytes(benchmark::State& state) {
+    const auto units = make_units<kilobytes>();
+    std::array<char, 64> buffer{};
+    for (auto _ : state) {
+        for (const auto &unit : units) {
+            benchmark::DoNotOptimize(std::format_to(buffer.data(), "{:.1mb}", unit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sample_count);
+}
+BENCHMARK(BM_FormatKilobytesAsMegabytes);
@@ -0,0 +1,72 @@
+#include "mem_units/memory_accumulator.hpp"
+#include <benchmark/benchmark.h>
+
+#include <execution>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace afs::mem_units;
+
+namespace {
+    std::vector<bytes> heap_dump(const std::size_t size) {
+        std::mt19937_64 random(size);
+        std::vector<bytes> sizes;
+        sizes.reserve(size);
+        for (std::size_t index = 0; index < size; ++index) {
+            sizes.emplace_back(random() >> 24);
+        }
+        return sizes;
+    }
+}
+
+static void BM_CheckedAddition(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        bytes total{};
+        for (const auto size : sizes) {
+            total += size;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CheckedAddition)->Range(1 << 10, 1 << 22);
+
+static void BM_Accumulator(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        memory_accumulator<bytes> total;
+        for (const auto size : sizes) {
+            total += size;
+        }
+        benchmark::DoNotOptimize(total.result());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Accumulator)->Range(1 << 10, 1 << 22);
+
+static void BM_AccumulatorMixedRatios(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        memory_accumulator<kilobytes> total;
+        for (const auto size : sizes) {
+            total += size;
+            total += bits(size.count());
+        }
+        benchmark::DoNotOptimize(total.result());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_AccumulatorMixedRatios)->Range(1 << 10, 1 << 22);
+
+static void BM_AccumulatorParallelReduce(benchmark::State& state) {
+    const auto sizes = heap_dump(state.range(0));
+    for (auto _ : state) {
+        const auto total = std::reduce(std::execution::par, sizes.begin(), sizes.end(), memory_accumulator<bytes>{},
+                                       memory_accumulator<bytes>::plus{});
+        benchmark::DoNotOptimize(total.result());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AccumulatorParallelReduce)->Range(1 << 10, 1 << 22)->UseRealTime();
@@ -0,0 +1,53 @@
+#include "mem_units/memory_budget.hpp"
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    const int max_threads = static_cast<int>(std::max(2u, 2 * std::thread::hardware_concurrency()));
+
+    memory_budget process{64_gb};
+    memory_budget tenant{16_gb, process};
+    memory_budget subsystem{4_gb, tenant};
+    memory_budget exhausted{0_b};
+}
+
+static void BM_TryReserveAndReleaseRoot(benchmark::State& state) {
+    for (auto _ : state) {
+        if (process.try_reserve(64_kb)) {
+            process.release(64_kb);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TryReserveAndReleaseRoot)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_TryReserveAndReleaseThreeLevels(benchmark::State& state) {
+    for (auto _ : state) {
+        if (subsystem.try_reserve(64_kb)) {
+            subsystem.release(64_kb);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TryReserveAndReleaseThreeLevels)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_ReservationHandleThreeLevels(benchmark::State& state) {
+    for (auto _ : state) {
+        auto reservation = subsystem.reserve(64_kb);
+        benchmark::DoNotOptimize(reservation);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReservationHandleThreeLevels)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_TryReserveRejected(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(exhausted.try_reserve(1_b));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TryReserveRejected)->ThreadRange(1, max_threads)->UseRealTime();
@@ -0,0 +1,99 @@
+#include "mem_units/memory_pressure_watcher.hpp"
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+using namespace std::chrono_literals;
+
+namespace {
+    /// Stand-in for `/proc` and a cgroup in a temporary directory.
+    struct fake_roots {
+        std::filesystem::path root = std::filesystem::temp_directory_path() / "mem_units_watcher_bench";
+
+        fake_roots() {
+            std::filesystem::create_directories(root / "proc/self");
+            std::filesystem::create_directories(root / "cgroup/bench.service");
+            write("proc/meminfo", "MemTotal:       16384000 kB\n");
+            write("proc/self/status", "VmHWM:\t    4096 kB\nVmRSS:\t    3072 kB\n");
+            write("proc/self/cgroup", "0::/bench.service\n");
+            write("cgroup/bench.service/memory.current", "67108864\n");
+            write_events(0);
+        }
+
+        ~fake_roots() {
+            std::filesystem::remove_all(root);
+        }
+
+        void write(const std::filesystem::path &file, const std::string_view content) const {
+            std::ofstream stream(root / file, std::ios::trunc);
+            stream << content;
+        }
+
+        void write_events(const std::uint64_t high) const {
+            write("cgroup/bench.service/memory.events",
+                  "low 0\nhigh " + std::to_string(high) + "\nmax 0\noom 0\noom_kill 0\n");
+        }
+    };
+
+    void wait_for(const std::atomic<std::uint64_t> &value, const std::uint64_t expected) {
+        for (auto current = value.load(); current != expected; current = value.load()) {
+            value.wait(current);
+        }
+    }
+}
+
+static void BM_PolledEventLatency(benchmark::State& state) {
+    const fake_roots roots;
+    std::atomic<std::uint64_t> seen = 0;
+    std::jthread poller([&roots, &seen](const std::stop_token &stop) {
+        const file_descriptor events((roots.root / "cgroup/bench.service/memory.events").string());
+        std::array<char, 4'096> buffer;
+        while (not stop.stop_requested()) {
+            const auto text = events.read(buffer);
+            std::uint64_t high = 0;
+            const auto position = text.find("high ");
+            if (position != std::string_view::npos) {
+                std::from_chars(text.data() + position + 5, text.data() + text.size(), high);
+            }
+            if (high != 0 && high != seen.load()) {
+                seen.store(high);
+                seen.notify_all();
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+    std::uint64_t high = 0;
+    for (auto _ : state) {
+        roots.write_events(++high);
+        wait_for(seen, high);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PolledEventLatency)->UseRealTime();
+
+static void BM_WatchedEventLatency(benchmark::State& state) {
+    const fake_roots roots;
+    std::atomic<std::uint64_t> seen = 0;
+    memory_pressure_watcher watcher(100ms, (roots.root / "proc").string(), (roots.root / "cgroup").string());
+    watcher.on_memory_events([&seen](const memory_events &events) {
+        seen.store(events.high);
+        seen.notify_all();
+    });
+    watcher.start();
+    std::uint64_t high = 0;
+    for (auto _ : state) {
+        roots.write_events(++high);
+        wait_for(seen, high);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WatchedEventLatency)->UseRealTime();
+
+#endif
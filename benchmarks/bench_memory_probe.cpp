@@ -0,0 +1,56 @@
+#include "mem_units/memory_probe.hpp"
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    /// Read a `Key: value kB` field the usual way, opening the file and allocating a line per call.
+    kilobytes read_field(const char *path, const std::string &key) {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.starts_with(key)) {
+                std::istringstream stream(line.substr(key.size()));
+                kilobytes::rep count = 0;
+                stream >> count;
+                return kilobytes{count};
+            }
+        }
+        return kilobytes{};
+    }
+}
+
+static void BM_IfstreamSample(benchmark::State& state) {
+    for (auto _ : state) {
+        memory_snapshot snapshot;
+        snapshot.total = read_field("/proc/meminfo", "MemTotal:");
+        snapshot.free = read_field("/proc/meminfo", "MemFree:");
+        snapshot.available = read_field("/proc/meminfo", "MemAvailable:");
+        snapshot.cached = read_field("/proc/meminfo", "Cached:");
+        snapshot.swap_total = read_field("/proc/meminfo", "SwapTotal:");
+        snapshot.swap_free = read_field("/proc/meminfo", "SwapFree:");
+        snapshot.rss = read_field("/proc/self/status", "VmRSS:");
+        snapshot.peak_rss = read_field("/proc/self/status", "VmHWM:");
+        benchmark::DoNotOptimize(snapshot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IfstreamSample);
+
+static void BM_MemoryProbeSample(benchmark::State& state) {
+    memory_probe probe;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(probe.sample());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryProbeSample);
+
+#endif
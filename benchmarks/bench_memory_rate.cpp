@@ -0,0 +1,71 @@
+#include "mem_units/memory_rate.hpp"
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <mutex>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+using namespace std::chrono_literals;
+
+namespace {
+    /// A meter like a first attempt would look like: timestamped chunks in a queue behind a mutex.
+    class locked_meter {
+        std::mutex _mutex;
+        std::deque<std::pair<std::chrono::steady_clock::time_point, std::uint64_t> > _chunks;
+        std::uint64_t _windowed = 0;
+
+    public:
+        void record(const bytes amount) {
+            const auto now = std::chrono::steady_clock::now();
+            const std::scoped_lock lock(_mutex);
+            _chunks.emplace_back(now, amount.count());
+            _windowed += amount.count();
+            while (now - _chunks.front().first > 10s) {
+                _windowed -= _chunks.front().second;
+                _chunks.pop_front();
+            }
+        }
+    };
+}
+
+static void BM_LockedMeterRecord(benchmark::State& state) {
+    static locked_meter meter;
+    for (auto _ : state) {
+        meter.record(bytes(64_kb));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedMeterRecord)->Threads(1)->Threads(4);
+
+static void BM_ThroughputMeterRecord(benchmark::State& state) {
+    static throughput_meter meter;
+    for (auto _ : state) {
+        meter.record(64_kb);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThroughputMeterRecord)->Threads(1)->Threads(4);
+
+static void BM_ThroughputMeterUpdate(benchmark::State& state) {
+    throughput_meter meter;
+    auto now = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        meter.record(64_kb);
+        now += 100ms;
+        meter.update(now);
+    }
+    benchmark::DoNotOptimize(meter.window_rate());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThroughputMeterUpdate);
+
+static void BM_RateConversion(benchmark::State& state) {
+    auto rate = memory_rate<bytes, std::milli>(512_b);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rate);
+        benchmark::DoNotOptimize(memory_rate_cast<kilobytes_per_second>(rate) * 1min);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RateConversion);
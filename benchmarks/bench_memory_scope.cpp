@@ -0,0 +1,76 @@
+#include "mem_units/memory_scope.hpp"
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    /// A scope tracer like a first attempt would look like: records appended to one vector behind a mutex.
+    class locked_scope {
+        static inline std::mutex _mutex;
+        static inline std::vector<memory_scope_record> _records;
+
+        memory_scope_record _record;
+        allocation_counts _counts_begin = this_thread_allocation_counts();
+
+    public:
+        explicit locked_scope(const char *name) {
+            _record.name = name;
+            _record.begin = std::chrono::steady_clock::now();
+        }
+
+        ~locked_scope() {
+            _record.duration = std::chrono::steady_clock::now() - _record.begin;
+            _record.allocated = this_thread_allocation_counts().allocated - _counts_begin.allocated;
+            const std::scoped_lock lock(_mutex);
+            _records.push_back(_record);
+            if (_records.size() == memory_trace_ring::capacity) {
+                _records.clear();
+            }
+        }
+    };
+}
+
+static void BM_LockedScope(benchmark::State& state) {
+    for (auto _ : state) {
+        const locked_scope scope("locked");
+        count_allocation(64_b);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedScope)->Threads(1)->Threads(4)->UseRealTime();
+
+// includes draining, which keeps the ring from filling up and only measuring dropped records
+static void BM_MemoryScope(benchmark::State& state) {
+    std::size_t scopes = 0;
+    for (auto _ : state) {
+        {
+            const memory_scope scope("traced");
+            count_allocation(64_b);
+        }
+        if (++scopes % 1'024 == 0) {
+            (void)memory_tracer::instance().drain([](const memory_scope_record &) {});
+        }
+    }
+    (void)memory_tracer::instance().drain([](const memory_scope_record &) {});
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryScope)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_MemoryScopeWithRss(benchmark::State& state) {
+    std::size_t scopes = 0;
+    for (auto _ : state) {
+        {
+            const memory_scope scope("traced", rss_sampling::on);
+        }
+        if (++scopes % 1'024 == 0) {
+            (void)memory_tracer::instance().drain([](const memory_scope_record &) {});
+        }
+    }
+    (void)memory_tracer::instance().drain([](const memory_scope_record &) {});
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryScopeWithRss);
@@ -0,0 +1,64 @@
+#include "mem_units/parse.hpp"
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string_view>
+
+using namespace afs::mem_units;
+
+namespace {
+    constexpr std::array<std::string_view, 8> samples{
+        "4096", "512k", "1.5GiB", "64 MB", "16bit", "3.25 tb", "128KiB", "0.5mb",
+    };
+
+    std::uint64_t naive_parse_bytes(const std::string_view text) {
+        std::uint64_t count = 0;
+        auto it = text.begin();
+        for (; it != text.end() && *it >= '0' && *it <= '9'; ++it) {
+            count = count * 10 + static_cast<std::uint64_t>(*it - '0');
+        }
+        return count;
+    }
+}
+
+static void BM_NaiveIntegerParse(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto sample : samples) {
+            benchmark::DoNotOptimize(naive_parse_bytes(sample));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_NaiveIntegerParse);
+
+static void BM_FromCharsBytes(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto sample : samples) {
+            bytes value{};
+            benchmark::DoNotOptimize(from_chars(sample.data(), sample.data() + sample.size(), value));
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_FromCharsBytes);
+
+static void BM_ParseMemoryUnitBits(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto sample : samples) {
+            benchmark::DoNotOptimize(parse_memory_unit<bits>(sample));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_ParseMemoryUnitBits);
+
+static void BM_ParseMemoryUnitKilobytes(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto sample : samples) {
+            benchmark::DoNotOptimize(parse_memory_unit<kilobytes>(sample));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_ParseMemoryUnitKilobytes);
@@ -0,0 +1,137 @@
+#include "mem_units/sample_codec.hpp"
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    constexpr std::size_t sample_count = 65'536;
+
+    /// The resident set size of a process sampled every second, a random walk of a few kilobytes.
+    std::vector<kilobytes> resident_set_sizes() {
+        std::mt19937_64 random(42);
+        std::normal_distribution<double> change(0.0, 64.0);
+        std::vector<kilobytes> samples;
+        std::int64_t current = 4 << 20;
+        for (std::size_t index = 0; index < sample_count; ++index) {
+            current = std::max<std::int64_t>(0, current + static_cast<std::int64_t>(change(random)));
+            samples.emplace_back(static_cast<std::uint64_t>(current));
+        }
+        return samples;
+    }
+
+    /// Sizes of independent allocations, from a few bytes to megabytes.
+    std::vector<bytes> allocation_sizes() {
+        std::mt19937_64 random(42);
+        std::lognormal_distribution<double> size(6.0, 2.5);
+        std::vector<bytes> samples;
+        for (std::size_t index = 0; index < sample_count; ++index) {
+            samples.emplace_back(static_cast<std::uint64_t>(size(random)));
+        }
+        return samples;
+    }
+
+    /// Encoding like a first attempt would look like: a varint per sample, written byte by byte.
+    template<SampleMemoryUnitType MemoryUnit>
+    void encode_bytewise(const std::span<const MemoryUnit> samples, std::vector<std::byte> &out) {
+        std::uint64_t previous = 0;
+        for (const auto &sample : samples) {
+            const auto delta = sample.count() - previous;
+            auto code = (delta << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(delta) >> 63);
+            previous = sample.count();
+            while (code >= 0x80) {
+                out.push_back(static_cast<std::byte>(code | 0x80));
+                code >>= 7;
+            }
+            out.push_back(static_cast<std::byte>(code));
+        }
+    }
+
+    template<SampleMemoryUnitType MemoryUnit>
+    void decode_bytewise(const std::span<const std::byte> in, std::vector<MemoryUnit> &out) {
+        std::uint64_t previous = 0;
+        std::uint64_t code = 0;
+        int shift = 0;
+        for (const auto byte : in) {
+            code |= (std::to_integer<std::uint64_t>(byte) & 0x7F) << shift;
+            shift += 7;
+            if ((byte & std::byte{0x80}) == std::byte{0}) {
+                previous += (code >> 1) ^ (0 - (code & 1));
+                out.emplace_back(previous);
+                code = 0;
+                shift = 0;
+            }
+        }
+    }
+
+    template<SampleMemoryUnitType MemoryUnit>
+    void report(benchmark::State &state, const std::vector<MemoryUnit> &samples, const std::size_t encoded_size) {
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(samples.size()));
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(samples.size() * sizeof(MemoryUnit)));
+        state.counters["compression_ratio"] = static_cast<double>(samples.size() * sizeof(MemoryUnit))
+                                              / static_cast<double>(encoded_size);
+    }
+
+    template<auto make_samples>
+    void BM_EncodeBytewise(benchmark::State& state) {
+        const auto samples = make_samples();
+        std::vector<std::byte> encoded;
+        for (auto _ : state) {
+            encoded.clear();
+            encode_bytewise(std::span(samples), encoded);
+            benchmark::DoNotOptimize(encoded.data());
+        }
+        report(state, samples, encoded.size());
+    }
+
+    template<auto make_samples>
+    void BM_DecodeBytewise(benchmark::State& state) {
+        const auto samples = make_samples();
+        std::vector<std::byte> encoded;
+        encode_bytewise(std::span(samples), encoded);
+        std::vector<typename decltype(samples)::value_type> decoded;
+        decoded.reserve(samples.size());
+        for (auto _ : state) {
+            decoded.clear();
+            decode_bytewise(std::span<const std::byte>(encoded), decoded);
+            benchmark::DoNotOptimize(decoded.data());
+        }
+        report(state, samples, encoded.size());
+    }
+
+    template<auto make_samples>
+    void BM_EncodeSamples(benchmark::State& state) {
+        const auto samples = make_samples();
+        std::vector<std::byte> buffer(max_encoded_size(samples.size()));
+        std::size_t encoded_size = 0;
+        for (auto _ : state) {
+            encoded_size = encode_samples(std::span(samples), std::span(buffer)).size();
+            benchmark::DoNotOptimize(buffer.data());
+        }
+        report(state, samples, encoded_size);
+    }
+
+    template<auto make_samples>
+    void BM_DecodeSamples(benchmark::State& state) {
+        const auto samples = make_samples();
+        std::vector<std::byte> encoded;
+        encode_samples(std::span(samples), encoded);
+        std::vector<typename decltype(samples)::value_type> decoded(samples.size());
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(decode_samples(std::span<const std::byte>(encoded), std::span(decoded)));
+        }
+        report(state, samples, encoded.size());
+    }
+}
+
+BENCHMARK(BM_EncodeBytewise<resident_set_sizes>);
+BENCHMARK(BM_EncodeSamples<resident_set_sizes>);
+BENCHMARK(BM_DecodeBytewise<resident_set_sizes>);
+BENCHMARK(BM_DecodeSamples<resident_set_sizes>);
+BENCHMARK(BM_EncodeBytewise<allocation_sizes>);
+BENCHMARK(BM_EncodeSamples<allocation_sizes>);
+BENCHMARK(BM_DecodeBytewise<allocation_sizes>);
+BENCHMARK(BM_DecodeSamples<allocation_sizes>);
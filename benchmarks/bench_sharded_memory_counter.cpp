@@ -0,0 +1,67 @@
+#include "mem_units/atomic_memory_unit.hpp"
+#include "mem_units/sharded_memory_counter.hpp"
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    const int max_threads = static_cast<int>(std::max(2u, 2 * std::thread::hardware_concurrency()));
+
+    alignas(cache_line_size) std::atomic<std::uint64_t> raw_counter{0};
+    atomic_memory_unit<bytes> atomic_counter;
+    atomic_memory_unit<unchecked_bytes> unchecked_atomic_counter;
+    sharded_memory_counter<bytes> sharded_counter;
+}
+
+static void BM_RawAtomicAddSub(benchmark::State& state) {
+    for (auto _ : state) {
+        raw_counter.fetch_add(64, std::memory_order_relaxed);
+        raw_counter.fetch_sub(64, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_RawAtomicAddSub)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_AtomicMemoryUnitAddSub(benchmark::State& state) {
+    for (auto _ : state) {
+        atomic_counter.fetch_add(64_b, std::memory_order_relaxed);
+        atomic_counter.fetch_sub(64_b, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_AtomicMemoryUnitAddSub)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_UncheckedAtomicMemoryUnitAddSub(benchmark::State& state) {
+    for (auto _ : state) {
+        unchecked_atomic_counter.fetch_add(unchecked_bytes(64), std::memory_order_relaxed);
+        unchecked_atomic_counter.fetch_sub(unchecked_bytes(64), std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_UncheckedAtomicMemoryUnitAddSub)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_ShardedMemoryCounterAddSub(benchmark::State& state) {
+    for (auto _ : state) {
+        sharded_counter.add(64_b);
+        sharded_counter.sub(64_b);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_ShardedMemoryCounterAddSub)->ThreadRange(1, max_threads)->UseRealTime();
+
+static void BM_ShardedMemoryCounterRead(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sharded_counter.read());
+    }
+}
+BENCHMARK(BM_ShardedMemoryCounterRead);
+
+static void BM_ShardedMemoryCounterSnapshot(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sharded_counter.snapshot());
+    }
+}
+BENCHMARK(BM_ShardedMemoryCounterSnapshot);
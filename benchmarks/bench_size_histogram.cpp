@@ -0,0 +1,70 @@
+#include "mem_units/size_histogram.hpp"
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    std::vector<bytes> allocation_sizes() {
+        std::mt19937_64 random(42);
+        std::geometric_distribution<std::uint64_t> distribution(0.01);
+        std::vector<bytes> sizes(4'096);
+        for (auto &size : sizes) {
+            size = bytes{distribution(random) + 1};
+        }
+        return sizes;
+    }
+}
+
+static void BM_RawCounter(benchmark::State& state) {
+    const auto sizes = allocation_sizes();
+    std::uint64_t total = 0;
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            total += size.count();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_RawCounter);
+
+static void BM_SharedAtomicHistogram(benchmark::State& state) {
+    static std::array<std::atomic<std::uint64_t>, 65> counts{};
+    const auto sizes = allocation_sizes();
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            counts[std::bit_width(size.count())].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_SharedAtomicHistogram)->Threads(1)->Threads(4);
+
+template<std::size_t SubBucketBits>
+static void BM_SizeHistogramRecord(benchmark::State& state) {
+    static size_histogram<SubBucketBits> histogram(16);
+    const auto sizes = allocation_sizes();
+    for (auto _ : state) {
+        for (const auto size : sizes) {
+            histogram.record(size);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_SizeHistogramRecord<0>)->Threads(1)->Threads(4);
+BENCHMARK(BM_SizeHistogramRecord<4>)->Threads(1)->Threads(4);
+
+static void BM_SizeHistogramPercentile(benchmark::State& state) {
+    size_histogram<4> histogram;
+    for (const auto size : allocation_sizes()) {
+        histogram.record(size);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(histogram.snapshot().percentile(0.99));
+    }
+}
+BENCHMARK(BM_SizeHistogramPercentile);
@@ -0,0 +1,91 @@
+#include "mem_units/tracking_memory_resource.hpp"
+#include <benchmark/benchmark.h>
+
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    void allocate_and_deallocate(benchmark::State& state, std::pmr::memory_resource &resource) {
+        for (auto _ : state) {
+            void *block = resource.allocate(64);
+            benchmark::DoNotOptimize(block);
+            resource.deallocate(block, 64);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void fill_vectors(benchmark::State& state, std::pmr::memory_resource &resource) {
+        for (auto _ : state) {
+            std::pmr::vector<std::pmr::vector<int>> vectors(&resource);
+            for (int outer = 0; outer < 256; ++outer) {
+                auto &inner = vectors.emplace_back();
+                for (int value = 0; value < 64; ++value) {
+                    inner.push_back(value);
+                }
+            }
+            benchmark::DoNotOptimize(vectors.data());
+        }
+        state.SetItemsProcessed(state.iterations() * 256 * 64);
+    }
+
+    void fill_map(benchmark::State& state, std::pmr::memory_resource &resource) {
+        for (auto _ : state) {
+            std::pmr::unordered_map<int, int> map(&resource);
+            for (int key = 0; key < 4'096; ++key) {
+                map.emplace(key, key);
+            }
+            benchmark::DoNotOptimize(map.size());
+        }
+        state.SetItemsProcessed(state.iterations() * 4'096);
+    }
+}
+
+static void BM_PoolAllocate(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource pool;
+    allocate_and_deallocate(state, pool);
+}
+BENCHMARK(BM_PoolAllocate);
+
+static void BM_TrackedPoolAllocate(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource pool;
+    tracking_memory_resource tracking(&pool);
+    allocate_and_deallocate(state, tracking);
+}
+BENCHMARK(BM_TrackedPoolAllocate);
+
+static void BM_TrackedPoolAllocateThreaded(benchmark::State& state) {
+    static std::pmr::synchronized_pool_resource pool;
+    static tracking_memory_resource tracking(&pool);
+    allocate_and_deallocate(state, tracking);
+}
+BENCHMARK(BM_TrackedPoolAllocateThreaded)->Threads(1)->Threads(4);
+
+static void BM_PmrVectors(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource pool;
+    fill_vectors(state, pool);
+}
+BENCHMARK(BM_PmrVectors);
+
+static void BM_TrackedPmrVectors(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource pool;
+    tracking_memory_resource tracking(&pool);
+    fill_vectors(state, tracking);
+}
+BENCHMARK(BM_TrackedPmrVectors);
+
+static void BM_PmrUnorderedMap(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource pool;
+    fill_map(state, pool);
+}
+BENCHMARK(BM_PmrUnorderedMap);
+
+static void BM_TrackedPmrUnorderedMap(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource pool;
+    tracking_memory_resource tracking(&pool);
+    fill_map(state, tracking);
+}
+BENCHMARK(BM_TrackedPmrUnorderedMap);
@@ -0,0 +1,105 @@
+#include "mem_units/weighted_cache.hpp"
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    constexpr std::uint64_t key_count = 100'000;
+
+    /// Keys drawn from a Zipf distribution with exponent 0.99 over \ref key_count keys, like the popularity
+    /// of objects in most caches.
+    std::vector<std::uint64_t> zipfian_keys(const std::uint64_t seed) {
+        std::vector<double> cumulative(key_count);
+        double sum = 0;
+        for (std::uint64_t rank = 0; rank < key_count; ++rank) {
+            sum += 1.0 / std::pow(static_cast<double>(rank + 1), 0.99);
+            cumulative[rank] = sum;
+        }
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> distribution(0, sum);
+        std::vector<std::uint64_t> keys(65'536);
+        for (auto &key : keys) {
+            key = static_cast<std::uint64_t>(std::ranges::lower_bound(cumulative, distribution(random)) - cumulative.begin());
+        }
+        return keys;
+    }
+
+    /// Entries weigh from 64 bytes to 256 kilobytes, depending on their key.
+    bytes weight_of(const std::uint64_t &key, const std::uint64_t &) {
+        return bytes{std::uint64_t{64} << (key * 0x9E37'79B9'7F4A'7C15 >> 60)};
+    }
+
+    /// A weighted LRU cache like a first attempt would look like: a list and a map behind one mutex.
+    class locked_lru_cache {
+        std::mutex _mutex;
+        std::list<std::pair<std::uint64_t, std::uint64_t> > _recency;
+        std::unordered_map<std::uint64_t, decltype(_recency)::iterator> _index;
+        std::uint64_t _resident = 0;
+        std::uint64_t _capacity;
+
+    public:
+        explicit locked_lru_cache(const bytes capacity) : _capacity(capacity.count()) {}
+
+        std::optional<std::uint64_t> get(const std::uint64_t key) {
+            const std::scoped_lock lock(_mutex);
+            const auto found = _index.find(key);
+            if (found == _index.end()) {
+                return std::nullopt;
+            }
+            _recency.splice(_recency.begin(), _recency, found->second);
+            return found->second->second;
+        }
+
+        void put(const std::uint64_t key, const std::uint64_t value) {
+            const std::scoped_lock lock(_mutex);
+            const auto weight = weight_of(key, value).count();
+            while (_resident + weight > _capacity && not _recency.empty()) {
+                const auto &[evicted, evicted_value] = _recency.back();
+                _resident -= weight_of(evicted, evicted_value).count();
+                _index.erase(evicted);
+                _recency.pop_back();
+            }
+            _recency.emplace_front(key, value);
+            _index.emplace(key, _recency.begin());
+            _resident += weight;
+        }
+    };
+
+    template<typename Cache>
+    void replay(benchmark::State &state, Cache &cache) {
+        const auto keys = zipfian_keys(static_cast<std::uint64_t>(state.thread_index()));
+        std::size_t next = 0;
+        std::uint64_t hits = 0;
+        for (auto _ : state) {
+            const auto key = keys[next++ % keys.size()];
+            if (cache.get(key)) {
+                ++hits;
+            } else {
+                cache.put(key, key);
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.counters["hit_ratio"] = benchmark::Counter(static_cast<double>(hits) / static_cast<double>(state.iterations()),
+                                                         benchmark::Counter::kAvgThreads);
+    }
+}
+
+static void BM_LockedLruCacheZipfian(benchmark::State& state) {
+    static locked_lru_cache cache(bytes(256_mb));
+    replay(state, cache);
+}
+BENCHMARK(BM_LockedLruCacheZipfian)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+static void BM_WeightedCacheZipfian(benchmark::State& state) {
+    static weighted_cache<std::uint64_t, std::uint64_t> cache(256_mb, weight_of);
+    replay(state, cache);
+}
+BENCHMARK(BM_WeightedCacheZipfian)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
@@ -0,0 +1,229 @@
+#include "mem_units/format.hpp"
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+// Every operation of memory_unit is measured next to the hand-written std::uint64_t code doing the same,
+// i.e. including the overflow checks of the default policy. The unchecked policy is compared to plain arithmetic.
+
+namespace {
+    constexpr std::size_t sample_count = 4'096;
+    constexpr std::uint64_t max_count = std::numeric_limits<std::uint64_t>::max();
+
+    std::vector<std::uint64_t> make_counts() {
+        std::vector<std::uint64_t> counts(sample_count);
+        std::uint64_t state = 88'172'645'463'325'252ULL;
+        for (auto &count : counts) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            count = state >> 24;
+        }
+        return counts;
+    }
+
+    template<typename T>
+    std::vector<T> make_values() {
+        std::vector<T> values;
+        values.reserve(sample_count);
+        for (const auto count : make_counts()) {
+            values.emplace_back(count);
+        }
+        return values;
+    }
+
+    template<typename T>
+    void run(benchmark::State &state, auto operation) {
+        const auto lhs = make_values<T>();
+        auto rhs = make_values<T>();
+        std::ranges::reverse(rhs);
+        for (auto _ : state) {
+            for (std::size_t index = 0; index < sample_count; ++index) {
+                benchmark::DoNotOptimize(operation(lhs[index], rhs[index]));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * sample_count);
+    }
+
+    std::uint64_t checked_add(const std::uint64_t lhs, const std::uint64_t rhs) {
+        if (max_count - lhs < rhs) {
+            throw std::overflow_error("Addition would cause an overflow!");
+        }
+        return lhs + rhs;
+    }
+
+    std::uint64_t checked_subtract(const std::uint64_t lhs, const std::uint64_t rhs) {
+        if (lhs < rhs) {
+            throw std::underflow_error("Subtraction would cause an underflow!");
+        }
+        return lhs - rhs;
+    }
+
+    std::uint64_t checked_shift(const std::uint64_t count, const int shift) {
+        if (count > (max_count >> shift)) {
+            throw std::overflow_error("Conversion would cause an overflow!");
+        }
+        return count << shift;
+    }
+}
+
+static void BM_Raw_AddSameRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) { return checked_add(lhs, rhs); });
+}
+BENCHMARK(BM_Raw_AddSameRatio);
+
+static void BM_Unit_AddSameRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) { return lhs + rhs; });
+}
+BENCHMARK(BM_Unit_AddSameRatio);
+
+static void BM_Raw_UncheckedAddSameRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) { return lhs + rhs; });
+}
+BENCHMARK(BM_Raw_UncheckedAddSameRatio);
+
+static void BM_Unit_UncheckedAddSameRatio(benchmark::State &state) {
+    run<unchecked_bytes>(state, [](const unchecked_bytes lhs, const unchecked_bytes rhs) { return lhs + rhs; });
+}
+BENCHMARK(BM_Unit_UncheckedAddSameRatio);
+
+static void BM_Raw_AddCrossRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) {
+        return checked_add(lhs, checked_shift(rhs >> 10, 10));
+    });
+}
+BENCHMARK(BM_Raw_AddCrossRatio);
+
+static void BM_Unit_AddCrossRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) { return lhs + kilobytes(rhs.count() >> 10); });
+}
+BENCHMARK(BM_Unit_AddCrossRatio);
+
+static void BM_Raw_SubtractSameRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) {
+        return checked_subtract(lhs | 1ULL << 63, rhs);
+    });
+}
+BENCHMARK(BM_Raw_SubtractSameRatio);
+
+static void BM_Unit_SubtractSameRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) { return bytes(lhs.count() | 1ULL << 63) - rhs; });
+}
+BENCHMARK(BM_Unit_SubtractSameRatio);
+
+static void BM_Raw_SubtractCrossRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) {
+        return checked_subtract(lhs | 1ULL << 63, checked_shift(rhs >> 10, 10));
+    });
+}
+BENCHMARK(BM_Raw_SubtractCrossRatio);
+
+static void BM_Unit_SubtractCrossRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) {
+        return bytes(lhs.count() | 1ULL << 63) - kilobytes(rhs.count() >> 10);
+    });
+}
+BENCHMARK(BM_Unit_SubtractCrossRatio);
+
+static void BM_Raw_CompareSameRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) { return lhs > rhs; });
+}
+BENCHMARK(BM_Raw_CompareSameRatio);
+
+static void BM_Unit_CompareSameRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) { return lhs > rhs; });
+}
+BENCHMARK(BM_Unit_CompareSameRatio);
+
+static void BM_Raw_CompareCrossRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) {
+        return lhs > checked_shift(rhs >> 10, 10);
+    });
+}
+BENCHMARK(BM_Raw_CompareCrossRatio);
+
+static void BM_Unit_CompareCrossRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) { return lhs > kilobytes(rhs.count() >> 10); });
+}
+BENCHMARK(BM_Unit_CompareCrossRatio);
+
+static void BM_Raw_CastToSmallerRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t) { return checked_shift(lhs, 10); });
+}
+BENCHMARK(BM_Raw_CastToSmallerRatio);
+
+static void BM_Unit_CastToSmallerRatio(benchmark::State &state) {
+    run<kilobytes>(state, [](const kilobytes lhs, const kilobytes) { return memory_unit_cast<bytes>(lhs); });
+}
+BENCHMARK(BM_Unit_CastToSmallerRatio);
+
+static void BM_Raw_CastToGreaterRatio(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t) { return lhs >> 20; });
+}
+BENCHMARK(BM_Raw_CastToGreaterRatio);
+
+static void BM_Unit_CastToGreaterRatio(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes) { return memory_unit_cast<megabytes>(lhs); });
+}
+BENCHMARK(BM_Unit_CastToGreaterRatio);
+
+static void BM_Raw_MultiplyByInteger(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) { return lhs * (rhs & 0xff); });
+}
+BENCHMARK(BM_Raw_MultiplyByInteger);
+
+static void BM_Unit_MultiplyByInteger(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) { return lhs * (rhs.count() & 0xff); });
+}
+BENCHMARK(BM_Unit_MultiplyByInteger);
+
+static void BM_Raw_MultiplyByFloat(benchmark::State &state) {
+    run<std::uint64_t>(state, [](const std::uint64_t lhs, const std::uint64_t rhs) {
+        return static_cast<std::uint64_t>(lhs * (static_cast<float>(rhs & 0xff) * 0.01f));
+    });
+}
+BENCHMARK(BM_Raw_MultiplyByFloat);
+
+static void BM_Unit_MultiplyByFloat(benchmark::State &state) {
+    run<bytes>(state, [](const bytes lhs, const bytes rhs) {
+        return lhs * (static_cast<float>(rhs.count() & 0xff) * 0.01f);
+    });
+}
+BENCHMARK(BM_Unit_MultiplyByFloat);
+
+static void BM_Raw_LiteralConstruction(benchmark::State &state) {
+    for (auto _ : state) {
+        std::uint64_t count = 64 * 1'024;
+        benchmark::DoNotOptimize(count);
+    }
+}
+BENCHMARK(BM_Raw_LiteralConstruction);
+
+static void BM_Unit_LiteralConstruction(benchmark::State &state) {
+    for (auto _ : state) {
+        auto unit = memory_unit_cast<bytes>(64_kb);
+        benchmark::DoNotOptimize(unit);
+    }
+}
+BENCHMARK(BM_Unit_LiteralConstruction);
+
+static void BM_Raw_Format(benchmark::State &state) {
+    std::array<char, 64> buffer{};
+    run<std::uint64_t>(state, [&buffer](const std::uint64_t lhs, const std::uint64_t) {
+        return std::format_to(buffer.data(), "{}kb", lhs);
+    });
+}
+BENCHMARK(BM_Raw_Format);
+
+static void BM_Unit_Format(benchmark::State &state) {
+    std::array<char, 64> buffer{};
+    run<kilobytes>(state, [&buffer](const kilobytes lhs, const kilobytes) {
+        return std::format_to(buffer.data(), "{}", lhs);
+    });
+}
+BENCHMARK(BM_Unit_Format);
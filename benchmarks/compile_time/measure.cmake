@@ -0,0 +1,42 @@
+# Measures the build time of the synthetic project of this directory once including `mem_units.hpp` and once
+# importing the afs.mem_units module, each configured into its own build directory and built from scratch.
+#
+#   cmake -DBINARY_DIR=<dir> [-DGENERATOR=<generator>] [-DCXX_COMPILER=<compiler>] [-DTRANSLATION_UNITS=<count>]
+#         -P benchmarks/compile_time/measure.cmake
+
+cmake_minimum_required(VERSION 3.31)
+
+if(NOT BINARY_DIR)
+  message(FATAL_ERROR "BINARY_DIR is required")
+endif()
+if(NOT TRANSLATION_UNITS)
+  set(TRANSLATION_UNITS 500)
+endif()
+
+set(configure_options -DCMAKE_BUILD_TYPE=Debug -DMEM_UNITS_TRANSLATION_UNITS=${TRANSLATION_UNITS})
+if(GENERATOR)
+  list(APPEND configure_options -G ${GENERATOR})
+endif()
+if(CXX_COMPILER)
+  list(APPEND configure_options -DCMAKE_CXX_COMPILER=${CXX_COMPILER})
+endif()
+
+foreach(usage header module)
+  set(build_dir ${BINARY_DIR}/${usage})
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -S ${CMAKE_CURRENT_LIST_DIR} -B ${build_dir} ${configure_options} -DMEM_UNITS_USAGE=${usage}
+    OUTPUT_QUIET
+    COMMAND_ERROR_IS_FATAL ANY
+  )
+  execute_process(COMMAND ${CMAKE_COMMAND} --build ${build_dir} --target clean OUTPUT_QUIET COMMAND_ERROR_IS_FATAL ANY)
+
+  string(TIMESTAMP begin "%s%f" UTC)
+  execute_process(COMMAND ${CMAKE_COMMAND} --build ${build_dir} OUTPUT_QUIET COMMAND_ERROR_IS_FATAL ANY)
+  string(TIMESTAMP end "%s%f" UTC)
+
+  math(EXPR milliseconds_${usage} "(${end} - ${begin}) / 1000")
+  message(STATUS "${usage}: ${TRANSLATION_UNITS} translation units built in ${milliseconds_${usage}} ms")
+endforeach()
+
+math(EXPR percent "100 * ${milliseconds_module} / ${milliseconds_header}")
+message(STATUS "module build takes ${percent}% of the header build")
@@ -0,0 +1,113 @@
+module;
+
+// The module exports the API of `mem_units.hpp` and `mem_units/format.hpp` by using declarations of the entities of
+// the headers, which are included in the global module fragment. So the module and the headers declare the same
+// entities, and translation units importing the module link with those including the headers.
+
+#include "mem_units.hpp"
+#include "mem_units/format.hpp"
+
+export module afs.mem_units;
+
+export namespace afs::mem_units {
+    using afs::mem_units::is_ratio;
+    using afs::mem_units::RatioType;
+    using afs::mem_units::RepType;
+    using afs::mem_units::wouldMultiplicationOverflow;
+
+    using afs::mem_units::checked_overflow;
+    using afs::mem_units::saturating_overflow;
+    using afs::mem_units::wrapping_overflow;
+    using afs::mem_units::unchecked_overflow;
+    using afs::mem_units::OverflowPolicyType;
+
+    using afs::mem_units::memory_unit;
+    using afs::mem_units::is_memory_unit;
+    using afs::mem_units::MemoryUnitType;
+    using afs::mem_units::operator<=>;
+    using afs::mem_units::operator==;
+    using afs::mem_units::memory_unit_cast;
+    using afs::mem_units::operator*;
+    using afs::mem_units::common_memory_unit;
+    using afs::mem_units::common_memory_unit_t;
+    using afs::mem_units::operator+;
+    using afs::mem_units::operator-;
+
+    using afs::mem_units::bits;
+    using afs::mem_units::bytes;
+    using afs::mem_units::kilobytes;
+    using afs::mem_units::megabytes;
+    using afs::mem_units::gigabytes;
+    using afs::mem_units::terabytes;
+    using afs::mem_units::petabytes;
+    using afs::mem_units::exabytes;
+
+    using afs::mem_units::with_overflow_policy_t;
+
+    using afs::mem_units::saturating_bits;
+    using afs::mem_units::saturating_bytes;
+    using afs::mem_units::saturating_kilobytes;
+    using afs::mem_units::saturating_megabytes;
+    using afs::mem_units::saturating_gigabytes;
+    using afs::mem_units::saturating_terabytes;
+    using afs::mem_units::saturating_petabytes;
+    using afs::mem_units::saturating_exabytes;
+
+    using afs::mem_units::wrapping_bits;
+    using afs::mem_units::wrapping_bytes;
+    using afs::mem_units::wrapping_kilobytes;
+    using afs::mem_units::wrapping_megabytes;
+    using afs::mem_units::wrapping_gigabytes;
+    using afs::mem_units::wrapping_terabytes;
+    using afs::mem_units::wrapping_petabytes;
+    using afs::mem_units::wrapping_exabytes;
+
+    using afs::mem_units::unchecked_bits;
+    using afs::mem_units::unchecked_bytes;
+    using afs::mem_units::unchecked_kilobytes;
+    using afs::mem_units::unchecked_megabytes;
+    using afs::mem_units::unchecked_gigabytes;
+    using afs::mem_units::unchecked_terabytes;
+    using afs::mem_units::unchecked_petabytes;
+    using afs::mem_units::unchecked_exabytes;
+
+    using afs::mem_units::with_rep_t;
+
+    using afs::mem_units::bits32;
+    using afs::mem_units::bytes32;
+    using afs::mem_units::kilobytes32;
+    using afs::mem_units::megabytes32;
+    using afs::mem_units::gigabytes32;
+    using afs::mem_units::terabytes32;
+    using afs::mem_units::petabytes32;
+    using afs::mem_units::exabytes32;
+
+    using afs::mem_units::bits16;
+    using afs::mem_units::bytes16;
+    using afs::mem_units::kilobytes16;
+    using afs::mem_units::megabytes16;
+    using afs::mem_units::gigabytes16;
+    using afs::mem_units::terabytes16;
+    using afs::mem_units::petabytes16;
+    using afs::mem_units::exabytes16;
+
+    using afs::mem_units::memory_unit_suffix;
+    using afs::mem_units::unit_description;
+    using afs::mem_units::known_units;
+
+    namespace literals {
+        using afs::mem_units::literals::operator""_bit;
+        using afs::mem_units::literals::operator""_b;
+        using afs::mem_units::literals::operator""_kb;
+        using afs::mem_units::literals::operator""_mb;
+        using afs::mem_units::literals::operator""_gb;
+        using afs::mem_units::literals::operator""_tb;
+        using afs::mem_units::literals::operator""_pb;
+        using afs::mem_units::literals::operator""_eb;
+    }
+}
+
+// Declarations of the global module fragment the module purview does not refer to are discarded, which would leave
+// importers without the specializations of `std::common_type` and `std::formatter`.
+static_assert(std::is_same_v<std::common_type_t<afs::mem_units::kilobytes, afs::mem_units::bytes>, afs::mem_units::bytes>);
+static_assert(std::is_default_constructible_v<std::formatter<afs::mem_units::bytes, char> >);
@@ -1,12 +1,27 @@
 #ifndef FF9A3C64_8D45_4C1F_9A1D_9E3277F7C3A1
 #define FF9A3C64_8D45_4C1F_9A1D_9E3277F7C3A1
 
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
 #include <ratio>
+#include <stdexcept>
+#include <string_view>
 #include <type_traits>
-#include <format>
-#include <ostream>
 #include <utility>
-#include <stdexcept>
+
+// Throws \a exception, or aborts if exceptions are disabled (e.g. by `-fno-exceptions`), like the standard library
+// does. Builds without exceptions handle errors by the functions of `mem_units/checked.hpp` instead.
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define AFS_MEM_UNITS_THROW(exception) throw exception
+#else
+#define AFS_MEM_UNITS_THROW(exception) std::abort()
+#endif
 
 namespace afs::mem_units {
     // Helper trait to detect std::ratio specializations
@@ -24,14 +39,294 @@ namespace afs::mem_units {
     template<typename T>
     concept RepType = std::is_arithmetic_v<T>;
 
-    template<RepType Rep, RatioType Ratio>
+    /// Returns if \a op1 `*` \a op2 does NOT fit into unsigned  \t RepType.
+    template <RepType Rep>
+    [[nodiscard]] constexpr bool wouldMultiplicationOverflow(const Rep& op1, const auto& op2) {
+        if (not std::cmp_equal(op2, 0)) {
+            return std::cmp_less(std::numeric_limits<Rep>::max() / op2, op1);
+        }
+        return false;
+    }
+
+    /// Returns if \a op1 `*` \a op2 does NOT fit into signed  \t RepType.
+    template <RepType Rep>
+        requires std::is_signed_v<Rep>
+    [[nodiscard]] constexpr bool wouldMultiplicationOverflow(const Rep& op1, const auto& op2) {
+        if (not std::cmp_equal(op2, 0)) {
+            return std::cmp_less(std::numeric_limits<Rep>::max() / op2, std::abs(op1));
+        }
+        return false;
+    }
+
+    namespace detail {
+        /// Returns if \a value is a positive power of two.
+        [[nodiscard]] constexpr bool is_power_of_two(const std::intmax_t value) {
+            return value > 0 && (value & (value - 1)) == 0;
+        }
+
+        /// Returns if \a value is less than 0, for integral and floating point reps alike.
+        template<RepType Rep>
+        [[nodiscard]] constexpr bool is_negative(const Rep value) noexcept {
+            if constexpr (std::is_integral_v<Rep>) {
+                return std::cmp_less(value, 0);
+            } else {
+                return value < 0;
+            }
+        }
+
+        /// Returns if \a lhs `+` \a rhs does NOT fit into \t Rep, which is never the case for floating point reps.
+        template<RepType Rep>
+        [[nodiscard]] constexpr bool would_add_overflow(const Rep lhs, const Rep rhs) noexcept {
+            if constexpr (std::is_integral_v<Rep>) {
+                return std::cmp_less(std::numeric_limits<Rep>::max() - lhs, rhs);
+            } else {
+                return false;
+            }
+        }
+
+        /// Returns if \a lhs `-` \a rhs does NOT fit into \t Rep, which is never the case for floating point reps.
+        template<RepType Rep>
+        [[nodiscard]] constexpr bool would_subtract_underflow(const Rep lhs, const Rep rhs) noexcept {
+            if constexpr (std::is_integral_v<Rep>) {
+                return std::cmp_less(std::numeric_limits<Rep>::min() + lhs, rhs);
+            } else {
+                return false;
+            }
+        }
+
+        /// The greatest value of \t Rep that can be multiplied by \t Factor without overflow.
+        template<RepType Rep, std::intmax_t Factor>
+            requires (Factor > 0)
+        inline constexpr Rep multiplication_threshold = static_cast<Rep>(std::numeric_limits<Rep>::max() / Factor);
+    }
+
+    /// Returns if \a op1 `*` \t Factor does NOT fit into \t RepType.
+    ///
+    /// Other than the runtime overload, the overflow threshold of an unsigned \t Rep is computed at compile time,
+    /// so the check is a single compare. A floating point \t Rep never overflows, it becomes infinite.
+    template <std::intmax_t Factor, RepType Rep>
+    [[nodiscard]] constexpr bool wouldMultiplicationOverflow(const Rep& op1) {
+        if constexpr (Factor == 0 || Factor == 1 || std::is_floating_point_v<Rep>) {
+            return false;
+        } else if constexpr (std::is_unsigned_v<Rep>) {
+            return op1 > detail::multiplication_threshold<Rep, Factor>;
+        } else {
+            return wouldMultiplicationOverflow(op1, Factor);
+        }
+    }
+
+    namespace detail {
+        /// Returns \a value `*` \t Factor, which is a left shift if \t Factor is a power of two and \t Rep is unsigned.
+        ///
+        /// Bits shifted out are discarded, like the modulo arithmetic of an unsigned multiplication.
+        template<std::intmax_t Factor, RepType Rep>
+        [[nodiscard]] constexpr Rep scale_up(const Rep value) noexcept {
+            if constexpr (Factor == 1) {
+                return value;
+            } else if constexpr (std::is_unsigned_v<Rep> && is_power_of_two(Factor)) {
+                constexpr int shift = std::countr_zero(static_cast<std::uintmax_t>(Factor));
+                if constexpr (shift >= std::numeric_limits<Rep>::digits) {
+                    return Rep{0};
+                } else {
+                    return static_cast<Rep>(value << shift);
+                }
+            } else {
+                return static_cast<Rep>(value * Factor);
+            }
+        }
+
+        /// Returns \a value `/` \t Divisor, which is a right shift if \t Divisor is a power of two and \t Rep is unsigned.
+        template<std::intmax_t Divisor, RepType Rep>
+            requires (Divisor > 0)
+        [[nodiscard]] constexpr Rep scale_down(const Rep value) noexcept {
+            if constexpr (Divisor == 1) {
+                return value;
+            } else if constexpr (std::is_unsigned_v<Rep> && is_power_of_two(Divisor)) {
+                constexpr int shift = std::countr_zero(static_cast<std::uintmax_t>(Divisor));
+                if constexpr (shift >= std::numeric_limits<Rep>::digits) {
+                    return Rep{0};
+                } else {
+                    return static_cast<Rep>(value >> shift);
+                }
+            } else {
+                return static_cast<Rep>(value / Divisor);
+            }
+        }
+
+        /// Returns if \a value is representable by \t To, which is only checked if both reps are integral.
+        template<RepType To, RepType From>
+        [[nodiscard]] constexpr bool fits_into(const From value) noexcept {
+            if constexpr (std::is_integral_v<To> && std::is_integral_v<From>) {
+                return std::in_range<To>(value);
+            } else {
+                return true;
+            }
+        }
+    }
+
+    /// Overflow policy that throws on overflow and underflow (the default).
+    struct checked_overflow {
+        /// \throws std::overflow_error if \a lhs `+` \a rhs does not fit into \t Rep.
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep add(const Rep lhs, const Rep rhs) {
+            if (detail::would_add_overflow(lhs, rhs)) {
+                AFS_MEM_UNITS_THROW(std::overflow_error("Addition would cause an overflow!"));
+            }
+            return static_cast<Rep>(lhs + rhs);
+        }
+
+        /// \throws std::underflow_error if \a lhs `-` \a rhs does not fit into \t Rep.
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep subtract(const Rep lhs, const Rep rhs) {
+            if (detail::would_subtract_underflow(lhs, rhs)) {
+                AFS_MEM_UNITS_THROW(std::underflow_error("Subtraction would cause an underflow!"));
+            }
+            return static_cast<Rep>(lhs - rhs);
+        }
+
+        /// \throws std::overflow_error if \a value `*` \t Factor does not fit into \t Rep.
+        template<std::intmax_t Factor, RepType Rep>
+        [[nodiscard]] static constexpr Rep multiply(const Rep value) {
+            if (wouldMultiplicationOverflow<Factor>(value)) {
+                AFS_MEM_UNITS_THROW(std::overflow_error("Conversion would cause an overflow!"));
+            }
+            return detail::scale_up<Factor>(value);
+        }
+
+        /// \throws std::overflow_error if \a value is greater than the maximum of \t To.
+        /// \throws std::underflow_error if \a value is less than the minimum of \t To.
+        template<RepType To, RepType From>
+        [[nodiscard]] static constexpr To narrow(const From value) {
+            if (not detail::fits_into<To>(value)) {
+                if (detail::is_negative(value)) {
+                    AFS_MEM_UNITS_THROW(std::underflow_error("Conversion would cause an underflow!"));
+                }
+                AFS_MEM_UNITS_THROW(std::overflow_error("Conversion would cause an overflow!"));
+            }
+            return static_cast<To>(value);
+        }
+    };
+
+    /// Overflow policy that clamps results to the limits of the rep type.
+    struct saturating_overflow {
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep add(const Rep lhs, const Rep rhs) noexcept {
+            if (detail::would_add_overflow(lhs, rhs)) {
+                return std::numeric_limits<Rep>::max();
+            }
+            return static_cast<Rep>(lhs + rhs);
+        }
+
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep subtract(const Rep lhs, const Rep rhs) noexcept {
+            if (detail::would_subtract_underflow(lhs, rhs)) {
+                return std::numeric_limits<Rep>::min();
+            }
+            return static_cast<Rep>(lhs - rhs);
+        }
+
+        template<std::intmax_t Factor, RepType Rep>
+        [[nodiscard]] static constexpr Rep multiply(const Rep value) noexcept {
+            if (wouldMultiplicationOverflow<Factor>(value)) {
+                return detail::is_negative(value) ? std::numeric_limits<Rep>::min() : std::numeric_limits<Rep>::max();
+            }
+            return detail::scale_up<Factor>(value);
+        }
+
+        template<RepType To, RepType From>
+        [[nodiscard]] static constexpr To narrow(const From value) noexcept {
+            if (not detail::fits_into<To>(value)) {
+                return detail::is_negative(value) ? std::numeric_limits<To>::min() : std::numeric_limits<To>::max();
+            }
+            return static_cast<To>(value);
+        }
+    };
+
+    /// Overflow policy with modulo arithmetic, i.e. results wrap around at the limits of the rep type.
+    ///
+    /// Other than \ref unchecked_overflow this is also well-defined for signed rep types.
+    struct wrapping_overflow {
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep add(const Rep lhs, const Rep rhs) noexcept {
+            using unsigned_type = std::common_type_t<std::make_unsigned_t<Rep>, unsigned>;
+            return static_cast<Rep>(static_cast<unsigned_type>(lhs) + static_cast<unsigned_type>(rhs));
+        }
+
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep subtract(const Rep lhs, const Rep rhs) noexcept {
+            using unsigned_type = std::common_type_t<std::make_unsigned_t<Rep>, unsigned>;
+            return static_cast<Rep>(static_cast<unsigned_type>(lhs) - static_cast<unsigned_type>(rhs));
+        }
+
+        template<std::intmax_t Factor, RepType Rep>
+        [[nodiscard]] static constexpr Rep multiply(const Rep value) noexcept {
+            using unsigned_type = std::common_type_t<std::make_unsigned_t<Rep>, unsigned>;
+            return static_cast<Rep>(detail::scale_up<Factor>(static_cast<unsigned_type>(value)));
+        }
+
+        template<RepType To, RepType From>
+        [[nodiscard]] static constexpr To narrow(const From value) noexcept {
+            return static_cast<To>(value);
+        }
+    };
+
+    /// Overflow policy without any checks, so each operation compiles to the plain instruction on \t Rep.
+    ///
+    /// An overflow of an unsigned rep wraps around, an overflow of a signed rep is undefined behavior.
+    struct unchecked_overflow {
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep add(const Rep lhs, const Rep rhs) noexcept {
+            return static_cast<Rep>(lhs + rhs);
+        }
+
+        template<RepType Rep>
+        [[nodiscard]] static constexpr Rep subtract(const Rep lhs, const Rep rhs) noexcept {
+            return static_cast<Rep>(lhs - rhs);
+        }
+
+        template<std::intmax_t Factor, RepType Rep>
+        [[nodiscard]] static constexpr Rep multiply(const Rep value) noexcept {
+            return detail::scale_up<Factor>(value);
+        }
+
+        template<RepType To, RepType From>
+        [[nodiscard]] static constexpr To narrow(const From value) noexcept {
+            return static_cast<To>(value);
+        }
+    };
+
+    template<typename T>
+    concept OverflowPolicyType = requires(const std::uint64_t value) {
+        { T::add(value, value) } -> std::same_as<std::uint64_t>;
+        { T::subtract(value, value) } -> std::same_as<std::uint64_t>;
+        { T::template multiply<1>(value) } -> std::same_as<std::uint64_t>;
+        { T::template narrow<std::uint32_t>(value) } -> std::same_as<std::uint32_t>;
+    };
+
+    /// A count of memory units with a compile time \t Ratio relative to a byte.
+    ///
+    /// How over- and underflows of `+`, `+=`, `-` and \ref memory_unit_cast are handled is defined by
+    /// \t OverflowPolicy, see \ref checked_overflow, \ref saturating_overflow, \ref wrapping_overflow and
+    /// \ref unchecked_overflow.
+    ///
+    /// Memory units are structural types, so they can be used as non-type template parameters:
+    /// ~~~~~.cpp
+    /// monotonic_arena<64_mb> arena;
+    /// ~~~~~
+    template<RepType Rep, RatioType Ratio, OverflowPolicyType OverflowPolicy = checked_overflow>
     class memory_unit {
+    public:
+        /// The count, public only because a non-type template parameter must be of a structural type, which has
+        /// no private members.
+        ///
+        /// Not part of the API and must not be accessed directly: read it by \ref count, and change it by the
+        /// operators only, which apply the overflow policy.
         Rep _count = 0;
 
-    public:
         using ratio = Ratio;
         using rep = Rep;
-        using this_type = memory_unit<Rep, Ratio>;
+        using overflow_policy = OverflowPolicy;
+        using this_type = memory_unit<Rep, Ratio, OverflowPolicy>;
 
         constexpr memory_unit() = default;
 
@@ -52,9 +347,20 @@ namespace afs::mem_units {
         /// ~~~~~.cpp
         /// constexpr kilobytes kb(std::memory_cast<kilobytes>(1200_b)); // results in 1_kb
         /// ~~~~~
-        template<RatioType OtherRatio>
+        ///
+        /// The overflow policy of \a other may differ, the conversion is done with the one of `this`:
+        /// ~~~~~.cpp
+        /// const unchecked_bytes b(4_mb);
+        /// ~~~~~
+        ///
+        /// So may the rep of \a other, whose count is then checked to fit into \ref rep by the overflow policy:
+        /// ~~~~~.cpp
+        /// const kilobytes32 kb(4_mb); // ok
+        /// const kilobytes32 too_big(8_tb); // throws std::overflow_error
+        /// ~~~~~
+        template<RepType OtherRep, RatioType OtherRatio, OverflowPolicyType OtherPolicy>
             requires std::ratio_greater_equal_v<OtherRatio, ratio>
-        explicit constexpr memory_unit(const memory_unit<Rep, OtherRatio> &other) {
+        explicit constexpr memory_unit(const memory_unit<OtherRep, OtherRatio, OtherPolicy> &other) {
             const auto other_converted = memory_unit_cast<this_type>(other);
             _count = other_converted.count();
         }
@@ -71,9 +377,11 @@ namespace afs::mem_units {
         /// ~~~~~.cpp
         /// constexpr kilobytes kb = std::memory_cast<kilobytes>(2_b); // results in 0_kb
         /// ~~~~~
-        template<RatioType OtherRatio>
+        ///
+        /// \a other may have another rep, whose count is then checked to fit into \ref rep by the overflow policy.
+        template<RepType OtherRep, RatioType OtherRatio>
             requires std::ratio_greater_equal_v<OtherRatio, ratio>
-        constexpr this_type& operator=(const memory_unit<Rep, OtherRatio> &other) {
+        constexpr this_type& operator=(const memory_unit<OtherRep, OtherRatio, OverflowPolicy> &other) {
             const auto other_converted = memory_unit_cast<this_type>(other);
             _count = other_converted.count();
             return *this;
@@ -88,12 +396,11 @@ namespace afs::mem_units {
         /// assert(32_mb + 6_mb == 38_mb)
         /// ~~~~~
         ///
-        /// \throws std::overflow_error if the result does not fit into the current rep type.
-        [[nodiscard]] constexpr memory_unit operator+(const memory_unit &other) const {
-            if (std::cmp_less(std::numeric_limits<Rep>::max() - count(), other.count())) {
-                throw std::overflow_error("Addition would cause an overflow!");
-            }
-            return memory_unit{static_cast<Rep>(count() + other.count())};
+        /// \throws std::overflow_error if the result does not fit into the current rep type
+        ///         and \ref overflow_policy is \ref checked_overflow.
+        [[nodiscard]] constexpr memory_unit operator+(const memory_unit &other) const
+            noexcept(noexcept(OverflowPolicy::add(Rep{}, Rep{}))) {
+            return memory_unit{OverflowPolicy::add(count(), other.count())};
         }
 
         /// `this` += \a other, where \ref ratio of both is equal.
@@ -104,12 +411,10 @@ namespace afs::mem_units {
         /// assert(value == 38_mb)
         /// ~~~~~
         ///
-        /// \throws std::overflow_error if the result does not fit into the current rep type.
-        constexpr memory_unit& operator+=(const memory_unit &other) {
-            if (std::cmp_less(std::numeric_limits<Rep>::max() - count(), other.count())) {
-                throw std::overflow_error("Addition would cause an overflow!");
-            }
-            _count += other.count();
+        /// \throws std::overflow_error if the result does not fit into the current rep type
+        ///         and \ref overflow_policy is \ref checked_overflow.
+        constexpr memory_unit& operator+=(const memory_unit &other) noexcept(noexcept(OverflowPolicy::add(Rep{}, Rep{}))) {
+            _count = OverflowPolicy::add(count(), other.count());
             return *this;
         }
 
@@ -121,7 +426,7 @@ namespace afs::mem_units {
         /// ~~~~~
         template<RatioType OtherRatio>
             requires std::ratio_greater_v<OtherRatio, ratio>
-        [[nodiscard]] constexpr this_type operator+(const memory_unit<Rep, OtherRatio> &other) const {
+        [[nodiscard]] constexpr this_type operator+(const memory_unit<Rep, OtherRatio, OverflowPolicy> &other) const {
             const auto other_converted = memory_unit_cast<this_type>(other);
             return operator+(other_converted);
         }
@@ -134,8 +439,8 @@ namespace afs::mem_units {
         /// ~~~~~
         template<RatioType OtherRatio>
             requires std::ratio_less_v<OtherRatio, ratio>
-        [[nodiscard]] constexpr memory_unit<Rep, OtherRatio> operator+(const memory_unit<Rep, OtherRatio> &other) const {
-            using other_type = memory_unit<Rep, OtherRatio>;
+        [[nodiscard]] constexpr memory_unit<Rep, OtherRatio, OverflowPolicy> operator+(const memory_unit<Rep, OtherRatio, OverflowPolicy> &other) const {
+            using other_type = memory_unit<Rep, OtherRatio, OverflowPolicy>;
             const other_type converted = memory_unit_cast<other_type>(*this);
             return other.operator+(converted);
         }
@@ -146,12 +451,11 @@ namespace afs::mem_units {
         /// assert(32_mb - 6_mb == 26_mb)
         /// ~~~~~
         ///
-        /// \throws std::underflow_error if the result does not fit into the current count.
-        [[nodiscard]] constexpr memory_unit operator-(const memory_unit &other) const {
-            if (std::cmp_less(std::numeric_limits<Rep>::min() + count(), other.count())) {
-                throw std::underflow_error("Subtraction would cause an underflow!");
-            }
-            return memory_unit{static_cast<Rep>(count() - other.count())};
+        /// \throws std::underflow_error if the result does not fit into the current count
+        ///         and \ref overflow_policy is \ref checked_overflow.
+        [[nodiscard]] constexpr memory_unit operator-(const memory_unit &other) const
+            noexcept(noexcept(OverflowPolicy::subtract(Rep{}, Rep{}))) {
+            return memory_unit{OverflowPolicy::subtract(count(), other.count())};
         }
 
         /// `this` - \a other, where \ref ratio of \a other is greater.
@@ -162,7 +466,7 @@ namespace afs::mem_units {
         /// ~~~~~
         template<RatioType OtherRatio>
             requires std::ratio_greater_v<OtherRatio, ratio>
-        [[nodiscard]] constexpr this_type operator-(const memory_unit<Rep, OtherRatio> &other) const {
+        [[nodiscard]] constexpr this_type operator-(const memory_unit<Rep, OtherRatio, OverflowPolicy> &other) const {
             const auto other_converted = memory_unit_cast<this_type>(other);
             return operator-(other_converted);
         }
@@ -175,8 +479,8 @@ namespace afs::mem_units {
         /// ~~~~~
         template<RatioType OtherRatio>
             requires std::ratio_less_v<OtherRatio, ratio>
-        [[nodiscard]] constexpr memory_unit<Rep, OtherRatio> operator-(const memory_unit<Rep, OtherRatio> &other) const {
-            using other_type = memory_unit<Rep, OtherRatio>;
+        [[nodiscard]] constexpr memory_unit<Rep, OtherRatio, OverflowPolicy> operator-(const memory_unit<Rep, OtherRatio, OverflowPolicy> &other) const {
+            using other_type = memory_unit<Rep, OtherRatio, OverflowPolicy>;
             const other_type converted = memory_unit_cast<other_type>(*this);
             return converted.operator-(other);
         }
@@ -187,89 +491,146 @@ namespace afs::mem_units {
     struct is_memory_unit : std::false_type {
     };
 
-    template<RepType Rep, std::intmax_t Num, std::intmax_t Den>
-    struct is_memory_unit<memory_unit<Rep, std::ratio<Num, Den> > > : std::true_type {
+    template<RepType Rep, std::intmax_t Num, std::intmax_t Den, OverflowPolicyType OverflowPolicy>
+    struct is_memory_unit<memory_unit<Rep, std::ratio<Num, Den>, OverflowPolicy> > : std::true_type {
     };
 
     template<typename T>
     concept MemoryUnitType = is_memory_unit<T>::value;
 
-    template<RepType Rep, RatioType Ratio>
-    constexpr bool operator==(const memory_unit<Rep, Ratio> &lhs, const memory_unit<Rep, Ratio> &rhs) {
-        return lhs.count() == rhs.count();
-    }
-
-    template<RepType Rep, RatioType Ratio>
-    constexpr bool operator<(const memory_unit<Rep, Ratio> &lhs, const memory_unit<Rep, Ratio> &rhs) {
-        return lhs.count() < rhs.count();
-    }
-
-    template<RepType Rep, RatioType Ratio>
-    constexpr bool operator>(const memory_unit<Rep, Ratio> &lhs, const memory_unit<Rep, Ratio> &rhs) {
-        return lhs.count() > rhs.count();
-    }
-
-    /// Returns if \a lhs `==` \a rhs, where \a lhs has the greater or an equal ratio.
-    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
-        requires std::ratio_greater_equal_v<typename LhsType::ratio, typename RhsType::ratio>
-    constexpr bool operator==(const LhsType &lhs, const RhsType &rhs) {
-        auto converted = memory_unit_cast<RhsType>(lhs);
-        return std::cmp_equal(converted.count(), rhs.count());
-    }
-
-    /// Returns if \a lhs `==` \a rhs, where \a lhs has the smaller ratio.
-    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
-        requires std::ratio_less_v<typename LhsType::ratio, typename RhsType::ratio>
-    constexpr bool operator==(const LhsType &lhs, const RhsType &rhs) {
-        auto converted = memory_unit_cast<LhsType>(rhs);
-        return std::cmp_equal(converted.count(), lhs.count());
-    }
-
-    /// Returns if \a lhs `>` \a rhs, where \a lhs has the greater or an equal ratio.
-    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
-        requires std::ratio_greater_equal_v<typename LhsType::ratio, typename RhsType::ratio>
-    constexpr bool operator>(const LhsType &lhs, const RhsType &rhs) {
-        const auto lhs_converted = memory_unit_cast<RhsType>(lhs);
-        return std::cmp_greater(lhs_converted.count(), rhs.count());
+    namespace detail {
+        /// Like `std::ratio_divide<Lhs, Rhs>`, but with unsigned `num` and `den`, so quotients up to `2^64 - 1`
+        /// like `exabytes::ratio / bits::ratio` do not overflow.
+        template<RatioType Lhs, RatioType Rhs>
+        struct unsigned_ratio_divide {
+        private:
+            static constexpr auto num_gcd = static_cast<std::uintmax_t>(std::gcd(Lhs::num, Rhs::num));
+            static constexpr auto den_gcd = static_cast<std::uintmax_t>(std::gcd(Lhs::den, Rhs::den));
+            static constexpr auto lhs_num = static_cast<std::uintmax_t>(Lhs::num) / num_gcd;
+            static constexpr auto lhs_den = static_cast<std::uintmax_t>(Lhs::den) / den_gcd;
+            static constexpr auto rhs_num = static_cast<std::uintmax_t>(Rhs::num) / num_gcd;
+            static constexpr auto rhs_den = static_cast<std::uintmax_t>(Rhs::den) / den_gcd;
+
+            static_assert(not wouldMultiplicationOverflow(lhs_num, rhs_den) && not wouldMultiplicationOverflow(rhs_num, lhs_den),
+                          "quotient of ratios does not fit into std::uintmax_t");
+
+        public:
+            static constexpr std::uintmax_t num = lhs_num * rhs_den;
+            static constexpr std::uintmax_t den = rhs_num * lhs_den;
+        };
+
+        /// Returns \a lhs `*` \a rhs, in \a high the upper 64 bits of the product.
+        [[nodiscard]] constexpr std::uint64_t multiply_wide(const std::uint64_t lhs, const std::uint64_t rhs,
+                                                            std::uint64_t &high) noexcept {
+#ifdef __SIZEOF_INT128__
+            const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+            high = static_cast<std::uint64_t>(product >> 64);
+            return static_cast<std::uint64_t>(product);
+#else
+            constexpr std::uint64_t half_mask = 0xFFFF'FFFF;
+            const std::uint64_t low_low = (lhs & half_mask) * (rhs & half_mask);
+            const std::uint64_t high_low = (lhs >> 32) * (rhs & half_mask);
+            const std::uint64_t low_high = (lhs & half_mask) * (rhs >> 32);
+            const std::uint64_t high_high = (lhs >> 32) * (rhs >> 32);
+            const std::uint64_t middle = (low_low >> 32) + (high_low & half_mask) + (low_high & half_mask);
+            high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+            return (middle << 32) | (low_low & half_mask);
+#endif
+        }
     }
 
-    /// Returns if \a lhs `>` \a rhs, where \a lhs has the smaller ratio.
+    /// Compares \a lhs and \a rhs exactly, whatever their ratios and reps are, without ever throwing.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(1_kb <=> 1'024_b == 0);
+    /// static_assert(16_eb > bits(std::numeric_limits<std::uint64_t>::max()));
+    /// ~~~~~
+    ///
+    /// Memory units of the same ratio compare their counts directly. If one ratio is a multiple of the other,
+    /// the count of the smaller ratio is split into quotient and remainder. Otherwise both counts are scaled into
+    /// 128 bits. Floating point reps are compared as `long double` and result in a `std::partial_ordering`.
     template<MemoryUnitType LhsType, MemoryUnitType RhsType>
-        requires std::ratio_less_v<typename LhsType::ratio, typename RhsType::ratio>
-    constexpr bool operator>(const LhsType &lhs, const RhsType &rhs) {
-        const auto rhs_converted = memory_unit_cast<LhsType>(rhs);
-        return std::cmp_greater(lhs.count(), rhs_converted.count());
-    }
-
-    /// Returns if \a op1 `*` \a op2 does NOT fit into unsigned  \t RepType.
-    template <RepType Rep>
-    [[nodiscard]] constexpr bool wouldMultiplicationOverflow(const Rep& op1, const auto& op2) {
-        if (not std::cmp_equal(op2, 0)) {
-            return std::cmp_less(std::numeric_limits<Rep>::max() / op2, op1);
+    [[nodiscard]] constexpr auto operator<=>(const LhsType &lhs, const RhsType &rhs) noexcept {
+        using lhs_rep = typename LhsType::rep;
+        using rhs_rep = typename RhsType::rep;
+        using conversion = detail::unsigned_ratio_divide<typename LhsType::ratio, typename RhsType::ratio>;
+        constexpr bool both_unsigned = std::is_unsigned_v<lhs_rep> && std::is_unsigned_v<rhs_rep>;
+
+        if constexpr (std::is_floating_point_v<lhs_rep> || std::is_floating_point_v<rhs_rep>) {
+            return static_cast<long double>(lhs.count()) * static_cast<long double>(conversion::num)
+                   <=> static_cast<long double>(rhs.count()) * static_cast<long double>(conversion::den);
+        } else if constexpr (conversion::num == 1 && conversion::den == 1) {
+            if constexpr (std::is_signed_v<lhs_rep> == std::is_signed_v<rhs_rep>) {
+                return lhs.count() <=> rhs.count();
+            } else {
+                return std::cmp_less(lhs.count(), rhs.count()) ? std::strong_ordering::less
+                       : std::cmp_equal(lhs.count(), rhs.count()) ? std::strong_ordering::equal
+                       : std::strong_ordering::greater;
+            }
+        } else if constexpr (both_unsigned && conversion::den == 1) {
+            // lhs * num <=> rhs, where rhs = quotient * num + remainder
+            const std::uintmax_t quotient = rhs.count() / conversion::num;
+            const std::uintmax_t remainder = rhs.count() % conversion::num;
+            const auto order = static_cast<std::uintmax_t>(lhs.count()) <=> quotient;
+            return order != 0 ? order : std::uintmax_t{0} <=> remainder;
+        } else if constexpr (both_unsigned && conversion::num == 1) {
+            // lhs <=> rhs * den, where lhs = quotient * den + remainder
+            const std::uintmax_t quotient = lhs.count() / conversion::den;
+            const std::uintmax_t remainder = lhs.count() % conversion::den;
+            const auto order = quotient <=> static_cast<std::uintmax_t>(rhs.count());
+            return order != 0 ? order : remainder <=> std::uintmax_t{0};
+        } else {
+            constexpr auto magnitude = [](const auto count) {
+                const auto bits = static_cast<std::uint64_t>(count);
+                return std::cmp_less(count, 0) ? 0 - bits : bits;
+            };
+            const bool lhs_negative = std::cmp_less(lhs.count(), 0);
+            const bool rhs_negative = std::cmp_less(rhs.count(), 0);
+            std::uint64_t lhs_high = 0;
+            std::uint64_t rhs_high = 0;
+            const std::uint64_t lhs_low = detail::multiply_wide(magnitude(lhs.count()), conversion::num, lhs_high);
+            const std::uint64_t rhs_low = detail::multiply_wide(magnitude(rhs.count()), conversion::den, rhs_high);
+            const auto order = lhs_high != rhs_high ? lhs_high <=> rhs_high : lhs_low <=> rhs_low;
+            if (lhs_negative != rhs_negative) {
+                return rhs_negative <=> lhs_negative;
+            }
+            return lhs_negative ? 0 <=> order : order;
         }
-        return false;
     }
 
-    /// Returns if \a op1 `*` \a op2 does NOT fit into signed  \t RepType.
-    template <RepType Rep>
-        requires std::is_signed_v<Rep>
-    [[nodiscard]] constexpr bool wouldMultiplicationOverflow(const Rep& op1, const auto& op2) {
-        if (not std::cmp_equal(op2, 0)) {
-            return std::cmp_less(std::numeric_limits<Rep>::max() / op2, std::abs(op1));
-        }
-        return false;
+    /// Returns if \a lhs and \a rhs are exactly the same amount of memory, see `operator<=>`.
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+    [[nodiscard]] constexpr bool operator==(const LhsType &lhs, const RhsType &rhs) noexcept {
+        return std::is_eq(lhs <=> rhs);
     }
 
+    /// Converts \a from into \t ToType, rounding down if \t ToType has the greater ratio.
+    ///
+    /// Overflows are handled according to the \ref memory_unit::overflow_policy of \t ToType. If the reps differ,
+    /// the count is converted with the greatest integer of the signedness of the rep of \t FromType and then
+    /// narrowed to the rep of \t ToType.
+    ///
+    /// \throws std::overflow_error if the converted count does not fit into the rep type
+    ///         and the overflow policy of \t ToType is \ref checked_overflow.
+    /// \throws std::underflow_error if a negative count is converted to an unsigned rep type
+    ///         and the overflow policy of \t ToType is \ref checked_overflow.
     template<MemoryUnitType ToType, MemoryUnitType FromType>
     [[nodiscard]] constexpr ToType memory_unit_cast(const FromType& from) {
         using Rep = typename ToType::rep;
+        using FromRep = typename FromType::rep;
+        using overflow_policy = typename ToType::overflow_policy;
         using conversion = std::ratio_divide<typename FromType::ratio, typename ToType::ratio>;
-        if (wouldMultiplicationOverflow(from.count(), conversion::num)) {
-            throw std::overflow_error("Conversion would cause an overflow!");
+        if constexpr (std::is_same_v<Rep, FromRep>) {
+            const auto temp = overflow_policy::template multiply<conversion::num>(from.count());
+            const auto converted_count = static_cast<Rep>(detail::scale_down<conversion::den>(temp));
+            return ToType{converted_count};
+        } else {
+            using wide_rep = std::conditional_t<not std::is_integral_v<Rep> || not std::is_integral_v<FromRep>,
+                                                std::common_type_t<Rep, FromRep>,
+                                                std::conditional_t<std::is_signed_v<FromRep>, std::intmax_t, std::uintmax_t>>;
+            const auto temp = overflow_policy::template multiply<conversion::num>(static_cast<wide_rep>(from.count()));
+            return ToType{overflow_policy::template narrow<Rep>(detail::scale_down<conversion::den>(temp))};
         }
-        const auto temp = from.count() * conversion::num;
-        const auto converted_count = static_cast<Rep>(temp / conversion::den);
-        return ToType{converted_count};
     }
 
     /// Returns \a mem_unit `*` \a multiplier.
@@ -296,12 +657,55 @@ namespace afs::mem_units {
         return MemoryUnit{static_cast<typename MemoryUnit::rep>(mem_unit.count() * multiplier)};
     }
 
-    /// Returns if \a lhs `==` \a rhs, where \a lhs has the greater or an equal ratio.
+    /// The memory unit both \t LhsType and \t RhsType convert to without loss of precision, like
+    /// `std::common_type_t` of `std::chrono::duration`.
+    ///
+    /// Its rep is the common type of both reps and its ratio the greatest one both ratios are a multiple of.
+    /// Only defined if both have the same overflow policy.
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+    struct common_memory_unit {
+    };
+
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+        requires std::is_same_v<typename LhsType::overflow_policy, typename RhsType::overflow_policy>
+    struct common_memory_unit<LhsType, RhsType> {
+        using type = memory_unit<std::common_type_t<typename LhsType::rep, typename RhsType::rep>,
+                                 std::ratio<std::gcd(LhsType::ratio::num, RhsType::ratio::num),
+                                            std::lcm(LhsType::ratio::den, RhsType::ratio::den)>,
+                                 typename LhsType::overflow_policy>;
+    };
+
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+    using common_memory_unit_t = typename common_memory_unit<LhsType, RhsType>::type;
+
+    /// Returns \a lhs `+` \a rhs as \ref common_memory_unit_t, where the reps of both differ.
+    ///
+    /// ~~~~~.cpp
+    /// assert(kilobytes32(3) + 512_b == 3'584_b);
+    /// ~~~~~
+    ///
+    /// \throws std::overflow_error if the converted counts or the result do not fit into the common rep
+    ///         and the overflow policy is \ref checked_overflow.
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+        requires (not std::is_same_v<typename LhsType::rep, typename RhsType::rep>)
+                 && requires { typename common_memory_unit_t<LhsType, RhsType>; }
+    [[nodiscard]] constexpr common_memory_unit_t<LhsType, RhsType> operator+(const LhsType &lhs, const RhsType &rhs) {
+        using common_type = common_memory_unit_t<LhsType, RhsType>;
+        return memory_unit_cast<common_type>(lhs) + memory_unit_cast<common_type>(rhs);
+    }
+
+    /// Returns \a lhs `-` \a rhs as \ref common_memory_unit_t, where the reps of both differ.
+    ///
+    /// \throws std::overflow_error if the converted counts do not fit into the common rep
+    ///         and the overflow policy is \ref checked_overflow.
+    /// \throws std::underflow_error if the result does not fit into the common rep
+    ///         and the overflow policy is \ref checked_overflow.
     template<MemoryUnitType LhsType, MemoryUnitType RhsType>
-        requires std::ratio_greater_equal_v<typename LhsType::ratio, typename RhsType::ratio>
-    constexpr RhsType operator+(const LhsType &lhs, const RhsType &rhs) {
-        auto converted = memory_unit_cast<RhsType>(lhs);
-        return {converted.count(), rhs.count()};
+        requires (not std::is_same_v<typename LhsType::rep, typename RhsType::rep>)
+                 && requires { typename common_memory_unit_t<LhsType, RhsType>; }
+    [[nodiscard]] constexpr common_memory_unit_t<LhsType, RhsType> operator-(const LhsType &lhs, const RhsType &rhs) {
+        using common_type = common_memory_unit_t<LhsType, RhsType>;
+        return memory_unit_cast<common_type>(lhs) - memory_unit_cast<common_type>(rhs);
     }
 
     using bits = memory_unit<std::uint64_t, std::ratio<1, 8> >;
@@ -313,19 +717,91 @@ namespace afs::mem_units {
     using petabytes = memory_unit<std::uint64_t, std::ratio<terabytes::ratio::num * 1'024> >;
     using exabytes = memory_unit<std::uint64_t, std::ratio<petabytes::ratio::num * 1'024> >;
 
+    /// \t MemoryUnit with its overflow policy replaced by \t OverflowPolicy.
+    template<MemoryUnitType MemoryUnit, OverflowPolicyType OverflowPolicy>
+    using with_overflow_policy_t = memory_unit<typename MemoryUnit::rep, typename MemoryUnit::ratio, OverflowPolicy>;
+
+    using saturating_bits = with_overflow_policy_t<bits, saturating_overflow>;
+    using saturating_bytes = with_overflow_policy_t<bytes, saturating_overflow>;
+    using saturating_kilobytes = with_overflow_policy_t<kilobytes, saturating_overflow>;
+    using saturating_megabytes = with_overflow_policy_t<megabytes, saturating_overflow>;
+    using saturating_gigabytes = with_overflow_policy_t<gigabytes, saturating_overflow>;
+    using saturating_terabytes = with_overflow_policy_t<terabytes, saturating_overflow>;
+    using saturating_petabytes = with_overflow_policy_t<petabytes, saturating_overflow>;
+    using saturating_exabytes = with_overflow_policy_t<exabytes, saturating_overflow>;
+
+    using wrapping_bits = with_overflow_policy_t<bits, wrapping_overflow>;
+    using wrapping_bytes = with_overflow_policy_t<bytes, wrapping_overflow>;
+    using wrapping_kilobytes = with_overflow_policy_t<kilobytes, wrapping_overflow>;
+    using wrapping_megabytes = with_overflow_policy_t<megabytes, wrapping_overflow>;
+    using wrapping_gigabytes = with_overflow_policy_t<gigabytes, wrapping_overflow>;
+    using wrapping_terabytes = with_overflow_policy_t<terabytes, wrapping_overflow>;
+    using wrapping_petabytes = with_overflow_policy_t<petabytes, wrapping_overflow>;
+    using wrapping_exabytes = with_overflow_policy_t<exabytes, wrapping_overflow>;
+
+    using unchecked_bits = with_overflow_policy_t<bits, unchecked_overflow>;
+    using unchecked_bytes = with_overflow_policy_t<bytes, unchecked_overflow>;
+    using unchecked_kilobytes = with_overflow_policy_t<kilobytes, unchecked_overflow>;
+    using unchecked_megabytes = with_overflow_policy_t<megabytes, unchecked_overflow>;
+    using unchecked_gigabytes = with_overflow_policy_t<gigabytes, unchecked_overflow>;
+    using unchecked_terabytes = with_overflow_policy_t<terabytes, unchecked_overflow>;
+    using unchecked_petabytes = with_overflow_policy_t<petabytes, unchecked_overflow>;
+    using unchecked_exabytes = with_overflow_policy_t<exabytes, unchecked_overflow>;
+
+    /// \t MemoryUnit with its rep replaced by \t Rep, e.g. to store large tables of sizes more compactly.
+    template<MemoryUnitType MemoryUnit, RepType Rep>
+    using with_rep_t = memory_unit<Rep, typename MemoryUnit::ratio, typename MemoryUnit::overflow_policy>;
+
+    using bits32 = with_rep_t<bits, std::uint32_t>;
+    using bytes32 = with_rep_t<bytes, std::uint32_t>;
+    using kilobytes32 = with_rep_t<kilobytes, std::uint32_t>;
+    using megabytes32 = with_rep_t<megabytes, std::uint32_t>;
+    using gigabytes32 = with_rep_t<gigabytes, std::uint32_t>;
+    using terabytes32 = with_rep_t<terabytes, std::uint32_t>;
+    using petabytes32 = with_rep_t<petabytes, std::uint32_t>;
+    using exabytes32 = with_rep_t<exabytes, std::uint32_t>;
+
+    using bits16 = with_rep_t<bits, std::uint16_t>;
+    using bytes16 = with_rep_t<bytes, std::uint16_t>;
+    using kilobytes16 = with_rep_t<kilobytes, std::uint16_t>;
+    using megabytes16 = with_rep_t<megabytes, std::uint16_t>;
+    using gigabytes16 = with_rep_t<gigabytes, std::uint16_t>;
+    using terabytes16 = with_rep_t<terabytes, std::uint16_t>;
+    using petabytes16 = with_rep_t<petabytes, std::uint16_t>;
+    using exabytes16 = with_rep_t<exabytes, std::uint16_t>;
+
     template<MemoryUnitType MemoryUnit>
     [[nodiscard]] constexpr std::string_view memory_unit_suffix() {
-        if constexpr (std::is_same_v<MemoryUnit, bits>) return "bit";      // bits
-        else if constexpr (std::is_same_v<MemoryUnit, bytes>) return "b";     // bytes
-        else if constexpr (std::is_same_v<MemoryUnit, kilobytes>) return "kb";
-        else if constexpr (std::is_same_v<MemoryUnit, megabytes>) return "mb";
-        else if constexpr (std::is_same_v<MemoryUnit, gigabytes>) return "gb";
-        else if constexpr (std::is_same_v<MemoryUnit, terabytes>) return "tb";
-        else if constexpr (std::is_same_v<MemoryUnit, petabytes>) return "pb";
-        else if constexpr (std::is_same_v<MemoryUnit, exabytes>)  return "eb";
+        if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, bits::ratio>) return "bit";      // bits
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, bytes::ratio>) return "b";     // bytes
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, kilobytes::ratio>) return "kb";
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, megabytes::ratio>) return "mb";
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, gigabytes::ratio>) return "gb";
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, terabytes::ratio>) return "tb";
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, petabytes::ratio>) return "pb";
+        else if constexpr (std::ratio_equal_v<typename MemoryUnit::ratio, exabytes::ratio>)  return "eb";
         else return "?";
     }
 
+    /// Description of a unit with a suffix, see \ref known_units.
+    struct unit_description {
+        std::string_view suffix;
+        std::intmax_t num;
+        std::intmax_t den;
+    };
+
+    /// All units with a suffix, ordered by ratio.
+    inline constexpr std::array<unit_description, 8> known_units{{
+        {memory_unit_suffix<bits>(), bits::ratio::num, bits::ratio::den},
+        {memory_unit_suffix<bytes>(), bytes::ratio::num, bytes::ratio::den},
+        {memory_unit_suffix<kilobytes>(), kilobytes::ratio::num, kilobytes::ratio::den},
+        {memory_unit_suffix<megabytes>(), megabytes::ratio::num, megabytes::ratio::den},
+        {memory_unit_suffix<gigabytes>(), gigabytes::ratio::num, gigabytes::ratio::den},
+        {memory_unit_suffix<terabytes>(), terabytes::ratio::num, terabytes::ratio::den},
+        {memory_unit_suffix<petabytes>(), petabytes::ratio::num, petabytes::ratio::den},
+        {memory_unit_suffix<exabytes>(), exabytes::ratio::num, exabytes::ratio::den},
+    }};
+
     namespace literals {
         constexpr bits operator"" _bit(unsigned long long count) {
             return bits{static_cast<bits::rep>(count)};
@@ -363,11 +839,14 @@ namespace afs::mem_units {
 }
 
 namespace std {
-    template<>
-    struct formatter<afs::mem_units::bits> : formatter<afs::mem_units::bits::rep> {
-        auto format(const afs::mem_units::bits& value, std::format_context& context) const {
-            return std::format("{}{}", value.count(), afs::mem_units::memory_unit_suffix<afs::mem_units::bits>());
-        }
+    /// Common type of two memory units, see \ref afs::mem_units::common_memory_unit.
+    template<afs::mem_units::RepType LhsRep, afs::mem_units::RatioType LhsRatio,
+             afs::mem_units::RepType RhsRep, afs::mem_units::RatioType RhsRatio,
+             afs::mem_units::OverflowPolicyType OverflowPolicy>
+    struct common_type<afs::mem_units::memory_unit<LhsRep, LhsRatio, OverflowPolicy>,
+                       afs::mem_units::memory_unit<RhsRep, RhsRatio, OverflowPolicy>>
+        : afs::mem_units::common_memory_unit<afs::mem_units::memory_unit<LhsRep, LhsRatio, OverflowPolicy>,
+                                             afs::mem_units::memory_unit<RhsRep, RhsRatio, OverflowPolicy>> {
     };
 }
 
@@ -0,0 +1,164 @@
+#ifndef E440BBDB_B166_40EA_A2BA_7E064F0FDB3E
+#define E440BBDB_B166_40EA_A2BA_7E064F0FDB3E
+
+#include "../mem_units.hpp"
+
+#include <bit>
+
+#if defined(_WIN32)
+// keeps <windows.h> from defining the macros min and max, which break std::numeric_limits<T>::max() and std::min
+// in every header included later, and from pulling in rarely used APIs
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define AFS_MEM_UNITS_UNDEF_NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define AFS_MEM_UNITS_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#if defined(AFS_MEM_UNITS_UNDEF_NOMINMAX)
+#undef NOMINMAX
+#undef AFS_MEM_UNITS_UNDEF_NOMINMAX
+#endif
+#if defined(AFS_MEM_UNITS_UNDEF_WIN32_LEAN_AND_MEAN)
+#undef WIN32_LEAN_AND_MEAN
+#undef AFS_MEM_UNITS_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#else
+#include <unistd.h>
+#endif
+
+namespace afs::mem_units {
+    /// Memory units that can be aligned, i.e. with an unsigned integral rep.
+    template<typename T>
+    concept AlignableMemoryUnitType = MemoryUnitType<T> && std::is_unsigned_v<typename T::rep>;
+
+    namespace detail {
+        /// Returns \a alignment converted to \t MemoryUnit, which must not be 0.
+        ///
+        /// \throws std::invalid_argument if \a alignment is 0.
+        /// \throws std::overflow_error if \a alignment does not fit into the rep of \t MemoryUnit and its overflow
+        ///         policy is \ref checked_overflow.
+        template<AlignableMemoryUnitType MemoryUnit, MemoryUnitType Alignment>
+            requires std::ratio_greater_equal_v<typename Alignment::ratio, typename MemoryUnit::ratio>
+        [[nodiscard]] constexpr typename MemoryUnit::rep alignment_count(const Alignment &alignment) {
+            const auto count = memory_unit_cast<MemoryUnit>(alignment).count();
+            if (count == 0) {
+                AFS_MEM_UNITS_THROW(std::invalid_argument("Alignment must not be 0!"));
+            }
+            return count;
+        }
+
+        /// Returns if \a count, which is not 0, is a power of two.
+        ///
+        /// Unlike `std::has_single_bit`, this never calls a population count function of the runtime library.
+        template<std::unsigned_integral Rep>
+        [[nodiscard]] constexpr bool is_power_of_two_count(const Rep count) noexcept {
+            return (count & (count - 1)) == 0;
+        }
+    }
+
+    /// Returns if \a value is a multiple of \a alignment.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(is_aligned(6_mb, 2_mb));
+    /// ~~~~~
+    ///
+    /// \throws std::invalid_argument if \a alignment is 0.
+    template<AlignableMemoryUnitType MemoryUnit, MemoryUnitType Alignment>
+        requires std::ratio_greater_equal_v<typename Alignment::ratio, typename MemoryUnit::ratio>
+    [[nodiscard]] constexpr bool is_aligned(const MemoryUnit &value, const Alignment &alignment) {
+        const auto count = detail::alignment_count<MemoryUnit>(alignment);
+        if (detail::is_power_of_two_count(count)) {
+            return (value.count() & (count - 1)) == 0;
+        }
+        return value.count() % count == 0;
+    }
+
+    /// Returns \a value rounded down to a multiple of \a alignment, which is a mask if it is a power of two.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(align_down(5'000_b, 4_kb) == 4_kb);
+    /// ~~~~~
+    ///
+    /// \throws std::invalid_argument if \a alignment is 0.
+    template<AlignableMemoryUnitType MemoryUnit, MemoryUnitType Alignment>
+        requires std::ratio_greater_equal_v<typename Alignment::ratio, typename MemoryUnit::ratio>
+    [[nodiscard]] constexpr MemoryUnit align_down(const MemoryUnit &value, const Alignment &alignment) {
+        using rep = typename MemoryUnit::rep;
+        const auto count = detail::alignment_count<MemoryUnit>(alignment);
+        if (detail::is_power_of_two_count(count)) {
+            return MemoryUnit{static_cast<rep>(value.count() & ~(count - 1))};
+        }
+        return MemoryUnit{static_cast<rep>(value.count() - value.count() % count)};
+    }
+
+    /// Returns \a value rounded up to a multiple of \a alignment, which is a mask if it is a power of two.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(align_up(5'000_b, 4_kb) == 8_kb);
+    /// ~~~~~
+    ///
+    /// Other than `(value + alignment - 1) & ~(alignment - 1)` this does not overflow for values that are
+    /// aligned already. If the rounded up value does not fit into the rep, it is handled according to the
+    /// overflow policy of \t MemoryUnit, so \ref saturating_overflow returns the maximum of the rep.
+    ///
+    /// \throws std::invalid_argument if \a alignment is 0.
+    /// \throws std::overflow_error if the result does not fit into the rep and the overflow policy is
+    ///         \ref checked_overflow.
+    template<AlignableMemoryUnitType MemoryUnit, MemoryUnitType Alignment>
+        requires std::ratio_greater_equal_v<typename Alignment::ratio, typename MemoryUnit::ratio>
+    [[nodiscard]] constexpr MemoryUnit align_up(const MemoryUnit &value, const Alignment &alignment) {
+        using rep = typename MemoryUnit::rep;
+        using overflow_policy = typename MemoryUnit::overflow_policy;
+        const auto count = detail::alignment_count<MemoryUnit>(alignment);
+        rep remainder;
+        if (detail::is_power_of_two_count(count)) [[likely]] {
+            remainder = static_cast<rep>(value.count() & (count - 1));
+        } else {
+            remainder = static_cast<rep>(value.count() % count);
+        }
+        if (remainder == 0) {
+            return value;
+        }
+        return MemoryUnit{overflow_policy::add(value.count(), static_cast<rep>(count - remainder))};
+    }
+
+    /// Returns how many pages of \a page_size are needed to hold \a value, i.e. \a value divided by
+    /// \a page_size rounded up, which never overflows.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(pages_in(5'000_b, 4_kb) == 2);
+    /// ~~~~~
+    ///
+    /// \throws std::invalid_argument if \a page_size is 0.
+    template<AlignableMemoryUnitType MemoryUnit, MemoryUnitType PageSize>
+        requires std::ratio_greater_equal_v<typename PageSize::ratio, typename MemoryUnit::ratio>
+    [[nodiscard]] constexpr typename MemoryUnit::rep pages_in(const MemoryUnit &value, const PageSize &page_size) {
+        using rep = typename MemoryUnit::rep;
+        const auto count = detail::alignment_count<MemoryUnit>(page_size);
+        if (detail::is_power_of_two_count(count)) {
+            const int shift = std::countr_zero(count);
+            return static_cast<rep>((value.count() >> shift) + ((value.count() & (count - 1)) != 0));
+        }
+        return static_cast<rep>(value.count() / count + (value.count() % count != 0));
+    }
+
+    /// Returns the size of a memory page of the operating system, queried once.
+    [[nodiscard]] inline bytes page_size() noexcept {
+        static const bytes size = [] {
+#if defined(_WIN32)
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return bytes{static_cast<bytes::rep>(info.dwPageSize)};
+#else
+            const long size = sysconf(_SC_PAGESIZE);
+            return bytes{static_cast<bytes::rep>(size > 0 ? size : 4'096)};
+#endif
+        }();
+        return size;
+    }
+}
+
+#endif // E440BBDB_B166_40EA_A2BA_7E064F0FDB3E
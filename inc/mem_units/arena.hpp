@@ -0,0 +1,217 @@
+#ifndef C7AD7D70_5D67_4B41_A506_48A53E8F76C2
+#define C7AD7D70_5D67_4B41_A506_48A53E8F76C2
+
+#include "../mem_units.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace afs::mem_units {
+    /// Count of bytes of \t Amount, which must have a ratio of whole bytes, as `std::size_t`.
+    ///
+    /// Fails to compile if \t Amount does not fit into `std::size_t`.
+    template<MemoryUnitType auto Amount>
+        requires std::ratio_greater_equal_v<typename decltype(Amount)::ratio, std::ratio<1> >
+                 && std::is_integral_v<typename decltype(Amount)::rep>
+    inline constexpr std::size_t byte_count_v = memory_unit_cast<memory_unit<std::size_t, std::ratio<1> > >(Amount).count();
+
+    /// Alignment of allocations from \ref monotonic_arena and \ref block_pool unless given otherwise.
+    inline constexpr bytes default_allocation_alignment{alignof(std::max_align_t)};
+
+    /// \t Size bytes aligned to \t Alignment, allocated once from the heap.
+    template<std::size_t Size, std::size_t Alignment>
+    class fixed_storage {
+        std::byte *_data;
+
+    public:
+        fixed_storage() : _data(static_cast<std::byte *>(::operator new(Size, std::align_val_t{Alignment}))) {}
+
+        ~fixed_storage() { ::operator delete(_data, Size, std::align_val_t{Alignment}); }
+
+        fixed_storage(const fixed_storage &) = delete;
+        fixed_storage& operator=(const fixed_storage &) = delete;
+
+        [[nodiscard]] std::byte* data() const noexcept { return _data; }
+    };
+
+    /// An arena of \t Capacity handing out memory by bumping a pointer and releasing all of it at once.
+    ///
+    /// Capacity and alignment are memory units given as template arguments, so everything derived from them
+    /// is computed at compile time:
+    /// ~~~~~.cpp
+    /// monotonic_arena<64_mb> arena;
+    /// auto *nodes = static_cast<node *>(arena.allocate(1'000 * sizeof(node), alignof(node)));
+    /// ...
+    /// arena.reset();
+    /// ~~~~~
+    ///
+    /// The memory of the arena is allocated once on construction. Allocations are aligned to \t Alignment
+    /// unless given otherwise and are not released individually.
+    template<MemoryUnitType auto Capacity, MemoryUnitType auto Alignment = default_allocation_alignment>
+    class monotonic_arena {
+    public:
+        static constexpr std::size_t capacity_count = byte_count_v<Capacity>;
+        static constexpr std::size_t alignment_count = byte_count_v<Alignment>;
+
+        static_assert(capacity_count > 0, "Capacity must not be 0!");
+        static_assert(std::has_single_bit(alignment_count), "Alignment must be a power of two!");
+
+    private:
+        fixed_storage<capacity_count, std::max(alignment_count, alignof(std::max_align_t))> _storage;
+        std::size_t _used = 0;
+
+    public:
+        monotonic_arena() = default;
+
+        monotonic_arena(const monotonic_arena &) = delete;
+        monotonic_arena& operator=(const monotonic_arena &) = delete;
+
+        /// Return \a size bytes aligned to \a alignment, which must be a power of two, or `nullptr` if the
+        /// arena is exhausted.
+        [[nodiscard]] void* try_allocate(const std::size_t size, const std::size_t alignment = alignment_count) noexcept {
+            const auto base = reinterpret_cast<std::uintptr_t>(_storage.data());
+            const auto begin = ((base + _used + alignment - 1) & ~(alignment - 1)) - base;
+            if (begin > capacity_count || size > capacity_count - begin) [[unlikely]] {
+                return nullptr;
+            }
+            _used = begin + size;
+            return _storage.data() + begin;
+        }
+
+        /// Return \a size bytes aligned to \a alignment, which must be a power of two.
+        ///
+        /// \throws std::bad_alloc if the arena is exhausted.
+        [[nodiscard]] void* allocate(const std::size_t size, const std::size_t alignment = alignment_count) {
+            void *pointer = try_allocate(size, alignment);
+            if (pointer == nullptr) [[unlikely]] {
+                AFS_MEM_UNITS_THROW(std::bad_alloc());
+            }
+            return pointer;
+        }
+
+        /// Release all allocations at once.
+        void reset() noexcept { _used = 0; }
+
+        /// Return if \a pointer lies within the arena.
+        [[nodiscard]] bool owns(const void *pointer) const noexcept {
+            const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+            const auto base = reinterpret_cast<std::uintptr_t>(_storage.data());
+            return address >= base && address < base + capacity_count;
+        }
+
+        [[nodiscard]] static constexpr bytes capacity() noexcept { return bytes{capacity_count}; }
+
+        [[nodiscard]] static constexpr bytes alignment() noexcept { return bytes{alignment_count}; }
+
+        /// Return the amount allocated, including padding for alignment.
+        [[nodiscard]] bytes used() const noexcept { return bytes{_used}; }
+
+        /// Return the amount left, not considering padding for alignment.
+        [[nodiscard]] bytes remaining() const noexcept { return bytes{capacity_count - _used}; }
+    };
+
+    /// A pool of \t Capacity split into blocks of \t BlockSize, handing out and taking back single blocks.
+    ///
+    /// Free blocks are kept in an intrusive list, so allocating and deallocating is popping and pushing
+    /// a pointer. Block size, block count and alignment are computed at compile time:
+    /// ~~~~~.cpp
+    /// block_pool<256_b, 16_mb> pool;
+    /// static_assert(pool.block_count == 65'536);
+    /// void *block = pool.allocate();
+    /// pool.deallocate(block);
+    /// ~~~~~
+    ///
+    /// \t BlockSize is rounded up to a multiple of \t Alignment and at least the size of a pointer. The memory
+    /// of the pool is allocated once on construction, but blocks are only touched when first handed out.
+    template<MemoryUnitType auto BlockSize, MemoryUnitType auto Capacity,
+             MemoryUnitType auto Alignment = default_allocation_alignment>
+    class block_pool {
+    public:
+        static constexpr std::size_t alignment_count = std::max(byte_count_v<Alignment>, alignof(void *));
+        static constexpr std::size_t block_size_count =
+            (std::max(byte_count_v<BlockSize>, sizeof(void *)) + alignment_count - 1) / alignment_count * alignment_count;
+        static constexpr std::size_t block_count = byte_count_v<Capacity> / block_size_count;
+
+        static_assert(std::has_single_bit(alignment_count), "Alignment must be a power of two!");
+        static_assert(block_count > 0, "Capacity must hold at least one block!");
+
+    private:
+        struct free_block {
+            free_block *next;
+        };
+
+        fixed_storage<block_count * block_size_count, std::max(alignment_count, alignof(std::max_align_t))> _storage;
+        free_block *_free = nullptr;
+        // blocks never handed out since construction or reset, which are not in the free list
+        std::size_t _untouched = 0;
+        std::size_t _used = 0;
+
+    public:
+        block_pool() = default;
+
+        block_pool(const block_pool &) = delete;
+        block_pool& operator=(const block_pool &) = delete;
+
+        /// Return a block, or `nullptr` if all blocks are in use.
+        [[nodiscard]] void* try_allocate() noexcept {
+            if (_free != nullptr) [[likely]] {
+                free_block *block = _free;
+                _free = block->next;
+                ++_used;
+                return block;
+            }
+            if (_untouched < block_count) {
+                ++_used;
+                return _storage.data() + _untouched++ * block_size_count;
+            }
+            return nullptr;
+        }
+
+        /// Return a block.
+        ///
+        /// \throws std::bad_alloc if all blocks are in use.
+        [[nodiscard]] void* allocate() {
+            void *pointer = try_allocate();
+            if (pointer == nullptr) [[unlikely]] {
+                AFS_MEM_UNITS_THROW(std::bad_alloc());
+            }
+            return pointer;
+        }
+
+        /// Give back \a block, which must have been returned by \ref allocate of this pool.
+        void deallocate(void *block) noexcept {
+            _free = ::new (block) free_block{_free};
+            --_used;
+        }
+
+        /// Give back all blocks at once.
+        void reset() noexcept {
+            _free = nullptr;
+            _untouched = 0;
+            _used = 0;
+        }
+
+        /// Return if \a pointer lies within the pool.
+        [[nodiscard]] bool owns(const void *pointer) const noexcept {
+            const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+            const auto base = reinterpret_cast<std::uintptr_t>(_storage.data());
+            return address >= base && address < base + block_count * block_size_count;
+        }
+
+        [[nodiscard]] static constexpr bytes block_size() noexcept { return bytes{block_size_count}; }
+
+        [[nodiscard]] static constexpr bytes capacity() noexcept { return bytes{block_count * block_size_count}; }
+
+        [[nodiscard]] static constexpr bytes alignment() noexcept { return bytes{alignment_count}; }
+
+        /// Return the amount of all blocks in use.
+        [[nodiscard]] bytes used() const noexcept { return bytes{_used * block_size_count}; }
+
+        /// Return the amount of all blocks not in use.
+        [[nodiscard]] bytes remaining() const noexcept { return bytes{(block_count - _used) * block_size_count}; }
+    };
+}
+
+#endif // C7AD7D70_5D67_4B41_A506_48A53E8F76C2
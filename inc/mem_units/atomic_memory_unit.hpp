@@ -0,0 +1,169 @@
+#ifndef B7DF27FA_488D_4603_AB20_242BC68B744E
+#define B7DF27FA_488D_4603_AB20_242BC68B744E
+
+#include "../mem_units.hpp"
+
+#include <atomic>
+
+namespace afs::mem_units {
+    /// A \t MemoryUnit that can be read and modified concurrently, like `std::atomic<MemoryUnit::rep>`.
+    ///
+    /// All modifying functions accept memory units with the same or a greater ratio, following the same
+    /// widening rules as the constructor of \ref memory_unit:
+    /// ~~~~~.cpp
+    /// atomic_memory_unit<bytes> live;
+    /// live.fetch_add(4_kb);
+    /// live.fetch_sub(1_kb);
+    /// assert(live.load() == 3_kb);
+    /// ~~~~~
+    ///
+    /// Over- and underflows are handled like by `operator+=` of \t MemoryUnit, i.e. according to its
+    /// \ref memory_unit::overflow_policy. With \ref checked_overflow the stored value stays unchanged if an
+    /// exception is thrown.
+    template<MemoryUnitType MemoryUnit>
+    class atomic_memory_unit {
+    public:
+        using value_type = MemoryUnit;
+        using rep = typename MemoryUnit::rep;
+        using ratio = typename MemoryUnit::ratio;
+        using overflow_policy = typename MemoryUnit::overflow_policy;
+
+        static constexpr bool is_always_lock_free = std::atomic<rep>::is_always_lock_free;
+
+        static_assert(sizeof(rep) != sizeof(std::uint64_t) || is_always_lock_free,
+                      "atomic_memory_unit has to be lock free for 64 bit reps");
+
+    private:
+        /// If the overflow policy is satisfied by the modulo arithmetic of `std::atomic::fetch_add`.
+        static constexpr bool wraps_around = std::is_same_v<overflow_policy, wrapping_overflow>
+                                             || std::is_same_v<overflow_policy, unchecked_overflow>;
+
+        std::atomic<rep> _count{0};
+
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+        [[nodiscard]] static constexpr rep converted_count(const memory_unit<rep, OtherRatio, OtherPolicy> &value) {
+            return memory_unit_cast<value_type>(value).count();
+        }
+
+    public:
+        constexpr atomic_memory_unit() noexcept = default;
+
+        /// Construct with \a desired, which may have the same or a greater ratio than \t MemoryUnit.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        explicit constexpr atomic_memory_unit(const memory_unit<rep, OtherRatio, OtherPolicy> &desired)
+            : _count(converted_count(desired)) {}
+
+        atomic_memory_unit(const atomic_memory_unit &) = delete;
+        atomic_memory_unit& operator=(const atomic_memory_unit &) = delete;
+
+        [[nodiscard]] bool is_lock_free() const noexcept { return _count.is_lock_free(); }
+
+        /// Return the current value.
+        [[nodiscard]] value_type load(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+            return value_type{_count.load(order)};
+        }
+
+        /// Replace the current value by \a desired.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        void store(const memory_unit<rep, OtherRatio, OtherPolicy> &desired,
+                   const std::memory_order order = std::memory_order_seq_cst) {
+            _count.store(converted_count(desired), order);
+        }
+
+        /// Replace the current value by \a desired and return the previous one.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        value_type exchange(const memory_unit<rep, OtherRatio, OtherPolicy> &desired,
+                            const std::memory_order order = std::memory_order_seq_cst) {
+            return value_type{_count.exchange(converted_count(desired), order)};
+        }
+
+        /// Atomically add \a value and return the previous value.
+        ///
+        /// \throws std::overflow_error if the sum does not fit into \ref rep and the overflow policy is
+        ///         \ref checked_overflow. The stored value is not modified then.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        value_type fetch_add(const memory_unit<rep, OtherRatio, OtherPolicy> &value,
+                             const std::memory_order order = std::memory_order_seq_cst) {
+            const rep addend = converted_count(value);
+            if constexpr (wraps_around) {
+                return value_type{_count.fetch_add(addend, order)};
+            } else {
+                rep expected = _count.load(std::memory_order_relaxed);
+                while (not _count.compare_exchange_weak(expected, overflow_policy::add(expected, addend),
+                                                        order, std::memory_order_relaxed)) {
+                }
+                return value_type{expected};
+            }
+        }
+
+        /// Atomically subtract \a value and return the previous value.
+        ///
+        /// \throws std::underflow_error if the difference does not fit into \ref rep and the overflow policy is
+        ///         \ref checked_overflow. The stored value is not modified then.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        value_type fetch_sub(const memory_unit<rep, OtherRatio, OtherPolicy> &value,
+                             const std::memory_order order = std::memory_order_seq_cst) {
+            const rep subtrahend = converted_count(value);
+            if constexpr (wraps_around) {
+                return value_type{_count.fetch_sub(subtrahend, order)};
+            } else {
+                rep expected = _count.load(std::memory_order_relaxed);
+                while (not _count.compare_exchange_weak(expected, overflow_policy::subtract(expected, subtrahend),
+                                                        order, std::memory_order_relaxed)) {
+                }
+                return value_type{expected};
+            }
+        }
+
+        /// Replace the current value by \a desired if it equals \a expected, otherwise load it into \a expected.
+        ///
+        /// May fail spuriously, see `std::atomic::compare_exchange_weak`.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        bool compare_exchange_weak(value_type &expected, const memory_unit<rep, OtherRatio, OtherPolicy> &desired,
+                                   const std::memory_order success = std::memory_order_seq_cst,
+                                   const std::memory_order failure = std::memory_order_seq_cst) {
+            rep expected_count = expected.count();
+            const bool exchanged = _count.compare_exchange_weak(expected_count, converted_count(desired), success, failure);
+            expected = value_type{expected_count};
+            return exchanged;
+        }
+
+        /// Replace the current value by \a desired if it equals \a expected, otherwise load it into \a expected.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        bool compare_exchange_strong(value_type &expected, const memory_unit<rep, OtherRatio, OtherPolicy> &desired,
+                                     const std::memory_order success = std::memory_order_seq_cst,
+                                     const std::memory_order failure = std::memory_order_seq_cst) {
+            rep expected_count = expected.count();
+            const bool exchanged = _count.compare_exchange_strong(expected_count, converted_count(desired), success, failure);
+            expected = value_type{expected_count};
+            return exchanged;
+        }
+
+        /// Atomically add \a value and return the new value, see \ref fetch_add.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        value_type operator+=(const memory_unit<rep, OtherRatio, OtherPolicy> &value) {
+            const value_type converted{converted_count(value)};
+            return fetch_add(converted) + converted;
+        }
+
+        /// Atomically subtract \a value and return the new value, see \ref fetch_sub.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        value_type operator-=(const memory_unit<rep, OtherRatio, OtherPolicy> &value) {
+            const value_type converted{converted_count(value)};
+            return fetch_sub(converted) - converted;
+        }
+
+        operator value_type() const noexcept { return load(); }
+    };
+}
+
+#endif // B7DF27FA_488D_4603_AB20_242BC68B744E
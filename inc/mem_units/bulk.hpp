@@ -0,0 +1,367 @@
+#ifndef B0A96334_F146_48C3_9298_0B6C5F09D235
+#define B0A96334_F146_48C3_9298_0B6C5F09D235
+
+#include "../mem_units.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Kernels over spans of memory units, which do not check every single element for overflow but once per span.
+//
+// The loops over the counts are written branch free, so compilers can vectorize them. For spans of
+// `std::uint64_t` counts there are explicit AVX-512 and AVX2 implementations, chosen at compile time when
+// building with `-mavx512f` or `-mavx2` (e.g. via `-march=native`).
+
+namespace afs::mem_units {
+    /// Memory units whose counts can be processed in bulk, i.e. as a contiguous array of their unsigned rep.
+    template<typename T>
+    concept BulkMemoryUnitType = MemoryUnitType<T>
+                                 && std::is_unsigned_v<typename T::rep>
+                                 && std::is_standard_layout_v<T>
+                                 && sizeof(T) == sizeof(typename T::rep);
+
+    namespace kernels {
+        /// Returns the sum of \a size \a counts modulo the range of \t Rep, and in \a carries how often it wrapped.
+        ///
+        /// \a carries is a `std::size_t` whatever \t Rep is, as the sum of \a size counts wraps less than \a size times.
+        template<typename Rep>
+        [[nodiscard]] inline Rep sum(const Rep *counts, const std::size_t size, std::size_t &carries) noexcept {
+            std::size_t index = 0;
+            Rep total = 0;
+            carries = 0;
+            if constexpr (std::is_same_v<Rep, std::uint64_t>) {
+#if defined(__AVX512F__)
+                __m512i lane_totals = _mm512_setzero_si512();
+                __m512i lane_carries = _mm512_setzero_si512();
+                const __m512i one = _mm512_set1_epi64(1);
+                for (; index + 8 <= size; index += 8) {
+                    const __m512i values = _mm512_loadu_si512(counts + index);
+                    lane_totals = _mm512_add_epi64(lane_totals, values);
+                    const __mmask8 wrapped = _mm512_cmplt_epu64_mask(lane_totals, values);
+                    lane_carries = _mm512_mask_add_epi64(lane_carries, wrapped, lane_carries, one);
+                }
+                alignas(64) std::array<std::uint64_t, 8> totals{};
+                alignas(64) std::array<std::uint64_t, 8> lanes_wrapped{};
+                _mm512_store_si512(totals.data(), lane_totals);
+                _mm512_store_si512(lanes_wrapped.data(), lane_carries);
+#elif defined(__AVX2__)
+                __m256i lane_totals = _mm256_setzero_si256();
+                __m256i lane_carries = _mm256_setzero_si256();
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                for (; index + 4 <= size; index += 4) {
+                    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + index));
+                    lane_totals = _mm256_add_epi64(lane_totals, values);
+                    // unsigned total < value, compared signed with flipped sign bits; true lanes are -1
+                    const __m256i wrapped = _mm256_cmpgt_epi64(_mm256_xor_si256(values, sign),
+                                                               _mm256_xor_si256(lane_totals, sign));
+                    lane_carries = _mm256_sub_epi64(lane_carries, wrapped);
+                }
+                alignas(32) std::array<std::uint64_t, 4> totals{};
+                alignas(32) std::array<std::uint64_t, 4> lanes_wrapped{};
+                _mm256_store_si256(reinterpret_cast<__m256i *>(totals.data()), lane_totals);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(lanes_wrapped.data()), lane_carries);
+#else
+                constexpr std::array<std::uint64_t, 0> totals{};
+                constexpr std::array<std::uint64_t, 0> lanes_wrapped{};
+#endif
+                for (std::size_t lane = 0; lane < totals.size(); ++lane) {
+                    total += totals[lane];
+                    carries += lanes_wrapped[lane] + (total < totals[lane]);
+                }
+            }
+            for (; index < size; ++index) {
+                total = static_cast<Rep>(total + counts[index]);
+                carries += total < counts[index];
+            }
+            return total;
+        }
+
+        /// Returns how many of \a size \a counts are greater than \a threshold.
+        template<typename Rep>
+        [[nodiscard]] inline std::size_t count_greater(const Rep *counts, const std::size_t size, const Rep threshold) noexcept {
+            std::size_t index = 0;
+            std::size_t greater = 0;
+            if constexpr (std::is_same_v<Rep, std::uint64_t>) {
+#if defined(__AVX512F__)
+                const __m512i thresholds = _mm512_set1_epi64(static_cast<long long>(threshold));
+                for (; index + 8 <= size; index += 8) {
+                    const __m512i values = _mm512_loadu_si512(counts + index);
+                    greater += static_cast<std::size_t>(std::popcount(
+                        static_cast<unsigned>(_mm512_cmpgt_epu64_mask(values, thresholds))));
+                }
+#elif defined(__AVX2__)
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                const __m256i thresholds = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(threshold)), sign);
+                __m256i lane_greater = _mm256_setzero_si256();
+                for (; index + 4 <= size; index += 4) {
+                    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + index));
+                    lane_greater = _mm256_sub_epi64(lane_greater,
+                                                    _mm256_cmpgt_epi64(_mm256_xor_si256(values, sign), thresholds));
+                }
+                alignas(32) std::array<std::uint64_t, 4> lanes{};
+                _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), lane_greater);
+                greater += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+            }
+            for (; index < size; ++index) {
+                greater += counts[index] > threshold;
+            }
+            return greater;
+        }
+
+        /// Returns the smallest of \a size > 0 \a counts.
+        template<typename Rep>
+        [[nodiscard]] inline Rep min(const Rep *counts, const std::size_t size) noexcept {
+            std::size_t index = 0;
+            Rep smallest = std::numeric_limits<Rep>::max();
+            if constexpr (std::is_same_v<Rep, std::uint64_t>) {
+#if defined(__AVX512F__)
+                __m512i lane_smallest = _mm512_set1_epi64(-1);
+                for (; index + 8 <= size; index += 8) {
+                    lane_smallest = _mm512_min_epu64(lane_smallest, _mm512_loadu_si512(counts + index));
+                }
+                smallest = _mm512_reduce_min_epu64(lane_smallest);
+#elif defined(__AVX2__)
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                __m256i lane_smallest = _mm256_set1_epi64x(-1);
+                for (; index + 4 <= size; index += 4) {
+                    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + index));
+                    const __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(lane_smallest, sign),
+                                                               _mm256_xor_si256(values, sign));
+                    lane_smallest = _mm256_blendv_epi8(lane_smallest, values, greater);
+                }
+                alignas(32) std::array<std::uint64_t, 4> lanes{};
+                _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), lane_smallest);
+                smallest = std::ranges::min(lanes);
+#endif
+            }
+            for (; index < size; ++index) {
+                smallest = counts[index] < smallest ? counts[index] : smallest;
+            }
+            return smallest;
+        }
+
+        /// Returns the greatest of \a size > 0 \a counts.
+        template<typename Rep>
+        [[nodiscard]] inline Rep max(const Rep *counts, const std::size_t size) noexcept {
+            std::size_t index = 0;
+            Rep greatest = 0;
+            if constexpr (std::is_same_v<Rep, std::uint64_t>) {
+#if defined(__AVX512F__)
+                __m512i lane_greatest = _mm512_setzero_si512();
+                for (; index + 8 <= size; index += 8) {
+                    lane_greatest = _mm512_max_epu64(lane_greatest, _mm512_loadu_si512(counts + index));
+                }
+                greatest = _mm512_reduce_max_epu64(lane_greatest);
+#elif defined(__AVX2__)
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                __m256i lane_greatest = _mm256_setzero_si256();
+                for (; index + 4 <= size; index += 4) {
+                    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + index));
+                    const __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(values, sign),
+                                                               _mm256_xor_si256(lane_greatest, sign));
+                    lane_greatest = _mm256_blendv_epi8(lane_greatest, values, greater);
+                }
+                alignas(32) std::array<std::uint64_t, 4> lanes{};
+                _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), lane_greatest);
+                greatest = std::ranges::max(lanes);
+#endif
+            }
+            for (; index < size; ++index) {
+                greatest = counts[index] > greatest ? counts[index] : greatest;
+            }
+            return greatest;
+        }
+
+        /// Writes \a size \a counts `<<` \t Shift to \a converted, returning if any of them was greater than
+        /// \a threshold, i.e. overflowed.
+        template<int Shift, typename Rep>
+        [[nodiscard]] inline bool shift_left(const Rep *counts, Rep *converted, const std::size_t size, const Rep threshold) noexcept {
+            std::size_t index = 0;
+            bool overflow = false;
+            if constexpr (std::is_same_v<Rep, std::uint64_t>) {
+#if defined(__AVX512F__)
+                const __m512i thresholds = _mm512_set1_epi64(static_cast<long long>(threshold));
+                __mmask8 lanes_overflow = 0;
+                for (; index + 8 <= size; index += 8) {
+                    const __m512i values = _mm512_loadu_si512(counts + index);
+                    lanes_overflow |= _mm512_cmpgt_epu64_mask(values, thresholds);
+                    _mm512_storeu_si512(converted + index, _mm512_slli_epi64(values, Shift));
+                }
+                overflow = lanes_overflow != 0;
+#elif defined(__AVX2__)
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                const __m256i thresholds = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(threshold)), sign);
+                __m256i lanes_overflow = _mm256_setzero_si256();
+                for (; index + 4 <= size; index += 4) {
+                    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + index));
+                    lanes_overflow = _mm256_or_si256(lanes_overflow,
+                                                     _mm256_cmpgt_epi64(_mm256_xor_si256(values, sign), thresholds));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(converted + index), _mm256_slli_epi64(values, Shift));
+                }
+                overflow = not _mm256_testz_si256(lanes_overflow, lanes_overflow);
+#endif
+            }
+            for (; index < size; ++index) {
+                overflow |= counts[index] > threshold;
+                converted[index] = static_cast<Rep>(counts[index] << Shift);
+            }
+            return overflow;
+        }
+
+        /// Writes \a size \a counts `>>` \t Shift to \a converted.
+        template<int Shift, typename Rep>
+        inline void shift_right(const Rep *counts, Rep *converted, const std::size_t size) noexcept {
+            std::size_t index = 0;
+            if constexpr (std::is_same_v<Rep, std::uint64_t>) {
+#if defined(__AVX512F__)
+                for (; index + 8 <= size; index += 8) {
+                    _mm512_storeu_si512(converted + index, _mm512_srli_epi64(_mm512_loadu_si512(counts + index), Shift));
+                }
+#elif defined(__AVX2__)
+                for (; index + 4 <= size; index += 4) {
+                    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + index));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(converted + index), _mm256_srli_epi64(values, Shift));
+                }
+#endif
+            }
+            for (; index < size; ++index) {
+                converted[index] = static_cast<Rep>(counts[index] >> Shift);
+            }
+        }
+    }
+
+    /// Returns the counts of \a units as contiguous array of their rep.
+    template<BulkMemoryUnitType MemoryUnit>
+    [[nodiscard]] const typename MemoryUnit::rep* counts_of(const std::span<const MemoryUnit> units) noexcept {
+        return reinterpret_cast<const typename MemoryUnit::rep *>(units.data());
+    }
+
+    /// Returns the counts of \a units as contiguous array of their rep.
+    template<BulkMemoryUnitType MemoryUnit>
+    [[nodiscard]] typename MemoryUnit::rep* counts_of(const std::span<MemoryUnit> units) noexcept {
+        return reinterpret_cast<typename MemoryUnit::rep *>(units.data());
+    }
+
+    /// Returns the sum of all \a units.
+    ///
+    /// Overflow is detected once for the whole span and handled according to the overflow policy of
+    /// \t MemoryUnit: \ref saturating_overflow returns the maximum, \ref wrapping_overflow and
+    /// \ref unchecked_overflow the sum modulo the range of the rep.
+    ///
+    /// \throws std::overflow_error if the sum does not fit into the rep and the overflow policy is
+    ///         \ref checked_overflow.
+    template<BulkMemoryUnitType MemoryUnit>
+    [[nodiscard]] MemoryUnit sum(const std::span<const MemoryUnit> units) {
+        using rep = typename MemoryUnit::rep;
+        using overflow_policy = typename MemoryUnit::overflow_policy;
+        std::size_t carries = 0;
+        const rep total = kernels::sum(counts_of(units), units.size(), carries);
+        if (carries != 0) {
+            if constexpr (std::is_same_v<overflow_policy, checked_overflow>) {
+                AFS_MEM_UNITS_THROW(std::overflow_error("Addition would cause an overflow!"));
+            } else if constexpr (std::is_same_v<overflow_policy, saturating_overflow>) {
+                return MemoryUnit{std::numeric_limits<rep>::max()};
+            }
+        }
+        return MemoryUnit{total};
+    }
+
+    /// Writes all \a units converted to \t ToType into \a converted, like \ref memory_unit_cast does for each.
+    ///
+    /// Conversions between power of two ratios are shifts. Overflow is detected once for the whole span and
+    /// handled according to the overflow policy of \t ToType.
+    ///
+    /// \throws std::invalid_argument if \a converted is smaller than \a units.
+    /// \throws std::overflow_error if any converted count does not fit into the rep and the overflow policy is
+    ///         \ref checked_overflow. The content of \a converted is unspecified then.
+    template<BulkMemoryUnitType ToType, BulkMemoryUnitType FromType>
+        requires std::is_same_v<typename ToType::rep, typename FromType::rep>
+    void convert(const std::span<const FromType> units, const std::span<ToType> converted) {
+        using rep = typename ToType::rep;
+        using overflow_policy = typename ToType::overflow_policy;
+        using conversion = std::ratio_divide<typename FromType::ratio, typename ToType::ratio>;
+        if (converted.size() < units.size()) {
+            AFS_MEM_UNITS_THROW(std::invalid_argument("Span of converted memory units is too small!"));
+        }
+        const rep *counts = counts_of(units);
+        rep *converted_counts = counts_of(converted);
+        bool overflow = false;
+        if constexpr (conversion::den == 1 && detail::is_power_of_two(conversion::num)
+                      && std::countr_zero(static_cast<std::uintmax_t>(conversion::num)) < std::numeric_limits<rep>::digits) {
+            constexpr int shift = std::countr_zero(static_cast<std::uintmax_t>(conversion::num));
+            overflow = kernels::shift_left<shift>(counts, converted_counts, units.size(),
+                                                  detail::multiplication_threshold<rep, conversion::num>);
+        } else if constexpr (conversion::num == 1 && detail::is_power_of_two(conversion::den)
+                             && std::countr_zero(static_cast<std::uintmax_t>(conversion::den)) < std::numeric_limits<rep>::digits) {
+            constexpr int shift = std::countr_zero(static_cast<std::uintmax_t>(conversion::den));
+            kernels::shift_right<shift>(counts, converted_counts, units.size());
+        } else {
+            for (std::size_t index = 0; index < units.size(); ++index) {
+                overflow |= wouldMultiplicationOverflow<conversion::num>(counts[index]);
+                converted_counts[index] = detail::scale_down<conversion::den>(detail::scale_up<conversion::num>(counts[index]));
+            }
+        }
+        if (overflow) {
+            if constexpr (std::is_same_v<overflow_policy, checked_overflow>) {
+                AFS_MEM_UNITS_THROW(std::overflow_error("Conversion would cause an overflow!"));
+            } else if constexpr (not std::is_same_v<overflow_policy, wrapping_overflow>
+                                 && not std::is_same_v<overflow_policy, unchecked_overflow>) {
+                for (std::size_t index = 0; index < units.size(); ++index) {
+                    converted[index] = memory_unit_cast<ToType>(units[index]);
+                }
+            }
+        }
+    }
+
+    /// Returns how many of \a units are greater than \a threshold, compared exactly and without overflow.
+    ///
+    /// \t Threshold may have another ratio, as long as one of both ratios is a multiple of the other.
+    template<BulkMemoryUnitType MemoryUnit, BulkMemoryUnitType Threshold>
+        requires std::is_same_v<typename MemoryUnit::rep, typename Threshold::rep>
+                 && (std::ratio_divide<typename Threshold::ratio, typename MemoryUnit::ratio>::num == 1
+                     || std::ratio_divide<typename Threshold::ratio, typename MemoryUnit::ratio>::den == 1)
+    [[nodiscard]] std::size_t count_greater(const std::span<const MemoryUnit> units, const Threshold &threshold) noexcept {
+        using conversion = std::ratio_divide<typename Threshold::ratio, typename MemoryUnit::ratio>;
+        // with k = conversion::den, count * k > threshold <=> count > floor(threshold / k)
+        typename MemoryUnit::rep converted = detail::scale_down<conversion::den>(threshold.count());
+        if constexpr (conversion::num != 1) {
+            if (wouldMultiplicationOverflow<conversion::num>(threshold.count())) {
+                return 0;
+            }
+            converted = detail::scale_up<conversion::num>(threshold.count());
+        }
+        return kernels::count_greater(counts_of(units), units.size(), converted);
+    }
+
+    /// Returns the smallest of \a units.
+    ///
+    /// \throws std::invalid_argument if \a units is empty.
+    template<BulkMemoryUnitType MemoryUnit>
+    [[nodiscard]] MemoryUnit min(const std::span<const MemoryUnit> units) {
+        if (units.empty()) {
+            AFS_MEM_UNITS_THROW(std::invalid_argument("Minimum of no memory units is undefined!"));
+        }
+        return MemoryUnit{kernels::min(counts_of(units), units.size())};
+    }
+
+    /// Returns the greatest of \a units.
+    ///
+    /// \throws std::invalid_argument if \a units is empty.
+    template<BulkMemoryUnitType MemoryUnit>
+    [[nodiscard]] MemoryUnit max(const std::span<const MemoryUnit> units) {
+        if (units.empty()) {
+            AFS_MEM_UNITS_THROW(std::invalid_argument("Maximum of no memory units is undefined!"));
+        }
+        return MemoryUnit{kernels::max(counts_of(units), units.size())};
+    }
+}
+
+#endif // B0A96334_F146_48C3_9298_0B6C5F09D235
@@ -0,0 +1,300 @@
+#ifndef BB9B600E_54AA_4D54_9E27_9D657BAAFE2F
+#define BB9B600E_54AA_4D54_9E27_9D657BAAFE2F
+
+#include "byte_size.hpp"
+#include "memory_budget.hpp"
+#include "sharded_memory_counter.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <stdexcept>
+
+namespace afs::mem_units {
+    /// What \ref byte_bounded_queue::push does if an item does not fit into the queue.
+    enum class backpressure {
+        /// Return `false` right away.
+        fail,
+        /// Busy wait, yielding to other threads, until it fits.
+        spin,
+        /// Busy wait briefly, then sleep until a consumer made room.
+        block,
+    };
+
+    /// A multi-producer multi-consumer queue bounded by the amount of memory its items take up, not by their
+    /// number.
+    ///
+    /// Items are sized by a function given on construction, by default \ref default_byte_size:
+    /// ~~~~~.cpp
+    /// byte_bounded_queue<message> ingest{256_mb, [](const message &m) { return bytes{m.payload.size()}; }};
+    ///
+    /// ingest.push(std::move(received));  // blocks while 256mb are queued
+    /// while (auto next = ingest.pop()) {
+    ///     handle(*next);
+    /// }
+    /// ~~~~~
+    ///
+    /// The queued amount is accounted by a \ref memory_budget and the items are kept in a ring of slots with
+    /// a sequence number each, so pushing and popping is lock free as long as nobody has to wait. Producers
+    /// and consumers that wait are counted, so nobody is notified unless somebody sleeps. Besides the
+    /// capacity in bytes the queue holds at most \ref slot_count items.
+    template<typename T>
+    class byte_bounded_queue {
+    public:
+        using value_type = T;
+        using size_function = std::function<bytes(const T &)>;
+
+        /// Default number of items the queue holds at most.
+        static constexpr std::size_t default_slot_count = 65'536;
+
+    private:
+        // busy waiting iterations before sleeping, see backpressure::block
+        static constexpr int spin_limit = 64;
+
+        struct slot {
+            std::atomic<std::size_t> sequence;
+            bytes size;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            [[nodiscard]] T* item() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+        };
+
+        memory_budget _budget;
+        size_function _size;
+        backpressure _backpressure;
+        std::size_t _mask;
+        std::unique_ptr<slot[]> _slots;
+        alignas(cache_line_size) std::atomic<std::size_t> _tail{0};
+        alignas(cache_line_size) std::atomic<std::size_t> _head{0};
+        alignas(cache_line_size) std::atomic<std::uint64_t> _peak{0};
+        alignas(cache_line_size) std::atomic<std::uint32_t> _popped{0};
+        std::atomic<std::uint32_t> _waiting_producers{0};
+        alignas(cache_line_size) std::atomic<std::uint32_t> _pushed{0};
+        std::atomic<std::uint32_t> _waiting_consumers{0};
+        std::atomic<bool> _closed{false};
+
+        /// Claim a slot for \a value of \a size and move it there, which leaves \a value untouched on failure.
+        [[nodiscard]] bool try_emplace(T &value, const bytes size) {
+            if (not _budget.try_reserve(size)) {
+                return false;
+            }
+            std::size_t position = _tail.load(std::memory_order_relaxed);
+            slot *claimed = nullptr;
+            while (true) {
+                claimed = &_slots[position & _mask];
+                const auto sequence = claimed->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+                if (difference == 0) {
+                    if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    // all slots are taken
+                    _budget.release(size);
+                    return false;
+                } else {
+                    position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+            try {
+                ::new (claimed->storage) T(std::move(value));
+            } catch (...) {
+                // the slot is claimed already, so it is handed to consumers as empty
+                claimed->size = bytes{std::numeric_limits<bytes::rep>::max()};
+                claimed->sequence.store(position + 1, std::memory_order_release);
+                _budget.release(size);
+                throw;
+            }
+            claimed->size = size;
+            claimed->sequence.store(position + 1, std::memory_order_release);
+
+            const auto queued = _budget.used().count();
+            auto peak = _peak.load(std::memory_order_relaxed);
+            while (queued > peak && not _peak.compare_exchange_weak(peak, queued, std::memory_order_relaxed)) {
+            }
+            wake(_pushed, _waiting_consumers);
+            return true;
+        }
+
+        /// Take the oldest item out of its slot, or return `std::nullopt` if there is none.
+        [[nodiscard]] std::optional<T> try_take() {
+            while (true) {
+                std::size_t position = _head.load(std::memory_order_relaxed);
+                slot *claimed = nullptr;
+                while (true) {
+                    claimed = &_slots[position & _mask];
+                    const auto sequence = claimed->sequence.load(std::memory_order_acquire);
+                    const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                    if (difference == 0) {
+                        if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if (difference < 0) {
+                        return std::nullopt;
+                    } else {
+                        position = _head.load(std::memory_order_relaxed);
+                    }
+                }
+                const bytes size = claimed->size;
+                if (size.count() == std::numeric_limits<bytes::rep>::max()) {
+                    // left empty by a throwing move constructor
+                    claimed->sequence.store(position + _mask + 1, std::memory_order_release);
+                    continue;
+                }
+                std::optional<T> item(std::move(*claimed->item()));
+                claimed->item()->~T();
+                claimed->sequence.store(position + _mask + 1, std::memory_order_release);
+                _budget.release(size);
+                wake(_popped, _waiting_producers);
+                return item;
+            }
+        }
+
+        /// Tell the threads counted by \a waiting that \a event happened, if there are any.
+        static void wake(std::atomic<std::uint32_t> &event, std::atomic<std::uint32_t> &waiting) noexcept {
+            // orders making room or adding an item before reading waiting, see wait_for
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+                event.fetch_add(1, std::memory_order_relaxed);
+                event.notify_all();
+            }
+        }
+
+        /// Call \a attempt until it succeeds, the queue is closed or, if \a sleep, sleep in between on
+        /// \a event, counted by \a waiting.
+        template<typename Attempt>
+        bool wait_for(std::atomic<std::uint32_t> &event, std::atomic<std::uint32_t> &waiting, const bool sleep,
+                      Attempt attempt) {
+            for (int spin = 0; ; ++spin) {
+                if (attempt()) {
+                    return true;
+                }
+                if (closed()) {
+                    return attempt();
+                }
+                if (not sleep || spin < spin_limit) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const auto seen = event.load(std::memory_order_acquire);
+                waiting.fetch_add(1, std::memory_order_relaxed);
+                // orders counting this thread before checking again, see wake
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const bool done = attempt();
+                if (not done && not closed()) {
+                    event.wait(seen, std::memory_order_relaxed);
+                }
+                waiting.fetch_sub(1, std::memory_order_relaxed);
+                if (done) {
+                    return true;
+                }
+            }
+        }
+
+    public:
+        /// Construct holding up to \a capacity, sizing items by \a size, handling a full queue according to
+        /// \a policy and holding up to \a slot_count items (rounded up to a power of two).
+        ///
+        /// Without \a size items are sized by \ref default_byte_size.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        explicit byte_bounded_queue(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &capacity,
+                                    size_function size = default_byte_size<T>{},
+                                    const backpressure policy = backpressure::block,
+                                    const std::size_t slot_count = default_slot_count)
+            : _budget(capacity), _size(size ? std::move(size) : size_function(default_byte_size<T>{})), _backpressure(policy),
+              _mask(std::bit_ceil(std::max<std::size_t>(slot_count, 2)) - 1),
+              _slots(std::make_unique<slot[]>(_mask + 1)) {
+            for (std::size_t index = 0; index <= _mask; ++index) {
+                _slots[index].sequence.store(index, std::memory_order_relaxed);
+            }
+        }
+
+        byte_bounded_queue(const byte_bounded_queue &) = delete;
+        byte_bounded_queue& operator=(const byte_bounded_queue &) = delete;
+
+        ~byte_bounded_queue() {
+            while (try_take()) {
+            }
+        }
+
+        /// Add \a value if it fits, otherwise return `false` right away, leaving \a value untouched.
+        ///
+        /// \throws std::length_error if \a value is larger than the capacity.
+        [[nodiscard]] bool try_push(T &&value) {
+            const bytes size = _size(value);
+            if (size > capacity()) {
+                throw std::length_error("Item is larger than the capacity of the queue!");
+            }
+            return not closed() && try_emplace(value, size);
+        }
+
+        /// Add \a value, waiting for room according to the \ref backpressure of the queue.
+        ///
+        /// Returns `false`, leaving \a value untouched, if the queue is closed or if it is full and the
+        /// backpressure is \ref backpressure::fail.
+        ///
+        /// \throws std::length_error if \a value is larger than the capacity.
+        bool push(T &&value) {
+            const bytes size = _size(value);
+            if (size > capacity()) {
+                throw std::length_error("Item is larger than the capacity of the queue!");
+            }
+            if (_backpressure == backpressure::fail) {
+                return not closed() && try_emplace(value, size);
+            }
+            return wait_for(_popped, _waiting_producers, _backpressure == backpressure::block,
+                            [&] { return not closed() && try_emplace(value, size); });
+        }
+
+        /// Remove and return the oldest item, or `std::nullopt` if the queue is empty.
+        [[nodiscard]] std::optional<T> try_pop() { return try_take(); }
+
+        /// Remove and return the oldest item, waiting for one if the queue is empty.
+        ///
+        /// Returns `std::nullopt` once the queue is closed and empty.
+        [[nodiscard]] std::optional<T> pop() {
+            std::optional<T> item;
+            wait_for(_pushed, _waiting_consumers, true, [&] {
+                item = try_take();
+                return item.has_value();
+            });
+            return item;
+        }
+
+        /// Reject further items and wake all waiting producers and consumers. Queued items can still be popped.
+        void close() noexcept {
+            _closed.store(true);
+            for (auto *event : {&_pushed, &_popped}) {
+                event->fetch_add(1);
+                event->notify_all();
+            }
+        }
+
+        [[nodiscard]] bool closed() const noexcept { return _closed.load(std::memory_order_acquire); }
+
+        /// Return the amount the queue holds at most.
+        [[nodiscard]] bytes capacity() const noexcept { return _budget.capacity(); }
+
+        /// Return the amount of all items queued.
+        [[nodiscard]] bytes queued() const noexcept { return _budget.used(); }
+
+        /// Return the amount left before producers are held back.
+        [[nodiscard]] bytes available() const noexcept { return _budget.available(); }
+
+        /// Return the highest amount queued at once.
+        [[nodiscard]] bytes peak() const noexcept { return bytes{_peak.load(std::memory_order_relaxed)}; }
+
+        /// Return the number of items queued, which may be off while items are pushed and popped concurrently.
+        [[nodiscard]] std::size_t size() const noexcept {
+            const auto head = _head.load(std::memory_order_relaxed);
+            const auto tail = _tail.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        /// Return the number of items the queue holds at most.
+        [[nodiscard]] std::size_t slot_count() const noexcept { return _mask + 1; }
+    };
+}
+
+#endif // BB9B600E_54AA_4D54_9E27_9D657BAAFE2F
@@ -0,0 +1,23 @@
+#ifndef FB8301A8_A9AC_4700_9CF7_BD9B2B824AC3
+#define FB8301A8_A9AC_4700_9CF7_BD9B2B824AC3
+
+#include "../mem_units.hpp"
+
+#include <ranges>
+
+namespace afs::mem_units {
+    /// Default size of an object held by a \ref byte_bounded_queue or a \ref weighted_cache: the size of the
+    /// elements of contiguous ranges like `std::string` or `std::vector`, otherwise the size of the object itself.
+    template<typename T>
+    struct default_byte_size {
+        [[nodiscard]] bytes operator()(const T &object) const noexcept {
+            if constexpr (std::ranges::contiguous_range<const T> && std::ranges::sized_range<const T>) {
+                return bytes{std::ranges::size(object) * sizeof(std::ranges::range_value_t<const T>)};
+            } else {
+                return bytes{sizeof(T)};
+            }
+        }
+    };
+}
+
+#endif // FB8301A8_A9AC_4700_9CF7_BD9B2B824AC3
@@ -0,0 +1,246 @@
+#ifndef D3B43F92_5711_41AE_8B6D_947235917525
+#define D3B43F92_5711_41AE_8B6D_947235917525
+
+#include "../mem_units.hpp"
+
+#include <expected>
+#include <string_view>
+
+// Arithmetic on memory units that reports over- and underflows as `std::expected` instead of throwing, for builds
+// without exceptions. All functions are constexpr and noexcept, whatever the overflow policy of the units is.
+//
+// With GCC and Clang overflows are detected by `__builtin_add_overflow` and friends, which compile to the
+// arithmetic instruction followed by a jump on its overflow flag.
+
+namespace afs::mem_units {
+    /// Errors of \ref checked_add, \ref checked_sub, \ref checked_mul and \ref checked_cast.
+    enum class mem_unit_error {
+        /// The result is greater than the maximum of the rep.
+        overflow,
+        /// The result is less than the minimum of the rep.
+        underflow
+    };
+
+    /// Returns a description of \a error.
+    [[nodiscard]] constexpr std::string_view to_string(const mem_unit_error error) noexcept {
+        switch (error) {
+            case mem_unit_error::overflow:
+                return "Result would cause an overflow!";
+            case mem_unit_error::underflow:
+                return "Result would cause an underflow!";
+        }
+        return "Unknown memory unit error!";
+    }
+
+    namespace detail {
+        /// Returns the error of a result beyond the limits of its rep, which is negative or not.
+        [[nodiscard]] constexpr mem_unit_error error_of(const bool negative) noexcept {
+            return negative ? mem_unit_error::underflow : mem_unit_error::overflow;
+        }
+
+        template<RepType Rep>
+        [[nodiscard]] constexpr std::expected<Rep, mem_unit_error> add(const Rep lhs, const Rep rhs) noexcept {
+            if constexpr (std::is_floating_point_v<Rep>) {
+                return lhs + rhs;
+            } else {
+                Rep sum;
+#if defined(__GNUC__) || defined(__clang__)
+                if (__builtin_add_overflow(lhs, rhs, &sum)) {
+                    return std::unexpected(error_of(is_negative(rhs)));
+                }
+#else
+                if (is_negative(rhs) ? lhs < std::numeric_limits<Rep>::min() - rhs
+                                     : lhs > std::numeric_limits<Rep>::max() - rhs) {
+                    return std::unexpected(error_of(is_negative(rhs)));
+                }
+                sum = static_cast<Rep>(lhs + rhs);
+#endif
+                return sum;
+            }
+        }
+
+        template<RepType Rep>
+        [[nodiscard]] constexpr std::expected<Rep, mem_unit_error> subtract(const Rep lhs, const Rep rhs) noexcept {
+            if constexpr (std::is_floating_point_v<Rep>) {
+                return lhs - rhs;
+            } else {
+                Rep difference;
+#if defined(__GNUC__) || defined(__clang__)
+                if (__builtin_sub_overflow(lhs, rhs, &difference)) {
+                    return std::unexpected(error_of(not is_negative(rhs)));
+                }
+#else
+                if (is_negative(rhs) ? lhs > std::numeric_limits<Rep>::max() + rhs
+                                     : lhs < std::numeric_limits<Rep>::min() + rhs) {
+                    return std::unexpected(error_of(not is_negative(rhs)));
+                }
+                difference = static_cast<Rep>(lhs - rhs);
+#endif
+                return difference;
+            }
+        }
+
+        template<RepType Rep, std::integral Factor>
+        [[nodiscard]] constexpr std::expected<Rep, mem_unit_error> multiply(const Rep value, const Factor factor) noexcept {
+            if constexpr (std::is_floating_point_v<Rep>) {
+                return static_cast<Rep>(value * factor);
+            } else {
+                Rep product;
+#if defined(__GNUC__) || defined(__clang__)
+                if (__builtin_mul_overflow(value, factor, &product)) {
+                    return std::unexpected(error_of(is_negative(value) != is_negative(factor)));
+                }
+#else
+                // out of range if the magnitude of the product exceeds the limit in its direction
+                constexpr auto magnitude = [](const auto operand) {
+                    return is_negative(operand) ? 0 - static_cast<std::uintmax_t>(operand)
+                                                : static_cast<std::uintmax_t>(operand);
+                };
+                const bool negative = value != 0 && is_negative(value) != is_negative(factor);
+                const auto limit = negative ? magnitude(std::numeric_limits<Rep>::min())
+                                            : static_cast<std::uintmax_t>(std::numeric_limits<Rep>::max());
+                if (factor != 0 && magnitude(value) > limit / magnitude(factor)) {
+                    return std::unexpected(error_of(negative));
+                }
+                product = static_cast<Rep>(value * factor);
+#endif
+                return product;
+            }
+        }
+    }
+
+    namespace detail {
+        /// Returns \a value `/` \t Divisor, rounded towards zero like `/`.
+        template<std::uintmax_t Divisor, std::integral Rep>
+        [[nodiscard]] constexpr Rep divide(const Rep value) noexcept {
+            if constexpr (Divisor == 1) {
+                return value;
+            } else if constexpr (std::is_unsigned_v<Rep>) {
+                return static_cast<Rep>(value / Divisor);
+            } else {
+                // divided as magnitude, since \t Divisor may not fit into \t Rep
+                const auto magnitude = value < 0 ? 0 - static_cast<std::uintmax_t>(value) : static_cast<std::uintmax_t>(value);
+                const auto quotient = static_cast<Rep>(magnitude / Divisor);
+                return value < 0 ? static_cast<Rep>(-quotient) : quotient;
+            }
+        }
+    }
+
+    /// Converts \a from into \t ToType like \ref memory_unit_cast, rounding down if \t ToType has the greater ratio.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(checked_cast<kilobytes32>(4_mb) == kilobytes32(4'096));
+    /// static_assert(checked_cast<kilobytes32>(8_tb).error() == mem_unit_error::overflow);
+    /// ~~~~~
+    ///
+    /// Returns \ref mem_unit_error::overflow if the converted count is greater than the maximum of the rep of
+    /// \t ToType, \ref mem_unit_error::underflow if it is less than its minimum, e.g. negative for an unsigned rep.
+    /// The count is scaled in the greatest integer of the signedness of the rep of \t FromType, so only the
+    /// result has to fit into the rep of \t ToType. Counts of floating point reps are converted unchecked.
+    template<MemoryUnitType ToType, MemoryUnitType FromType>
+    [[nodiscard]] constexpr std::expected<ToType, mem_unit_error> checked_cast(const FromType &from) noexcept {
+        using Rep = typename ToType::rep;
+        using FromRep = typename FromType::rep;
+        if constexpr (std::is_same_v<ToType, FromType>) {
+            return from;
+        } else if constexpr (not std::is_integral_v<Rep> || not std::is_integral_v<FromRep>) {
+            using unchecked_type = with_overflow_policy_t<ToType, unchecked_overflow>;
+            return ToType{memory_unit_cast<unchecked_type>(from).count()};
+        } else {
+            // unsigned, so even conversions between bits and exabytes compile
+            using conversion = detail::unsigned_ratio_divide<typename FromType::ratio, typename ToType::ratio>;
+            using wide_rep = std::conditional_t<std::is_signed_v<FromRep>, std::intmax_t, std::uintmax_t>;
+            auto count = static_cast<wide_rep>(from.count());
+            if constexpr (conversion::num != 1) {
+                const auto scaled = detail::multiply(count, conversion::num);
+                if (not scaled) {
+                    return std::unexpected(scaled.error());
+                }
+                count = *scaled;
+            }
+            count = detail::divide<conversion::den>(count);
+            if (not std::in_range<Rep>(count)) {
+                return std::unexpected(detail::error_of(detail::is_negative(count)));
+            }
+            return ToType{static_cast<Rep>(count)};
+        }
+    }
+
+    /// Returns \a lhs `+` \a rhs as \ref common_memory_unit_t, like `operator+`.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(checked_add(1_kb, 2_b) == 1'026_b);
+    /// static_assert(checked_add(16_eb, 1_b).error() == mem_unit_error::overflow);
+    /// ~~~~~
+    ///
+    /// Returns the \ref mem_unit_error of converting either to the common unit or of the sum not fitting into it.
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+        requires requires { typename common_memory_unit_t<LhsType, RhsType>; }
+    [[nodiscard]] constexpr std::expected<common_memory_unit_t<LhsType, RhsType>, mem_unit_error>
+    checked_add(const LhsType &lhs, const RhsType &rhs) noexcept {
+        using common_type = common_memory_unit_t<LhsType, RhsType>;
+        const auto converted_lhs = checked_cast<common_type>(lhs);
+        if (not converted_lhs) {
+            return std::unexpected(converted_lhs.error());
+        }
+        const auto converted_rhs = checked_cast<common_type>(rhs);
+        if (not converted_rhs) {
+            return std::unexpected(converted_rhs.error());
+        }
+        const auto sum = detail::add(converted_lhs->count(), converted_rhs->count());
+        if (not sum) {
+            return std::unexpected(sum.error());
+        }
+        return common_type{*sum};
+    }
+
+    /// Returns \a lhs `-` \a rhs as \ref common_memory_unit_t, like `operator-`.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(checked_sub(1_mb, 1_kb) == 1'023_kb);
+    /// static_assert(checked_sub(1_kb, 1_mb).error() == mem_unit_error::underflow);
+    /// ~~~~~
+    ///
+    /// Returns the \ref mem_unit_error of converting either to the common unit or of the difference not fitting
+    /// into it.
+    template<MemoryUnitType LhsType, MemoryUnitType RhsType>
+        requires requires { typename common_memory_unit_t<LhsType, RhsType>; }
+    [[nodiscard]] constexpr std::expected<common_memory_unit_t<LhsType, RhsType>, mem_unit_error>
+    checked_sub(const LhsType &lhs, const RhsType &rhs) noexcept {
+        using common_type = common_memory_unit_t<LhsType, RhsType>;
+        const auto converted_lhs = checked_cast<common_type>(lhs);
+        if (not converted_lhs) {
+            return std::unexpected(converted_lhs.error());
+        }
+        const auto converted_rhs = checked_cast<common_type>(rhs);
+        if (not converted_rhs) {
+            return std::unexpected(converted_rhs.error());
+        }
+        const auto difference = detail::subtract(converted_lhs->count(), converted_rhs->count());
+        if (not difference) {
+            return std::unexpected(difference.error());
+        }
+        return common_type{*difference};
+    }
+
+    /// Returns \a mem_unit `*` \a multiplier.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(checked_mul(21_kb, 2) == 42_kb);
+    /// static_assert(checked_mul(bytes(std::uint64_t{1} << 63), 2).error() == mem_unit_error::overflow);
+    /// ~~~~~
+    ///
+    /// Returns \ref mem_unit_error::overflow if the product is greater than the maximum of the rep and
+    /// \ref mem_unit_error::underflow if it is less than its minimum.
+    template<MemoryUnitType MemoryUnit, std::integral Multiplier>
+    [[nodiscard]] constexpr std::expected<MemoryUnit, mem_unit_error> checked_mul(const MemoryUnit &mem_unit,
+                                                                                   const Multiplier multiplier) noexcept {
+        const auto product = detail::multiply(mem_unit.count(), multiplier);
+        if (not product) {
+            return std::unexpected(product.error());
+        }
+        return MemoryUnit{*product};
+    }
+}
+
+#endif // D3B43F92_5711_41AE_8B6D_947235917525
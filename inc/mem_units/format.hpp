@@ -0,0 +1,326 @@
+#ifndef B861B90C_46E6_42FB_9C2E_BBE5252413E2
+#define B861B90C_46E6_42FB_9C2E_BBE5252413E2
+
+#include "../mem_units.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <string_view>
+
+// `std::format` support for memory units. Kept apart from `mem_units.hpp`, since `<format>` is among the most
+// expensive standard headers to parse, so only translation units formatting memory units pay for it.
+
+namespace std {
+    /// Formats any memory unit without allocating, writing directly to the output of the format context.
+    ///
+    /// The format spec is `[[fill]align][width][.precision][unit]`, where `unit` is either
+    /// - empty to print the count with the suffix of the memory unit itself,
+    /// - `h` to scale to the greatest unit of which there is at least one,
+    /// - or one of the suffixes of \ref afs::mem_units::known_units to convert to that unit.
+    ///
+    /// `precision` is the number of fractional digits, without it the shortest exact representation is printed:
+    /// ~~~~~.cpp
+    /// assert(std::format("{}", 1'536_mb) == "1536mb");
+    /// assert(std::format("{:h}", 1'536_mb) == "1.5gb");
+    /// assert(std::format("{:.2kb}", 1'000_b) == "0.98kb");
+    /// assert(std::format("{:*<8h}", 1'536_mb) == "1.5gb***");
+    /// ~~~~~
+    ///
+    /// Integral counts are converted exactly if the target unit is a power of two multiple of the unit itself or
+    /// a whole fraction of it, so any count prints all of its digits. Other conversions and floating point counts
+    /// are printed through `double`.
+    ///
+    /// `fill`, `align` and `width` are those of the standard format spec, applied to the count and its suffix
+    /// together, but the fill is a single `char` and the width can't be a nested replacement field. Like numbers,
+    /// memory units are aligned to the right by default.
+    template<afs::mem_units::RepType Rep, afs::mem_units::RatioType Ratio, afs::mem_units::OverflowPolicyType OverflowPolicy>
+    struct formatter<afs::mem_units::memory_unit<Rep, Ratio, OverflowPolicy>, char> {
+    private:
+        using value_type = afs::mem_units::memory_unit<Rep, Ratio, OverflowPolicy>;
+
+        enum class target_unit { own, scaled, fixed };
+
+        static constexpr int max_precision = 64;
+
+        char _fill = ' ';
+        char _align = '>';
+        int _width = 0;
+        int _precision = -1;
+        target_unit _target = target_unit::own;
+        afs::mem_units::unit_description _fixed{};
+
+        /// Count of a unit `num / den` in a count of \t Ratio, which only is `exact` if it fits into 64 bits.
+        struct conversion {
+            std::uint64_t num = 1;
+            std::uint64_t den = 1;
+            bool exact = false;
+        };
+
+        /// Return the conversion from \t Ratio to \a unit.
+        [[nodiscard]] static constexpr conversion conversion_to(const afs::mem_units::unit_description &unit) noexcept {
+            const auto num_gcd = static_cast<std::uint64_t>(std::gcd(Ratio::num, unit.num));
+            const auto den_gcd = static_cast<std::uint64_t>(std::gcd(Ratio::den, unit.den));
+            const auto lhs_num = static_cast<std::uint64_t>(Ratio::num) / num_gcd;
+            const auto lhs_den = static_cast<std::uint64_t>(Ratio::den) / den_gcd;
+            const auto rhs_num = static_cast<std::uint64_t>(unit.num) / num_gcd;
+            const auto rhs_den = static_cast<std::uint64_t>(unit.den) / den_gcd;
+            if (afs::mem_units::wouldMultiplicationOverflow(lhs_num, rhs_den)
+                || afs::mem_units::wouldMultiplicationOverflow(rhs_num, lhs_den)) {
+                return {};
+            }
+            return {lhs_num * rhs_den, rhs_num * lhs_den, true};
+        }
+
+        /// Return the magnitude of the count of \a value.
+        [[nodiscard]] static constexpr std::uint64_t magnitude_of(const value_type &value) noexcept {
+            const auto bits = static_cast<std::uint64_t>(value.count());
+            return afs::mem_units::detail::is_negative(value.count()) ? 0 - bits : bits;
+        }
+
+        /// Return the greatest known unit of which there is at least one in \a in_bytes.
+        [[nodiscard]] static constexpr afs::mem_units::unit_description scaled_unit(const double in_bytes) {
+            const auto &units = afs::mem_units::known_units;
+            const double magnitude = in_bytes < 0 ? -in_bytes : in_bytes;
+            if (magnitude == 0) {
+                return units[1];
+            }
+            for (auto unit = units.rbegin(); unit != units.rend(); ++unit) {
+                if (magnitude * static_cast<double>(unit->den) >= static_cast<double>(unit->num)) {
+                    return *unit;
+                }
+            }
+            return units.front();
+        }
+
+        /// Return the greatest known unit of which there is at least one in \a magnitude counts, exactly.
+        [[nodiscard]] static constexpr afs::mem_units::unit_description scaled_unit(const std::uint64_t magnitude) {
+            const auto &units = afs::mem_units::known_units;
+            if (magnitude == 0) {
+                return units[1];
+            }
+            for (auto unit = units.rbegin(); unit != units.rend(); ++unit) {
+                const conversion to_unit = conversion_to(*unit);
+                std::uint64_t high = 0;
+                const std::uint64_t low = afs::mem_units::detail::multiply_wide(magnitude, to_unit.num, high);
+                if (not to_unit.exact || high != 0 || low >= to_unit.den) {
+                    return *unit;
+                }
+            }
+            return units.front();
+        }
+
+        /// Return the next decimal digit of \a remainder `/` \a den, which is less than 2^63, leaving the rest of
+        /// that digit in \a remainder.
+        [[nodiscard]] static constexpr char next_digit(std::uint64_t &remainder, const std::uint64_t den) noexcept {
+            // 10 * remainder, subtracting den whenever it is exceeded, so nothing is ever greater than 2 * den
+            char digit = '0';
+            std::uint64_t rest = 0;
+            for (int times = 0; times < 10; ++times) {
+                rest += remainder;
+                if (rest >= den) {
+                    rest -= den;
+                    ++digit;
+                }
+            }
+            remainder = rest;
+            return digit;
+        }
+
+        /// Write \a magnitude counts converted \a to_unit into [\a first, \a last), with \ref _precision digits or
+        /// all of them. Returns `std::errc::not_supported` if that is not possible exactly.
+        [[nodiscard]] constexpr std::to_chars_result to_chars_exact(char *first, char *const last, const bool negative,
+                                                                    const std::uint64_t magnitude,
+                                                                    const conversion &to_unit) const {
+            constexpr std::to_chars_result not_exact{nullptr, std::errc::not_supported};
+            std::uint64_t integral = 0;
+            std::uint64_t remainder = 0;
+            if (not to_unit.exact || (to_unit.num != 1 && to_unit.den != 1) || to_unit.den > std::uint64_t{1} << 63) {
+                return not_exact;
+            } else if (to_unit.den == 1) {
+                if (afs::mem_units::wouldMultiplicationOverflow(magnitude, to_unit.num)) {
+                    return not_exact;
+                }
+                integral = magnitude * to_unit.num;
+            } else {
+                integral = magnitude / to_unit.den;
+                remainder = magnitude % to_unit.den;
+            }
+            if (_precision < 0) {
+                // the shortest representation only ends if the denominator has no other prime factors than 2 and 5
+                std::uint64_t den = to_unit.den >> std::countr_zero(to_unit.den);
+                while (den % 5 == 0) {
+                    den /= 5;
+                }
+                if (den != 1) {
+                    return not_exact;
+                }
+            }
+
+            // the fractional digits first, as rounding them may carry into the integral part
+            std::array<char, max_precision + 64> fraction{};
+            std::size_t digits = 0;
+            while (_precision < 0 ? remainder != 0 : digits < static_cast<std::size_t>(_precision)) {
+                fraction[digits++] = next_digit(remainder, to_unit.den);
+            }
+            if (_precision >= 0 && remainder != 0) {
+                // round half to even, like std::to_chars does
+                const std::uint64_t rest = to_unit.den - remainder;
+                const bool odd = digits == 0 ? integral % 2 != 0 : (fraction[digits - 1] - '0') % 2 != 0;
+                if (remainder > rest || (remainder == rest && odd)) {
+                    std::size_t digit = digits;
+                    for (; digit > 0 && fraction[digit - 1] == '9'; --digit) {
+                        fraction[digit - 1] = '0';
+                    }
+                    if (digit == 0) {
+                        ++integral;
+                    } else {
+                        ++fraction[digit - 1];
+                    }
+                }
+            }
+
+            if (negative && (integral != 0 || std::ranges::any_of(fraction.begin(), fraction.begin() + digits,
+                                                                     [](const char digit) { return digit != '0'; }))) {
+                if (first == last) {
+                    return {last, std::errc::value_too_large};
+                }
+                *first++ = '-';
+            }
+            const auto result = std::to_chars(first, last, integral);
+            if (result.ec != std::errc{} || digits == 0) {
+                return result;
+            }
+            if (static_cast<std::size_t>(last - result.ptr) < digits + 1) {
+                return {last, std::errc::value_too_large};
+            }
+            *result.ptr = '.';
+            return {std::ranges::copy(fraction.begin(), fraction.begin() + digits, result.ptr + 1).out, std::errc{}};
+        }
+
+    protected:
+        /// Format \a value like \ref format does, followed by \a suffix within the width, e.g. the period of a rate.
+        template<typename FormatContext>
+        auto format_with_suffix(const value_type &value, const std::string_view suffix, FormatContext &context) const {
+            // enough for the integral digits of any double, the maximum precision and a suffix
+            std::array<char, 320 + max_precision> buffer;
+            const auto last = buffer.data() + buffer.size();
+            std::to_chars_result result{};
+            std::string_view unit_suffix = afs::mem_units::memory_unit_suffix<value_type>();
+
+            if (_target == target_unit::own && _precision < 0) {
+                if constexpr (std::is_integral_v<Rep>) {
+                    result = std::to_chars(buffer.data(), last, value.count());
+                } else {
+                    result = std::to_chars(buffer.data(), last, value.count(), std::chars_format::fixed);
+                }
+            } else {
+                const double in_bytes = static_cast<double>(value.count()) * Ratio::num / Ratio::den;
+                afs::mem_units::unit_description unit{unit_suffix, Ratio::num, Ratio::den};
+                if (_target == target_unit::scaled) {
+                    if constexpr (std::is_integral_v<Rep>) {
+                        unit = scaled_unit(magnitude_of(value));
+                    } else {
+                        unit = scaled_unit(in_bytes);
+                    }
+                } else if (_target == target_unit::fixed) {
+                    unit = _fixed;
+                }
+                unit_suffix = unit.suffix;
+                result.ec = std::errc::not_supported;
+                if constexpr (std::is_integral_v<Rep>) {
+                    result = to_chars_exact(buffer.data(), last, afs::mem_units::detail::is_negative(value.count()),
+                                            magnitude_of(value), conversion_to(unit));
+                }
+                if (result.ec == std::errc::not_supported) {
+                    const double scaled = in_bytes * static_cast<double>(unit.den) / static_cast<double>(unit.num);
+                    if (_precision < 0) {
+                        result = std::to_chars(buffer.data(), last, scaled, std::chars_format::fixed);
+                    } else {
+                        result = std::to_chars(buffer.data(), last, scaled, std::chars_format::fixed, _precision);
+                    }
+                }
+            }
+
+            if (result.ec != std::errc{} || static_cast<std::size_t>(last - result.ptr) < unit_suffix.size()) {
+                AFS_MEM_UNITS_THROW(std::format_error("Memory unit does not fit into format buffer!"));
+            }
+            const auto formatted_end = std::ranges::copy(unit_suffix, result.ptr).out;
+            const auto size = static_cast<std::size_t>(formatted_end - buffer.data()) + suffix.size();
+            const auto padding = size < static_cast<std::size_t>(_width) ? static_cast<std::size_t>(_width) - size : 0;
+            const auto before = _align == '<' ? 0 : _align == '^' ? padding / 2 : padding;
+            auto out = std::ranges::fill_n(context.out(), static_cast<std::ptrdiff_t>(before), _fill);
+            out = std::ranges::copy(buffer.data(), formatted_end, std::move(out)).out;
+            out = std::ranges::copy(suffix, std::move(out)).out;
+            return std::ranges::fill_n(std::move(out), static_cast<std::ptrdiff_t>(padding - before), _fill);
+        }
+
+    public:
+        constexpr auto parse(std::format_parse_context &context) {
+            constexpr auto is_align = [](const char c) { return c == '<' || c == '>' || c == '^'; };
+            auto it = context.begin();
+            const auto end = context.end();
+            if (it != end && it + 1 != end && is_align(it[1]) && *it != '{' && *it != '}') {
+                _fill = *it;
+                _align = it[1];
+                it += 2;
+            } else if (it != end && is_align(*it)) {
+                _align = *it;
+                ++it;
+            }
+            if (it != end && *it == '{') {
+                AFS_MEM_UNITS_THROW(std::format_error("Nested width in memory unit format spec is not supported!"));
+            }
+            for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+                if (_width == 0 && *it == '0') {
+                    AFS_MEM_UNITS_THROW(std::format_error("Zero padding in memory unit format spec is not supported!"));
+                }
+                _width = _width * 10 + (*it - '0');
+                if (_width > std::numeric_limits<std::uint16_t>::max()) {
+                    AFS_MEM_UNITS_THROW(std::format_error("Width of memory unit format spec is too big!"));
+                }
+            }
+            if (it != end && *it == '.') {
+                ++it;
+                if (it == end || *it < '0' || *it > '9') {
+                    AFS_MEM_UNITS_THROW(std::format_error("Missing precision in memory unit format spec!"));
+                }
+                _precision = 0;
+                for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+                    _precision = _precision * 10 + (*it - '0');
+                    if (_precision > max_precision) {
+                        AFS_MEM_UNITS_THROW(std::format_error("Precision of memory unit format spec is too big!"));
+                    }
+                }
+            }
+            const auto unit_begin = it;
+            while (it != end && *it != '}') {
+                ++it;
+            }
+            const std::string_view unit(unit_begin, it);
+            if (unit == "h") {
+                _target = target_unit::scaled;
+            } else if (not unit.empty()) {
+                const auto known = std::ranges::find(afs::mem_units::known_units, unit, &afs::mem_units::unit_description::suffix);
+                if (known == afs::mem_units::known_units.end()) {
+                    AFS_MEM_UNITS_THROW(std::format_error("Unknown unit in memory unit format spec!"));
+                }
+                _target = target_unit::fixed;
+                _fixed = *known;
+            }
+            return it;
+        }
+
+        template<typename FormatContext>
+        auto format(const value_type &value, FormatContext &context) const {
+            return format_with_suffix(value, std::string_view{}, context);
+        }
+    };
+}
+
+#endif // B861B90C_46E6_42FB_9C2E_BBE5252413E2
@@ -0,0 +1,241 @@
+#ifndef CC83D605_8BC4_4B8E_BE75_ED30CABF7B4A
+#define CC83D605_8BC4_4B8E_BE75_ED30CABF7B4A
+
+#include "../mem_units.hpp"
+
+#include <bit>
+#include <cstdint>
+
+namespace afs::mem_units {
+    /// Memory units that can be added to a \ref memory_accumulator, i.e. with an unsigned rep of at most
+    /// 64 bits and a ratio that is a whole number of bits, whose count of bits per unit fits into 64 bits.
+    template<typename T>
+    concept AccumulableMemoryUnitType = MemoryUnitType<T>
+                                        && std::is_unsigned_v<typename T::rep>
+                                        && std::numeric_limits<typename T::rep>::digits <= 64
+                                        && 8 % T::ratio::den == 0
+                                        && static_cast<std::uintmax_t>(T::ratio::num)
+                                           <= std::numeric_limits<std::uint64_t>::max() / (8 / T::ratio::den);
+
+    /// Sums up memory units of any ratio between \ref bits and \ref exabytes, checking for overflow only once
+    /// when the \ref result is taken.
+    ///
+    /// Counts of \t MemoryUnit itself are summed up in a 128 bit register, so adding them is an add with carry
+    /// and as cheap as adding the raw counts. Any other ratio is added as exact count of bits to a second
+    /// 128 bit register, which costs a widening shift or multiplication, but no \ref memory_unit_cast:
+    /// ~~~~~.cpp
+    /// memory_accumulator<bytes> total;
+    /// for (const auto &object : heap) {
+    ///     total += object.size;
+    /// }
+    /// const bytes used = total.result();
+    /// ~~~~~
+    ///
+    /// Accumulators are associative and commutative, so they can be used with `std::reduce` and parallel
+    /// execution policies by means of \ref plus:
+    /// ~~~~~.cpp
+    /// const auto total = std::reduce(std::execution::par, sizes.begin(), sizes.end(),
+    ///                                memory_accumulator<bytes>{}, memory_accumulator<bytes>::plus{});
+    /// ~~~~~
+    template<AccumulableMemoryUnitType MemoryUnit>
+    class memory_accumulator {
+    public:
+        using value_type = MemoryUnit;
+        using rep = typename MemoryUnit::rep;
+        using ratio = typename MemoryUnit::ratio;
+        using overflow_policy = typename MemoryUnit::overflow_policy;
+
+        /// Binary operation for `std::reduce` and `std::accumulate`, adding any mix of accumulators and
+        /// memory units into an accumulator.
+        struct plus {
+            template<typename Lhs, typename Rhs>
+                requires (std::is_same_v<Lhs, memory_accumulator> || AccumulableMemoryUnitType<Lhs>)
+                         && (std::is_same_v<Rhs, memory_accumulator> || AccumulableMemoryUnitType<Rhs>)
+            constexpr memory_accumulator operator()(const Lhs &lhs, const Rhs &rhs) const noexcept {
+                memory_accumulator sum{lhs};
+                sum += rhs;
+                return sum;
+            }
+        };
+
+    private:
+        // counts of MemoryUnit as _count_carries : _count
+        std::uint64_t _count = 0;
+        std::uint64_t _count_carries = 0;
+        // counts of bits as (_bits_high + _bits_carries) : _bits_low, split up so every add only has
+        // short dependency chains
+        std::uint64_t _bits_low = 0;
+        std::uint64_t _bits_high = 0;
+        std::uint64_t _bits_carries = 0;
+        std::uint64_t _overflowed = 0;
+
+        template<AccumulableMemoryUnitType>
+        friend class memory_accumulator;
+
+        template<RatioType Ratio>
+        static constexpr std::uint64_t bits_per_count = static_cast<std::uint64_t>(Ratio::num) * (8 / Ratio::den);
+
+        /// Return \a value `*` \t Factor, in \a high the bits above 64.
+        template<std::uint64_t Factor>
+        [[nodiscard]] static constexpr std::uint64_t multiply(const std::uint64_t value, std::uint64_t &high) noexcept {
+            if constexpr (std::has_single_bit(Factor)) {
+                constexpr int shift = std::countr_zero(Factor);
+                high = shift == 0 ? 0 : value >> (64 - shift);
+                return value << shift;
+            } else {
+                return detail::multiply_wide(value, Factor, high);
+            }
+        }
+
+        /// Return \a upper : \a lower divided by \t Divisor, in \a high the bits above 64.
+        template<std::uint64_t Divisor>
+        [[nodiscard]] static constexpr std::uint64_t divide(const std::uint64_t upper, const std::uint64_t lower,
+                                                            std::uint64_t &high) noexcept {
+            if constexpr (std::has_single_bit(Divisor)) {
+                constexpr int shift = std::countr_zero(Divisor);
+                high = upper >> shift;
+                return shift == 0 ? lower : (lower >> shift) | (upper << (64 - shift));
+            } else {
+#ifdef __SIZEOF_INT128__
+                const auto quotient = ((static_cast<unsigned __int128>(upper) << 64) | lower) / Divisor;
+                high = static_cast<std::uint64_t>(quotient >> 64);
+                return static_cast<std::uint64_t>(quotient);
+#else
+                high = upper / Divisor;
+                std::uint64_t remainder = upper % Divisor;
+                std::uint64_t quotient = 0;
+                for (int bit = 63; bit >= 0; --bit) {
+                    const bool carry = remainder >> 63;
+                    remainder = (remainder << 1) | ((lower >> bit) & 1);
+                    if (carry || remainder >= Divisor) {
+                        remainder -= Divisor;
+                        quotient |= std::uint64_t{1} << bit;
+                    }
+                }
+                return quotient;
+#endif
+            }
+        }
+
+        /// Add \a high : \a low to the bits register, remembering any carry out of it.
+        constexpr void add_bits(const std::uint64_t low, const std::uint64_t high) noexcept {
+            _bits_low += low;
+            _bits_carries += _bits_low < low;
+            _bits_high += high;
+            _overflowed |= _bits_high < high;
+        }
+
+        /// Return the counts of \t MemoryUnit as bits, in \a high the bits above 64.
+        ///
+        /// Returns `false` in \a fits if these do not fit into 128 bits.
+        [[nodiscard]] constexpr std::uint64_t count_bits(std::uint64_t &high, bool &fits) const noexcept {
+            constexpr std::uint64_t factor = bits_per_count<ratio>;
+            std::uint64_t carry_high = 0;
+            const std::uint64_t carry_low = multiply<factor>(_count_carries, carry_high);
+            const std::uint64_t low = multiply<factor>(_count, high);
+            high += carry_low;
+            fits = carry_high == 0 && high >= carry_low;
+            return low;
+        }
+
+    public:
+        constexpr memory_accumulator() noexcept = default;
+
+        /// Construct with \a value as initial sum.
+        template<AccumulableMemoryUnitType OtherType>
+        explicit constexpr memory_accumulator(const OtherType &value) noexcept {
+            *this += value;
+        }
+
+        /// Construct with the sum of \a other, which may accumulate another memory unit.
+        template<AccumulableMemoryUnitType OtherType>
+        explicit constexpr memory_accumulator(const memory_accumulator<OtherType> &other) noexcept {
+            *this += other;
+        }
+
+        /// Add \a value, which may have any ratio between \ref bits and \ref exabytes.
+        template<AccumulableMemoryUnitType OtherType>
+        constexpr memory_accumulator& operator+=(const OtherType &value) noexcept {
+            if constexpr (std::ratio_equal_v<typename OtherType::ratio, ratio>) {
+                const auto count = static_cast<std::uint64_t>(value.count());
+                _count += count;
+                _count_carries += _count < count;
+            } else {
+                std::uint64_t high = 0;
+                const std::uint64_t low = multiply<bits_per_count<typename OtherType::ratio>>(value.count(), high);
+                add_bits(low, high);
+            }
+            return *this;
+        }
+
+        /// Add the sum of \a other.
+        template<AccumulableMemoryUnitType OtherType>
+        constexpr memory_accumulator& operator+=(const memory_accumulator<OtherType> &other) noexcept {
+            if constexpr (std::ratio_equal_v<typename OtherType::ratio, ratio>) {
+                _count += other._count;
+                const std::uint64_t carries = other._count_carries + (_count < other._count);
+                _count_carries += carries;
+                _overflowed |= (_count_carries < carries) | (carries < other._count_carries);
+            } else {
+                std::uint64_t high = 0;
+                bool fits = true;
+                const std::uint64_t low = other.count_bits(high, fits);
+                add_bits(low, high);
+                _overflowed |= not fits;
+            }
+            add_bits(other._bits_low, other._bits_high);
+            _bits_carries += other._bits_carries;
+            _overflowed |= other._overflowed | (_bits_carries < other._bits_carries);
+            return *this;
+        }
+
+        template<typename Other>
+        friend constexpr memory_accumulator operator+(memory_accumulator lhs, const Other &rhs) noexcept
+            requires requires { lhs += rhs; } {
+            lhs += rhs;
+            return lhs;
+        }
+
+        template<AccumulableMemoryUnitType OtherType>
+        friend constexpr memory_accumulator operator+(const OtherType &lhs, memory_accumulator rhs) noexcept {
+            rhs += lhs;
+            return rhs;
+        }
+
+        /// Return the sum as \t ToType, rounded down like by \ref memory_unit_cast.
+        ///
+        /// If the sum does not fit into the rep of \t ToType, it is handled according to its overflow policy:
+        /// \ref saturating_overflow returns the maximum, \ref wrapping_overflow and \ref unchecked_overflow the
+        /// sum modulo the range of the rep. The latter is exact even if the registers overflowed, as long as
+        /// all ratios involved are powers of two.
+        ///
+        /// \throws std::overflow_error if the sum does not fit into the rep of \t ToType and its overflow policy is
+        ///         \ref checked_overflow.
+        template<AccumulableMemoryUnitType ToType = MemoryUnit>
+        [[nodiscard]] constexpr ToType result() const {
+            using to_rep = typename ToType::rep;
+            using to_policy = typename ToType::overflow_policy;
+            std::uint64_t upper = 0;
+            bool fits = true;
+            std::uint64_t lower = count_bits(upper, fits);
+            lower += _bits_low;
+            const std::uint64_t carries = _bits_carries + (lower < _bits_low);
+            const std::uint64_t bits_high = _bits_high + carries;
+            upper += bits_high;
+            fits = fits && _overflowed == 0 && bits_high >= carries && upper >= bits_high;
+
+            std::uint64_t high = 0;
+            const std::uint64_t low = divide<bits_per_count<typename ToType::ratio>>(upper, lower, high);
+            if (not fits || high != 0 || low > std::numeric_limits<to_rep>::max()) {
+                if constexpr (std::is_same_v<to_policy, checked_overflow>) {
+                    AFS_MEM_UNITS_THROW(std::overflow_error("Accumulation would cause an overflow!"));
+                } else if constexpr (std::is_same_v<to_policy, saturating_overflow>) {
+                    return ToType{std::numeric_limits<to_rep>::max()};
+                }
+            }
+            return ToType{static_cast<to_rep>(low)};
+        }
+    };
+}
+
+#endif // CC83D605_8BC4_4B8E_BE75_ED30CABF7B4A
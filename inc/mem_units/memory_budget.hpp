@@ -0,0 +1,182 @@
+#ifndef EE47E615_3CBF_46C3_AA1E_559BFDC84687
+#define EE47E615_3CBF_46C3_AA1E_559BFDC84687
+
+#include "../mem_units.hpp"
+#include "atomic_memory_unit.hpp"
+
+#include <optional>
+#include <utility>
+
+namespace afs::mem_units {
+    class memory_budget;
+
+    /// RAII handle for an amount reserved from a \ref memory_budget, which is released on destruction.
+    ///
+    /// Reservations are move only and must not outlive the budget they were taken from.
+    class memory_reservation {
+        memory_budget *_budget = nullptr;
+        bytes _size{};
+
+        friend class memory_budget;
+
+        memory_reservation(memory_budget &budget, const bytes size) noexcept : _budget(&budget), _size(size) {}
+
+    public:
+        constexpr memory_reservation() noexcept = default;
+
+        memory_reservation(memory_reservation &&other) noexcept
+            : _budget(std::exchange(other._budget, nullptr)), _size(std::exchange(other._size, bytes{})) {}
+
+        memory_reservation& operator=(memory_reservation &&other) noexcept {
+            if (this != &other) {
+                release();
+                _budget = std::exchange(other._budget, nullptr);
+                _size = std::exchange(other._size, bytes{});
+            }
+            return *this;
+        }
+
+        ~memory_reservation() { release(); }
+
+        /// Return the reserved amount, which is 0 for an empty or released reservation.
+        [[nodiscard]] bytes size() const noexcept { return _size; }
+
+        /// Return the budget reserved from, which is `nullptr` for an empty or released reservation.
+        [[nodiscard]] memory_budget* budget() const noexcept { return _budget; }
+
+        explicit operator bool() const noexcept { return _budget != nullptr; }
+
+        /// Give the reserved amount back to the budget before destruction.
+        inline void release() noexcept;
+    };
+
+    /// A capacity of memory that can be reserved from concurrently without locking.
+    ///
+    /// Budgets may form a hierarchy, where reserving from a child also reserves from all of its parents,
+    /// so the child cap and every parent cap are honored:
+    /// ~~~~~.cpp
+    /// memory_budget process{4_gb};
+    /// memory_budget tenant{1_gb, process};
+    ///
+    /// if (auto reservation = tenant.reserve(64_mb)) {
+    ///     // counts against tenant and process until reservation is destroyed
+    /// }
+    /// ~~~~~
+    ///
+    /// Reserving is a compare-and-swap loop per budget level, i.e. lock free. Should a parent fail, the amounts
+    /// already taken from its children are given back. Parents must outlive their children.
+    class memory_budget {
+        atomic_memory_unit<bytes> _capacity;
+        atomic_memory_unit<unchecked_bytes> _used;
+        memory_budget *_parent = nullptr;
+
+        /// Reserve \a amount from this level only.
+        [[nodiscard]] bool try_reserve_here(const bytes amount) noexcept {
+            unchecked_bytes expected = _used.load(std::memory_order_relaxed);
+            do {
+                const bytes capacity = _capacity.load(std::memory_order_relaxed);
+                if (expected.count() > capacity.count() || amount.count() > capacity.count() - expected.count()) {
+                    return false;
+                }
+            } while (not _used.compare_exchange_weak(expected, expected + unchecked_bytes(amount),
+                                                     std::memory_order_acquire, std::memory_order_relaxed));
+            return true;
+        }
+
+        void release_here(const bytes amount) noexcept {
+            _used.fetch_sub(unchecked_bytes(amount.count()), std::memory_order_release);
+        }
+
+    public:
+        /// Construct a root budget with \a capacity, which may have any ratio of at least a byte.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        explicit memory_budget(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &capacity)
+            : _capacity(capacity) {}
+
+        /// Construct a budget with \a capacity, whose reservations are also charged to \a parent.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        memory_budget(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &capacity, memory_budget &parent)
+            : _capacity(capacity), _parent(&parent) {}
+
+        memory_budget(const memory_budget &) = delete;
+        memory_budget& operator=(const memory_budget &) = delete;
+
+        /// Return the parent budget, which is `nullptr` for a root budget.
+        [[nodiscard]] memory_budget* parent() const noexcept { return _parent; }
+
+        /// Return the capacity of this budget, not considering its parents.
+        [[nodiscard]] bytes capacity() const noexcept { return _capacity.load(std::memory_order_relaxed); }
+
+        /// Change the capacity to \a capacity.
+        ///
+        /// Shrinking below \ref used does not revoke reservations, but prevents new ones until enough is released.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        void set_capacity(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &capacity) {
+            _capacity.store(capacity, std::memory_order_relaxed);
+        }
+
+        /// Return the amount currently reserved from this budget, including reservations of its children.
+        [[nodiscard]] bytes used() const noexcept { return bytes(_used.load(std::memory_order_relaxed)); }
+
+        /// Return the amount still available in this budget, not considering its parents.
+        [[nodiscard]] bytes available() const noexcept {
+            const bytes capacity = this->capacity();
+            const bytes used = this->used();
+            return used > capacity ? bytes{} : capacity - used;
+        }
+
+        /// Reserve \a amount from this budget and all of its parents, which has to be released manually.
+        ///
+        /// Returns `false` without reserving anything if \a amount exceeds the available amount of any level.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        [[nodiscard]] bool try_reserve(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &amount) {
+            const auto converted = memory_unit_cast<bytes>(amount);
+            for (memory_budget *level = this; level != nullptr; level = level->_parent) {
+                if (not level->try_reserve_here(converted)) {
+                    for (memory_budget *reserved = this; reserved != level; reserved = reserved->_parent) {
+                        reserved->release_here(converted);
+                    }
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Release \a amount previously reserved with \ref try_reserve from this budget and all of its parents.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        void release(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &amount) {
+            const auto converted = memory_unit_cast<bytes>(amount);
+            for (memory_budget *level = this; level != nullptr; level = level->_parent) {
+                level->release_here(converted);
+            }
+        }
+
+        /// Reserve \a amount like \ref try_reserve, returning a handle that releases it on destruction.
+        ///
+        /// Returns `std::nullopt` if \a amount is not available.
+        template<RatioType Ratio, OverflowPolicyType OverflowPolicy>
+            requires std::ratio_greater_equal_v<Ratio, bytes::ratio>
+        [[nodiscard]] std::optional<memory_reservation> reserve(const memory_unit<bytes::rep, Ratio, OverflowPolicy> &amount) {
+            const auto converted = memory_unit_cast<bytes>(amount);
+            if (not try_reserve(converted)) {
+                return std::nullopt;
+            }
+            return memory_reservation{*this, converted};
+        }
+    };
+
+    inline void memory_reservation::release() noexcept {
+        if (_budget != nullptr) {
+            _budget->release(_size);
+            _budget = nullptr;
+            _size = bytes{};
+        }
+    }
+}
+
+#endif // EE47E615_3CBF_46C3_AA1E_559BFDC84687
@@ -0,0 +1,376 @@
+#ifndef BF4E9031_B658_46D3_A2A4_06F627D2A009
+#define BF4E9031_B658_46D3_A2A4_06F627D2A009
+
+#include "memory_probe.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
+
+namespace afs::mem_units {
+    /// Counts of `memory.events` of a cgroup v2, i.e. how often the cgroup hit its memory limits.
+    struct memory_events {
+        /// Times the usage was below `memory.low` but memory was reclaimed anyway.
+        std::uint64_t low = 0;
+        /// Times the usage exceeded `memory.high` and the cgroup was throttled.
+        std::uint64_t high = 0;
+        /// Times the usage was about to exceed `memory.max`.
+        std::uint64_t max = 0;
+        /// Times the cgroup ran out of memory.
+        std::uint64_t oom = 0;
+        /// Processes of the cgroup killed by the OOM killer.
+        std::uint64_t oom_kill = 0;
+
+        friend bool operator==(const memory_events &, const memory_events &) = default;
+    };
+
+    /// Kinds of memory stalls of the Linux pressure stall information.
+    enum class memory_stall {
+        /// At least one task stalled waiting for memory.
+        some,
+        /// All tasks stalled waiting for memory at once.
+        full
+    };
+
+    /// Calls back when memory usage crosses thresholds, memory pressure rises or the cgroup hits its limits,
+    /// all waited for by a single thread on an `epoll` instance.
+    ///
+    /// Thresholds are registered in memory units before \ref start:
+    /// ~~~~~.cpp
+    /// memory_pressure_watcher watcher;
+    /// watcher.on_usage_above(3_gb, [](bytes usage) { cache.shrink(); });
+    /// watcher.on_pressure(memory_stall::some, 150ms, 2s, [] { cache.shrink(); });
+    /// watcher.on_memory_events([](const memory_events &events) { log(events.oom_kill); });
+    /// watcher.start();
+    /// ~~~~~
+    ///
+    /// Pressure triggers are registered with the kernel by writing to `pressure/memory` below the proc root
+    /// and wake the watcher as soon as the stall is exceeded. `memory.events` of the cgroup is watched with
+    /// `inotify`. Since the kernel does not notify about usage, it is sampled by a \ref memory_probe with the
+    /// given interval, as usage of the cgroup of the process or its resident set size without one.
+    ///
+    /// Files below the roots that do not support `epoll`, like regular files standing in for `/proc` in
+    /// tests, are watched with `inotify` instead.
+    ///
+    /// Callbacks are called on the thread of the watcher and must not throw.
+    class memory_pressure_watcher {
+    public:
+        using usage_callback = std::function<void(bytes usage)>;
+        using pressure_callback = std::function<void()>;
+        using events_callback = std::function<void(const memory_events &events)>;
+
+    private:
+        struct usage_threshold {
+            bytes threshold;
+            usage_callback callback;
+            bool above = false;
+        };
+
+        struct pressure_trigger {
+            file_descriptor fd;
+            int watch = -1;
+            pressure_callback callback;
+        };
+
+        // tags of the file descriptors added to _epoll, followed by those of the pressure triggers
+        static constexpr std::uint64_t stop_tag = 0;
+        static constexpr std::uint64_t timer_tag = 1;
+        static constexpr std::uint64_t inotify_tag = 2;
+        static constexpr std::uint64_t first_trigger_tag = 3;
+
+        std::string _proc_root;
+        std::chrono::nanoseconds _usage_interval;
+        memory_probe _probe;
+        file_descriptor _epoll;
+        file_descriptor _stop;
+        file_descriptor _timer;
+        file_descriptor _inotify;
+        std::vector<usage_threshold> _usage_thresholds;
+        std::vector<pressure_trigger> _pressure_triggers;
+        std::vector<events_callback> _events_callbacks;
+        file_descriptor _events;
+        int _events_watch = -1;
+        memory_events _last_events;
+        std::array<char, 4'096> _buffer{};
+        std::jthread _thread;
+
+        [[nodiscard]] static file_descriptor checked(const int fd, const char *what) {
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+            return file_descriptor(fd);
+        }
+
+        void add_to_epoll(const int fd, const std::uint32_t events, const std::uint64_t tag) const {
+            epoll_event event{};
+            event.events = events;
+            event.data.u64 = tag;
+            if (::epoll_ctl(_epoll.get(), EPOLL_CTL_ADD, fd, &event) != 0) {
+                throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+            }
+        }
+
+        [[nodiscard]] int watch(const std::string &path) {
+            if (not _inotify) {
+                _inotify = checked(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC), "inotify_init1");
+                add_to_epoll(_inotify.get(), EPOLLIN, inotify_tag);
+            }
+            const int watch = ::inotify_add_watch(_inotify.get(), path.c_str(), IN_MODIFY);
+            if (watch < 0) {
+                throw std::system_error(errno, std::generic_category(), "inotify_add_watch " + path);
+            }
+            return watch;
+        }
+
+        void ensure_not_started() const {
+            if (_thread.joinable()) {
+                throw std::logic_error("Thresholds must be registered before the watcher is started!");
+            }
+        }
+
+        /// Parse \a text of `memory.events` into \a events, returning `false` if it is empty.
+        static bool parse_events(std::string_view text, memory_events &events) noexcept {
+            if (text.empty()) {
+                return false;
+            }
+            while (not text.empty()) {
+                const auto line_end = std::min(text.find('\n'), text.size());
+                const auto line = text.substr(0, line_end);
+                text.remove_prefix(std::min(line_end + 1, text.size()));
+
+                const auto blank = line.find(' ');
+                if (blank == std::string_view::npos) {
+                    continue;
+                }
+                const auto key = line.substr(0, blank);
+                std::uint64_t *value = key == "low"        ? &events.low
+                                       : key == "high"     ? &events.high
+                                       : key == "max"      ? &events.max
+                                       : key == "oom"      ? &events.oom
+                                       : key == "oom_kill" ? &events.oom_kill
+                                                           : nullptr;
+                if (value != nullptr) {
+                    std::from_chars(line.data() + blank + 1, line.data() + line.size(), *value);
+                }
+            }
+            return true;
+        }
+
+        void check_usage() {
+            const auto snapshot = _probe.sample();
+            const bytes usage = snapshot.cgroup_usage.value_or(memory_unit_cast<bytes>(snapshot.rss));
+            for (auto &threshold : _usage_thresholds) {
+                const bool above = usage > threshold.threshold;
+                if (above && not threshold.above) {
+                    threshold.callback(usage);
+                }
+                threshold.above = above;
+            }
+        }
+
+        void check_events() {
+            memory_events events;
+            if (not parse_events(_events.read(_buffer), events) || events == _last_events) {
+                return;
+            }
+            _last_events = events;
+            for (const auto &callback : _events_callbacks) {
+                callback(events);
+            }
+        }
+
+        void handle_inotify() {
+            alignas(inotify_event) std::array<char, 4'096> buffer;
+            ssize_t size;
+            while ((size = ::read(_inotify.get(), buffer.data(), buffer.size())) > 0) {
+                for (auto position = buffer.data(); position < buffer.data() + size;) {
+                    const auto *event = reinterpret_cast<const inotify_event *>(position);
+                    if (event->wd == _events_watch) {
+                        check_events();
+                    }
+                    for (const auto &trigger : _pressure_triggers) {
+                        if (event->wd == trigger.watch) {
+                            trigger.callback();
+                        }
+                    }
+                    position += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+
+        void run(const std::stop_token &stop) {
+            std::array<epoll_event, 16> events;
+            while (not stop.stop_requested()) {
+                const int count = ::epoll_wait(_epoll.get(), events.data(), static_cast<int>(events.size()), -1);
+                for (int index = 0; index < count && not stop.stop_requested(); ++index) {
+                    const auto tag = events[static_cast<std::size_t>(index)].data.u64;
+                    try {
+                        if (tag == stop_tag) {
+                            std::uint64_t stops;
+                            [[maybe_unused]] const auto ignored = ::read(_stop.get(), &stops, sizeof(stops));
+                        } else if (tag == timer_tag) {
+                            std::uint64_t expirations;
+                            [[maybe_unused]] const auto ignored = ::read(_timer.get(), &expirations, sizeof(expirations));
+                            check_usage();
+                        } else if (tag == inotify_tag) {
+                            handle_inotify();
+                        } else if (tag >= first_trigger_tag) {
+                            const auto &trigger = _pressure_triggers[tag - first_trigger_tag];
+                            if (events[static_cast<std::size_t>(index)].events & EPOLLERR) {
+                                ::epoll_ctl(_epoll.get(), EPOLL_CTL_DEL, trigger.fd.get(), nullptr);
+                            } else {
+                                trigger.callback();
+                            }
+                        }
+                    } catch (const std::system_error &) {
+                        // the file could not be read this time, try again on its next event
+                    }
+                }
+            }
+        }
+
+    public:
+        /// Construct a watcher of the process, sampling its usage every \a usage_interval.
+        ///
+        /// \a proc_root and \a cgroup_root are used like by \ref memory_probe.
+        ///
+        /// \throws std::system_error if the files of \a proc_root cannot be opened or `epoll` is not available.
+        explicit memory_pressure_watcher(const std::chrono::nanoseconds usage_interval = std::chrono::milliseconds{100},
+                                         const std::string &proc_root = "/proc",
+                                         const std::string &cgroup_root = "/sys/fs/cgroup")
+            : _proc_root(proc_root),
+              _usage_interval(usage_interval),
+              _probe(proc_root, cgroup_root),
+              _epoll(checked(::epoll_create1(EPOLL_CLOEXEC), "epoll_create1")),
+              _stop(checked(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC), "eventfd")) {
+            add_to_epoll(_stop.get(), EPOLLIN, stop_tag);
+        }
+
+        memory_pressure_watcher(const memory_pressure_watcher &) = delete;
+        memory_pressure_watcher& operator=(const memory_pressure_watcher &) = delete;
+
+        ~memory_pressure_watcher() { stop(); }
+
+        /// Call \a callback with the usage once it exceeds \a threshold, and again only after it fell
+        /// below \a threshold in between.
+        ///
+        /// \throws std::logic_error if the watcher was started already.
+        template<MemoryUnitType MemoryUnit>
+        void on_usage_above(const MemoryUnit &threshold, usage_callback callback) {
+            ensure_not_started();
+            if (not _timer) {
+                _timer = checked(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC), "timerfd_create");
+                add_to_epoll(_timer.get(), EPOLLIN, timer_tag);
+            }
+            _usage_thresholds.push_back({memory_unit_cast<bytes>(threshold), std::move(callback)});
+        }
+
+        /// Call \a callback whenever tasks stalled for \a stall waiting for memory within \a window.
+        ///
+        /// The kernel requires \a window to be between 500 ms and 10 s, and a multiple of 2 s for
+        /// unprivileged processes.
+        ///
+        /// \throws std::logic_error if the watcher was started already.
+        /// \throws std::system_error if the trigger is rejected or pressure stall information is not available.
+        void on_pressure(const memory_stall kind, const std::chrono::microseconds stall,
+                         const std::chrono::microseconds window, pressure_callback callback) {
+            ensure_not_started();
+            const auto path = _proc_root + "/pressure/memory";
+            pressure_trigger trigger{checked(::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC), "open pressure"),
+                                     -1, std::move(callback)};
+
+            std::array<char, 64> text{};
+            const auto prefix = kind == memory_stall::some ? std::string_view("some ") : std::string_view("full ");
+            auto end = std::copy(prefix.begin(), prefix.end(), text.begin());
+            end = std::to_chars(end, text.end() - 1, stall.count()).ptr;
+            *end++ = ' ';
+            end = std::to_chars(end, text.end() - 1, window.count()).ptr;
+            // the kernel expects the trigger terminated by a null character
+            if (::write(trigger.fd.get(), text.data(), static_cast<std::size_t>(end - text.begin()) + 1) < 0) {
+                throw std::system_error(errno, std::generic_category(), "write pressure trigger");
+            }
+
+            epoll_event event{};
+            event.events = EPOLLPRI;
+            event.data.u64 = first_trigger_tag + _pressure_triggers.size();
+            if (::epoll_ctl(_epoll.get(), EPOLL_CTL_ADD, trigger.fd.get(), &event) != 0) {
+                if (errno != EPERM) {
+                    throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+                }
+                trigger.watch = watch(path);
+            }
+            _pressure_triggers.push_back(std::move(trigger));
+        }
+
+        /// Call \a callback with all counts of `memory.events` of the cgroup of the process whenever
+        /// one of them changes.
+        ///
+        /// \throws std::logic_error if the watcher was started already.
+        /// \throws std::system_error if the process has no cgroup v2 or its `memory.events` cannot be read.
+        void on_memory_events(events_callback callback) {
+            ensure_not_started();
+            if (not _events) {
+                if (not _probe.has_cgroup()) {
+                    throw std::system_error(ENOENT, std::generic_category(), "memory.events");
+                }
+                const auto path = _probe.cgroup_directory() + "/memory.events";
+                _events = file_descriptor(path);
+                if (not _events) {
+                    throw std::system_error(errno, std::generic_category(), "open " + path);
+                }
+                parse_events(_events.read(_buffer), _last_events);
+                _events_watch = watch(path);
+            }
+            _events_callbacks.push_back(std::move(callback));
+        }
+
+        /// Start the thread waiting for the registered thresholds.
+        ///
+        /// \throws std::logic_error if the watcher was started already.
+        /// \throws std::system_error if the usage cannot be sampled.
+        void start() {
+            ensure_not_started();
+            if (_timer) {
+                const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(_usage_interval);
+                itimerspec interval{};
+                interval.it_interval.tv_sec = static_cast<time_t>(seconds.count());
+                interval.it_interval.tv_nsec = static_cast<long>((_usage_interval - seconds).count());
+                interval.it_value = interval.it_interval;
+                if (::timerfd_settime(_timer.get(), 0, &interval, nullptr) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "timerfd_settime");
+                }
+                check_usage();
+            }
+            _thread = std::jthread([this](const std::stop_token &stop) { run(stop); });
+        }
+
+        /// Stop the thread and wait for it, if it was started.
+        void stop() noexcept {
+            if (_thread.joinable()) {
+                _thread.request_stop();
+                const std::uint64_t one = 1;
+                [[maybe_unused]] const auto ignored = ::write(_stop.get(), &one, sizeof(one));
+                _thread.join();
+            }
+        }
+
+        /// Return if the watcher was started and not stopped yet.
+        [[nodiscard]] bool running() const noexcept { return _thread.joinable(); }
+    };
+}
+
+#endif
+
+#endif // BF4E9031_B658_46D3_A2A4_06F627D2A009
@@ -0,0 +1,262 @@
+#ifndef E10859B1_F95F_4402_82BD_DC60AD8E22B3
+#define E10859B1_F95F_4402_82BD_DC60AD8E22B3
+
+#include "../mem_units.hpp"
+#include "parse.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace afs::mem_units {
+    /// Memory of the system, the own process and its cgroup at one point in time, see \ref memory_probe.
+    struct memory_snapshot {
+        /// `MemTotal` of `/proc/meminfo`.
+        kilobytes total{};
+        /// `MemFree` of `/proc/meminfo`.
+        kilobytes free{};
+        /// `MemAvailable` of `/proc/meminfo`, the estimate of memory available without swapping.
+        kilobytes available{};
+        /// `Cached` of `/proc/meminfo`.
+        kilobytes cached{};
+        /// `SwapTotal` of `/proc/meminfo`.
+        kilobytes swap_total{};
+        /// `SwapFree` of `/proc/meminfo`.
+        kilobytes swap_free{};
+        /// `VmRSS` of `/proc/self/status`, the resident set size of the process.
+        kilobytes rss{};
+        /// `VmHWM` of `/proc/self/status`, the peak resident set size of the process.
+        kilobytes peak_rss{};
+        /// `memory.max` of the cgroup v2 of the process, `std::nullopt` if unlimited or not available.
+        std::optional<bytes> cgroup_limit;
+        /// `memory.current` of the cgroup v2 of the process, `std::nullopt` if not available.
+        std::optional<bytes> cgroup_usage;
+    };
+
+    /// An open file descriptor that is closed on destruction.
+    class file_descriptor {
+        int _fd = -1;
+
+    public:
+        file_descriptor() noexcept = default;
+
+        /// Take ownership of \a fd, which may be -1 for none.
+        explicit file_descriptor(const int fd) noexcept : _fd(fd) {}
+
+        /// Open \a path with \a flags, which is none if that fails.
+        explicit file_descriptor(const std::string &path, const int flags = O_RDONLY) noexcept
+            : _fd(::open(path.c_str(), flags | O_CLOEXEC)) {}
+
+        file_descriptor(file_descriptor &&other) noexcept : _fd(std::exchange(other._fd, -1)) {}
+
+        file_descriptor& operator=(file_descriptor &&other) noexcept {
+            if (this != &other) {
+                close();
+                _fd = std::exchange(other._fd, -1);
+            }
+            return *this;
+        }
+
+        ~file_descriptor() { close(); }
+
+        explicit operator bool() const noexcept { return _fd >= 0; }
+
+        [[nodiscard]] int get() const noexcept { return _fd; }
+
+        void close() noexcept {
+            if (_fd >= 0) {
+                ::close(std::exchange(_fd, -1));
+            }
+        }
+
+        /// Read the file from its beginning into \a buffer, returning the part read.
+        ///
+        /// \throws std::system_error if reading fails.
+        [[nodiscard]] std::string_view read(const std::span<char> buffer) const {
+            std::size_t size = 0;
+            while (size < buffer.size()) {
+                const auto count = ::pread(_fd, buffer.data() + size, buffer.size() - size, static_cast<off_t>(size));
+                if (count < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "pread");
+                }
+                if (count == 0) {
+                    break;
+                }
+                size += static_cast<std::size_t>(count);
+            }
+            return {buffer.data(), size};
+        }
+    };
+
+    /// Samples \ref memory_snapshot "memory snapshots" on Linux cheap enough to poll several times per second.
+    ///
+    /// All files are opened once on construction. Sampling reads them with `pread` into a fixed buffer and
+    /// parses them without allocating:
+    /// ~~~~~.cpp
+    /// memory_probe probe;
+    /// const auto snapshot = probe.sample();
+    /// if (snapshot.cgroup_limit && *snapshot.cgroup_usage > *snapshot.cgroup_limit - 64_mb) {
+    ///     // shrink caches
+    /// }
+    /// ~~~~~
+    ///
+    /// The roots of `/proc` and the cgroup v2 hierarchy may be replaced, e.g. by fixture files for testing.
+    /// A probe must not be sampled by several threads at once.
+    class memory_probe {
+        /// A `Key: value kB` line of a `/proc` file to parse into \ref value.
+        struct field {
+            std::string_view key;
+            kilobytes *value;
+        };
+
+        file_descriptor _meminfo;
+        file_descriptor _status;
+        file_descriptor _cgroup_max;
+        file_descriptor _cgroup_current;
+        std::string _cgroup_directory;
+        std::array<char, 8'192> _buffer{};
+
+        [[nodiscard]] static file_descriptor open_required(const std::string &path) {
+            file_descriptor fd(path);
+            if (not fd) {
+                throw std::system_error(errno, std::generic_category(), "open " + path);
+            }
+            return fd;
+        }
+
+        /// Parse all \a fields in \a text, which consists of `Key: value kB` lines.
+        static void parse_fields(std::string_view text, const std::span<const field> fields) noexcept {
+            std::size_t found = 0;
+            while (not text.empty() && found < fields.size()) {
+                const auto line_end = std::min(text.find('\n'), text.size());
+                const auto line = text.substr(0, line_end);
+                text.remove_prefix(std::min(line_end + 1, text.size()));
+
+                const auto colon = line.find(':');
+                if (colon == std::string_view::npos) {
+                    continue;
+                }
+                const auto key = line.substr(0, colon);
+                for (const auto &[name, value] : fields) {
+                    if (key == name) {
+                        auto first = line.data() + colon + 1;
+                        const auto last = line.data() + line.size();
+                        while (first != last && (*first == ' ' || *first == '\t')) {
+                            ++first;
+                        }
+                        if (from_chars(first, last, *value).ec == std::errc{}) {
+                            ++found;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        /// Read a cgroup file holding a count of bytes or `max`, returning `std::nullopt` for the latter.
+        [[nodiscard]] std::optional<bytes> read_cgroup_value(const file_descriptor &fd) {
+            if (not fd) {
+                return std::nullopt;
+            }
+            const auto text = fd.read(_buffer);
+            bytes value{};
+            if (from_chars(text.data(), text.data() + text.size(), value).ec != std::errc{}) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        /// Return the path of the cgroup v2 of the process relative to the cgroup root, listed in
+        /// \a proc_root `/self/cgroup` as `0::path`.
+        [[nodiscard]] std::optional<std::string> own_cgroup_path(const std::string &proc_root) {
+            const file_descriptor cgroup(proc_root + "/self/cgroup");
+            if (not cgroup) {
+                return std::nullopt;
+            }
+            std::string_view text = cgroup.read(_buffer);
+            constexpr std::string_view unified_prefix = "0::";
+            while (not text.empty()) {
+                const auto line_end = std::min(text.find('\n'), text.size());
+                const auto line = text.substr(0, line_end);
+                text.remove_prefix(std::min(line_end + 1, text.size()));
+                if (line.starts_with(unified_prefix)) {
+                    return std::string(line.substr(unified_prefix.size()));
+                }
+            }
+            return std::nullopt;
+        }
+
+    public:
+        /// Open the files of \a proc_root and of the cgroup of the process below \a cgroup_root.
+        ///
+        /// Cgroup files that do not exist, like for a process in the root cgroup or without cgroup v2,
+        /// are not sampled.
+        ///
+        /// \throws std::system_error if `meminfo` or `self/status` below \a proc_root cannot be opened.
+        explicit memory_probe(const std::string &proc_root = "/proc", const std::string &cgroup_root = "/sys/fs/cgroup")
+            : _meminfo(open_required(proc_root + "/meminfo")),
+              _status(open_required(proc_root + "/self/status")) {
+            if (const auto cgroup_path = own_cgroup_path(proc_root)) {
+                _cgroup_directory = cgroup_root + (*cgroup_path == "/" ? "" : *cgroup_path);
+                _cgroup_max = file_descriptor(_cgroup_directory + "/memory.max");
+                _cgroup_current = file_descriptor(_cgroup_directory + "/memory.current");
+                if (not _cgroup_current) {
+                    _cgroup_directory.clear();
+                }
+            }
+        }
+
+        memory_probe(const memory_probe &) = delete;
+        memory_probe& operator=(const memory_probe &) = delete;
+
+        /// Return if the cgroup files of the process were found.
+        [[nodiscard]] bool has_cgroup() const noexcept { return static_cast<bool>(_cgroup_current); }
+
+        /// Return the directory of the cgroup of the process, which is empty without \ref has_cgroup.
+        [[nodiscard]] const std::string& cgroup_directory() const noexcept { return _cgroup_directory; }
+
+        /// Read all files and return their current values. Values not found are 0.
+        ///
+        /// \throws std::system_error if reading any file fails.
+        [[nodiscard]] memory_snapshot sample() {
+            memory_snapshot snapshot;
+            const std::array meminfo_fields{
+                field{"MemTotal", &snapshot.total},
+                field{"MemFree", &snapshot.free},
+                field{"MemAvailable", &snapshot.available},
+                field{"Cached", &snapshot.cached},
+                field{"SwapTotal", &snapshot.swap_total},
+                field{"SwapFree", &snapshot.swap_free},
+            };
+            parse_fields(_meminfo.read(_buffer), meminfo_fields);
+
+            const std::array status_fields{
+                field{"VmHWM", &snapshot.peak_rss},
+                field{"VmRSS", &snapshot.rss},
+            };
+            parse_fields(_status.read(_buffer), status_fields);
+
+            snapshot.cgroup_limit = read_cgroup_value(_cgroup_max);
+            snapshot.cgroup_usage = read_cgroup_value(_cgroup_current);
+            return snapshot;
+        }
+    };
+}
+
+#endif
+
+#endif // E10859B1_F95F_4402_82BD_DC60AD8E22B3
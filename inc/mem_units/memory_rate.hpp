@@ -0,0 +1,465 @@
+#ifndef FBE3CE72_3BB6_4B7F_8E54_264445AEA812
+#define FBE3CE72_3BB6_4B7F_8E54_264445AEA812
+
+#include "format.hpp"
+#include "sharded_memory_counter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit, RatioType Period>
+    class memory_rate;
+
+    template<typename T>
+    struct is_memory_rate : std::false_type {
+    };
+
+    template<MemoryUnitType MemoryUnit, RatioType Period>
+    struct is_memory_rate<memory_rate<MemoryUnit, Period> > : std::true_type {
+    };
+
+    template<typename T>
+    concept MemoryRateType = is_memory_rate<T>::value;
+
+    /// Converts \a from into \t ToRate, rounding down like \ref memory_unit_cast.
+    ///
+    /// Unit and period are converted in one step at compile time:
+    /// ~~~~~.cpp
+    /// assert(memory_rate_cast<kilobytes_per_second>(memory_rate<bytes, std::milli>(512_b)) == kilobytes_per_second(500_kb));
+    /// ~~~~~
+    ///
+    /// \throws std::overflow_error if the converted count does not fit into the rep type of \t ToRate
+    ///         and its overflow policy is \ref checked_overflow.
+    template<MemoryRateType ToRate, MemoryUnitType FromUnit, RatioType FromPeriod>
+    [[nodiscard]] constexpr ToRate memory_rate_cast(const memory_rate<FromUnit, FromPeriod> &from) {
+        // the amount per FromPeriod is that amount in a unit scaled by ToPeriod / FromPeriod per ToPeriod
+        using per_to_period = memory_unit<typename FromUnit::rep,
+                                          std::ratio_multiply<typename FromUnit::ratio,
+                                                              std::ratio_divide<typename ToRate::period, FromPeriod> >,
+                                          typename FromUnit::overflow_policy>;
+        return ToRate{memory_unit_cast<typename ToRate::memory_unit_type>(per_to_period{from.count()})};
+    }
+
+    /// An amount of \t MemoryUnit per \t Period, like a bandwidth or the throughput of a stream.
+    ///
+    /// Rates result from dividing a memory unit by a `std::chrono::duration` and give a memory unit back when
+    /// multiplied by one:
+    /// ~~~~~.cpp
+    /// const auto rate = 512_mb / 2s;    // memory_rate<megabytes> of 256mb/s
+    /// const megabytes sent = rate * 1min;  // 15'360_mb
+    /// std::println("{:h}", rate);       // 256mb/s
+    /// ~~~~~
+    ///
+    /// Like memory units, rates of other units and periods convert implicitly only if no precision is lost,
+    /// otherwise \ref memory_rate_cast is needed.
+    template<MemoryUnitType MemoryUnit, RatioType Period = std::ratio<1> >
+    class memory_rate {
+    public:
+        using memory_unit_type = MemoryUnit;
+        using rep = typename MemoryUnit::rep;
+        using period = Period;
+
+    private:
+        MemoryUnit _per_period{};
+
+    public:
+        constexpr memory_rate() = default;
+
+        /// Construct with \a per_period transferred each \t Period.
+        explicit constexpr memory_rate(const MemoryUnit &per_period) : _per_period(per_period) {}
+
+        /// Construct from \a other rate, whose amount per period converts to a whole amount of \t MemoryUnit
+        /// per \t Period, or if \ref rep is a floating point type.
+        template<MemoryUnitType OtherUnit, RatioType OtherPeriod>
+            requires (std::ratio_divide<std::ratio_multiply<typename OtherUnit::ratio, std::ratio_divide<Period, OtherPeriod> >,
+                                        typename MemoryUnit::ratio>::den == 1
+                      || std::is_floating_point_v<rep>)
+        explicit constexpr memory_rate(const memory_rate<OtherUnit, OtherPeriod> &other)
+            : _per_period(memory_rate_cast<memory_rate>(other).per_period()) {}
+
+        /// Return the count of \t MemoryUnit per \t Period.
+        [[nodiscard]] constexpr rep count() const { return _per_period.count(); }
+
+        /// Return the amount transferred each \t Period.
+        [[nodiscard]] constexpr MemoryUnit per_period() const { return _per_period; }
+
+        /// \throws std::overflow_error if the result does not fit into \ref rep
+        ///         and the overflow policy of \t MemoryUnit is \ref checked_overflow.
+        [[nodiscard]] constexpr memory_rate operator+(const memory_rate &other) const {
+            return memory_rate{_per_period + other._per_period};
+        }
+
+        /// \throws std::underflow_error if the result does not fit into \ref rep
+        ///         and the overflow policy of \t MemoryUnit is \ref checked_overflow.
+        [[nodiscard]] constexpr memory_rate operator-(const memory_rate &other) const {
+            return memory_rate{_per_period - other._per_period};
+        }
+    };
+
+    /// Compares \a lhs and \a rhs exactly, whatever their units and periods are.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(memory_rate<kilobytes, std::milli>(1_kb) == memory_rate<bytes>(1'024'000_b));
+    /// ~~~~~
+    template<MemoryUnitType LhsUnit, RatioType LhsPeriod, MemoryUnitType RhsUnit, RatioType RhsPeriod>
+    [[nodiscard]] constexpr auto operator<=>(const memory_rate<LhsUnit, LhsPeriod> &lhs,
+                                             const memory_rate<RhsUnit, RhsPeriod> &rhs) noexcept {
+        // lhs / LhsPeriod <=> rhs / RhsPeriod is lhs * RhsPeriod <=> rhs * LhsPeriod
+        using lhs_scaled = memory_unit<typename LhsUnit::rep, std::ratio_multiply<typename LhsUnit::ratio, RhsPeriod>,
+                                       typename LhsUnit::overflow_policy>;
+        using rhs_scaled = memory_unit<typename RhsUnit::rep, std::ratio_multiply<typename RhsUnit::ratio, LhsPeriod>,
+                                       typename RhsUnit::overflow_policy>;
+        return lhs_scaled{lhs.count()} <=> rhs_scaled{rhs.count()};
+    }
+
+    template<MemoryUnitType LhsUnit, RatioType LhsPeriod, MemoryUnitType RhsUnit, RatioType RhsPeriod>
+    [[nodiscard]] constexpr bool operator==(const memory_rate<LhsUnit, LhsPeriod> &lhs,
+                                            const memory_rate<RhsUnit, RhsPeriod> &rhs) noexcept {
+        return std::is_eq(lhs <=> rhs);
+    }
+
+    /// Returns the rate of transferring \a amount in \a time, per period of \a time and in the unit of
+    /// \a amount, with the common rep of both.
+    ///
+    /// Integral counts are divided rounding down, so a smaller unit or a floating point duration keeps
+    /// the precision:
+    /// ~~~~~.cpp
+    /// assert(1_gb / 3s == gigabytes_per_second(0_gb));
+    /// assert(bytes(1_gb) / 3s == bytes_per_second(357'913'941_b));
+    /// ~~~~~
+    ///
+    /// A negative \a time with an unsigned common rep results in a negative rate, which the rep cannot hold. It
+    /// is rejected like a zero duration, except that a \ref saturating_overflow rate is zero then.
+    ///
+    /// \throws std::overflow_error if \a time is zero, the common rep is integral
+    ///         and the overflow policy of \t MemoryUnit is \ref checked_overflow.
+    /// \throws std::underflow_error if \a time is negative, the common rep is unsigned
+    ///         and the overflow policy of \t MemoryUnit is \ref checked_overflow.
+    template<MemoryUnitType MemoryUnit, RepType DurationRep, RatioType Period>
+    [[nodiscard]] constexpr auto operator/(const MemoryUnit &amount, const std::chrono::duration<DurationRep, Period> &time) {
+        using rep = std::common_type_t<typename MemoryUnit::rep, DurationRep>;
+        using unit = with_rep_t<MemoryUnit, rep>;
+        using overflow_policy = typename MemoryUnit::overflow_policy;
+        if constexpr (std::is_unsigned_v<rep> && std::is_signed_v<DurationRep>) {
+            if (time.count() < 0) {
+                if constexpr (std::is_same_v<overflow_policy, checked_overflow>) {
+                    AFS_MEM_UNITS_THROW(std::underflow_error("Division by a negative duration!"));
+                } else {
+                    return memory_rate<unit, Period>{};
+                }
+            }
+        }
+        const auto ticks = static_cast<rep>(time.count());
+        if constexpr (std::is_integral_v<rep>) {
+            if (ticks == 0) {
+                if constexpr (std::is_same_v<overflow_policy, checked_overflow>) {
+                    AFS_MEM_UNITS_THROW(std::overflow_error("Division by a zero duration!"));
+                } else if constexpr (std::is_same_v<overflow_policy, saturating_overflow>) {
+                    return memory_rate<unit, Period>{unit{std::numeric_limits<rep>::max()}};
+                } else {
+                    return memory_rate<unit, Period>{};
+                }
+            }
+        }
+        return memory_rate<unit, Period>{unit{static_cast<rep>(static_cast<rep>(amount.count()) / ticks)}};
+    }
+
+    namespace detail {
+        /// Returns \a upper : \a lower divided by \t Divisor, in \a high the bits above 64 and in \a remainder
+        /// the remainder of the division.
+        template<std::uint64_t Divisor>
+        [[nodiscard]] constexpr std::uint64_t divide_wide(const std::uint64_t upper, const std::uint64_t lower,
+                                                          std::uint64_t &high, std::uint64_t &remainder) noexcept {
+            if constexpr (Divisor == 1) {
+                high = upper;
+                remainder = 0;
+                return lower;
+            } else {
+#ifdef __SIZEOF_INT128__
+                const auto dividend = (static_cast<unsigned __int128>(upper) << 64) | lower;
+                const auto quotient = dividend / Divisor;
+                high = static_cast<std::uint64_t>(quotient >> 64);
+                remainder = static_cast<std::uint64_t>(dividend % Divisor);
+                return static_cast<std::uint64_t>(quotient);
+#else
+                high = upper / Divisor;
+                remainder = upper % Divisor;
+                std::uint64_t quotient = 0;
+                for (int bit = 63; bit >= 0; --bit) {
+                    const bool carry = remainder >> 63;
+                    remainder = (remainder << 1) | ((lower >> bit) & 1);
+                    if (carry || remainder >= Divisor) {
+                        remainder -= Divisor;
+                        quotient |= std::uint64_t{1} << bit;
+                    }
+                }
+                return quotient;
+#endif
+            }
+        }
+
+        /// Returns \a count `*` \a ticks `*` \t TimeRatio rounded down and modulo 2^64, in \a fits if it is less
+        /// than 2^64.
+        ///
+        /// The product is computed in 128 bits, so it may overflow while the scaled result does not, like a rate
+        /// per second times nanoseconds.
+        template<RatioType TimeRatio>
+        [[nodiscard]] constexpr std::uint64_t scaled_product(const std::uint64_t count, const std::uint64_t ticks,
+                                                             bool &fits) noexcept {
+            constexpr auto num = static_cast<std::uint64_t>(TimeRatio::num);
+            constexpr auto den = static_cast<std::uint64_t>(TimeRatio::den);
+            // count * ticks * num / den is (product / den) * num + (product % den) * num / den
+            std::uint64_t product_high = 0;
+            const std::uint64_t product = multiply_wide(count, ticks, product_high);
+            std::uint64_t quotient_high = 0;
+            std::uint64_t remainder = 0;
+            const std::uint64_t quotient = divide_wide<den>(product_high, product, quotient_high, remainder);
+            std::uint64_t fraction_high = 0;
+            const std::uint64_t fraction_low = multiply_wide(remainder, num, fraction_high);
+            const std::uint64_t fraction = divide_wide<den>(fraction_high, fraction_low, fraction_high, remainder);
+            std::uint64_t amount_high = 0;
+            const std::uint64_t amount = multiply_wide(quotient, num, amount_high) + fraction;
+            fits = quotient_high == 0 && amount_high == 0 && amount >= fraction;
+            return amount;
+        }
+    }
+
+    /// Returns the amount transferred at \a rate in \a time, in the unit of \a rate with the common rep of both,
+    /// rounded down.
+    ///
+    /// ~~~~~.cpp
+    /// assert(megabytes_per_second(100_mb) * 1'500ms == 150_mb);
+    /// ~~~~~
+    ///
+    /// The overflow policy of \t MemoryUnit applies to the amount, so a \ref saturating_overflow amount that
+    /// does not fit is the limit of the common rep. Integral amounts are computed exactly in 128 bits, so a
+    /// rate per second times a duration in nanoseconds only overflows if the amount itself does not fit.
+    ///
+    /// \throws std::overflow_error if the amount does not fit into the common rep
+    ///         and the overflow policy of \t MemoryUnit is \ref checked_overflow.
+    /// \throws std::underflow_error if the amount is negative and less than the minimum of the common rep
+    ///         and the overflow policy of \t MemoryUnit is \ref checked_overflow.
+    template<MemoryUnitType MemoryUnit, RatioType Period, RepType DurationRep, RatioType DurationPeriod>
+    [[nodiscard]] constexpr auto operator*(const memory_rate<MemoryUnit, Period> &rate,
+                                           const std::chrono::duration<DurationRep, DurationPeriod> &time) {
+        using rep = std::common_type_t<typename MemoryUnit::rep, DurationRep>;
+        using unit = with_rep_t<MemoryUnit, rep>;
+        using overflow_policy = typename MemoryUnit::overflow_policy;
+        using time_ratio = std::ratio_divide<DurationPeriod, Period>;
+        // count * ticks of a unit scaled by DurationPeriod / Period, converted back to the unit of the rate
+        using scaled = memory_unit<rep, std::ratio_multiply<typename MemoryUnit::ratio, time_ratio>, overflow_policy>;
+        if constexpr (std::is_integral_v<rep> && not std::is_same_v<overflow_policy, unchecked_overflow>) {
+            // the policy applies to the amount only, not to the product of count and ticks it is scaled from
+            constexpr auto magnitude = [](const auto value) {
+                const auto bits = static_cast<std::uint64_t>(value);
+                return detail::is_negative(value) ? 0 - bits : bits;
+            };
+            const bool negative = detail::is_negative(rate.count()) != detail::is_negative(time.count());
+            bool fits = true;
+            const std::uint64_t amount = detail::scaled_product<time_ratio>(magnitude(rate.count()),
+                                                                            magnitude(time.count()), fits);
+            if constexpr (std::is_same_v<overflow_policy, wrapping_overflow>) {
+                using unsigned_type = std::common_type_t<std::make_unsigned_t<rep>, unsigned>;
+                return unit{static_cast<rep>(static_cast<unsigned_type>(negative ? 0 - amount : amount))};
+            } else {
+                // the magnitude of the minimum of a signed rep is one more than the maximum
+                constexpr auto limit = static_cast<std::uint64_t>(std::numeric_limits<rep>::max());
+                if (not negative && (not fits || amount > limit)) {
+                    if constexpr (std::is_same_v<overflow_policy, checked_overflow>) {
+                        AFS_MEM_UNITS_THROW(std::overflow_error("Multiplication would cause an overflow!"));
+                    } else {
+                        return unit{std::numeric_limits<rep>::max()};
+                    }
+                }
+                if (negative && amount != 0 && (not fits || std::is_unsigned_v<rep> || amount - 1 > limit)) {
+                    if constexpr (std::is_same_v<overflow_policy, checked_overflow>) {
+                        AFS_MEM_UNITS_THROW(std::underflow_error("Multiplication would cause an underflow!"));
+                    } else {
+                        return unit{std::numeric_limits<rep>::min()};
+                    }
+                }
+                return unit{static_cast<rep>(negative ? 0 - amount : amount)};
+            }
+        }
+        const auto count = static_cast<rep>(rate.count());
+        const auto ticks = static_cast<rep>(time.count());
+        return memory_unit_cast<unit>(scaled{static_cast<rep>(count * ticks)});
+    }
+
+    /// Returns the amount transferred at \a rate in \a time, see the overload with the rate first.
+    template<RepType DurationRep, RatioType DurationPeriod, MemoryUnitType MemoryUnit, RatioType Period>
+    [[nodiscard]] constexpr auto operator*(const std::chrono::duration<DurationRep, DurationPeriod> &time,
+                                           const memory_rate<MemoryUnit, Period> &rate) {
+        return rate * time;
+    }
+
+    /// Returns the time it takes to transfer \a amount at \a rate, in periods of \a rate.
+    ///
+    /// ~~~~~.cpp
+    /// const auto eta = remaining / meter.average_rate();
+    /// std::println("done in {:%S}s", eta);
+    /// ~~~~~
+    template<MemoryUnitType Amount, MemoryUnitType MemoryUnit, RatioType Period>
+    [[nodiscard]] constexpr std::chrono::duration<double, Period> operator/(const Amount &amount,
+                                                                            const memory_rate<MemoryUnit, Period> &rate) noexcept {
+        using fractional = memory_unit<double, typename MemoryUnit::ratio, unchecked_overflow>;
+        return std::chrono::duration<double, Period>{memory_unit_cast<fractional>(amount).count()
+                                                     / static_cast<double>(rate.count())};
+    }
+
+    using bits_per_second = memory_rate<bits>;
+    using bytes_per_second = memory_rate<bytes>;
+    using kilobytes_per_second = memory_rate<kilobytes>;
+    using megabytes_per_second = memory_rate<megabytes>;
+    using gigabytes_per_second = memory_rate<gigabytes>;
+    using terabytes_per_second = memory_rate<terabytes>;
+
+    /// Returns the suffix of \t Period as appended to a rate, e.g. `/s`.
+    template<RatioType Period>
+    [[nodiscard]] constexpr std::string_view memory_rate_suffix() {
+        if constexpr (std::ratio_equal_v<Period, std::nano>) return "/ns";
+        else if constexpr (std::ratio_equal_v<Period, std::micro>) return "/us";
+        else if constexpr (std::ratio_equal_v<Period, std::milli>) return "/ms";
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<1> >) return "/s";
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<60> >) return "/min";
+        else if constexpr (std::ratio_equal_v<Period, std::ratio<3'600> >) return "/h";
+        else return "/?";
+    }
+
+    /// Measures the throughput of a stream of memory, e.g. of a network connection or a disk.
+    ///
+    /// Producers record what they transfer on any thread, while a reporting thread updates the meter
+    /// periodically and reads the rates:
+    /// ~~~~~.cpp
+    /// throughput_meter meter;
+    /// meter.record(bytes{chunk.size()});  // on any thread
+    /// meter.update();                     // e.g. once per second
+    /// std::println("{:.1h} (last 10s: {:.1h})", meter.average_rate(), meter.window_rate());
+    /// ~~~~~
+    ///
+    /// Recording is a single relaxed atomic addition. \ref update never blocks either: if another thread is
+    /// updating already, the call returns right away. It maintains two rates:
+    /// - an exponentially weighted moving average, whose weight decays with the elapsed time instead of the
+    ///   number of updates, so it does not depend on how regularly \ref update is called,
+    /// - and the rate over a sliding window, sampled in \ref window_samples steps.
+    class throughput_meter {
+    public:
+        using clock = std::chrono::steady_clock;
+        using rate_type = memory_rate<with_rep_t<bytes, double> >;
+
+        /// Number of samples kept of the sliding window.
+        static constexpr std::size_t window_samples = 33;
+
+    private:
+        struct sample {
+            clock::time_point time;
+            std::uint64_t total;
+        };
+
+        alignas(cache_line_size) std::atomic<std::uint64_t> _total{0};
+        alignas(cache_line_size) std::atomic_flag _updating;
+        std::atomic<double> _average{0};
+        std::atomic<double> _windowed{0};
+        // only accessed by the thread holding _updating
+        std::chrono::duration<double> _time_constant;
+        clock::duration _window;
+        std::array<sample, window_samples> _samples{};
+        std::size_t _newest = 0;
+        std::size_t _sampled = 1;
+        sample _last;
+        bool _averaged = false;
+
+    public:
+        /// Construct averaging over \a time_constant and \a window, measuring from \a start.
+        explicit throughput_meter(const clock::duration time_constant = std::chrono::seconds(1),
+                                  const clock::duration window = std::chrono::seconds(10),
+                                  const clock::time_point start = clock::now())
+            : _time_constant(time_constant), _window(window), _last{start, 0} {
+            _samples[0] = _last;
+        }
+
+        throughput_meter(const throughput_meter &) = delete;
+        throughput_meter& operator=(const throughput_meter &) = delete;
+
+        /// Record that \a amount was transferred.
+        template<MemoryUnitType MemoryUnit>
+            requires std::ratio_greater_equal_v<typename MemoryUnit::ratio, std::ratio<1> >
+                     && std::is_integral_v<typename MemoryUnit::rep>
+        void record(const MemoryUnit &amount) noexcept {
+            _total.fetch_add(memory_unit_cast<unchecked_bytes>(amount).count(), std::memory_order_relaxed);
+        }
+
+        /// Update the rates with all amounts recorded until \a now, unless another thread is updating already.
+        void update(const clock::time_point now = clock::now()) noexcept {
+            if (_updating.test_and_set(std::memory_order_acquire)) {
+                return;
+            }
+            if (now > _last.time) {
+                const std::uint64_t total = _total.load(std::memory_order_relaxed);
+                const double elapsed = std::chrono::duration<double>(now - _last.time).count();
+                const double current = static_cast<double>(total - _last.total) / elapsed;
+                const double average = _average.load(std::memory_order_relaxed);
+                const double weight = _averaged ? 1 - std::exp(-elapsed / _time_constant.count()) : 1;
+                _average.store(average + weight * (current - average), std::memory_order_relaxed);
+                _averaged = true;
+                _last = {now, total};
+
+                if (now - _samples[_newest].time >= _window / static_cast<clock::rep>(window_samples - 1)) {
+                    _newest = (_newest + 1) % window_samples;
+                    _samples[_newest] = _last;
+                    _sampled = std::min(_sampled + 1, window_samples);
+                }
+                // the newest sample at or before the start of the window, or the oldest one if none is
+                std::size_t base = (_newest + window_samples + 1 - _sampled) % window_samples;
+                for (std::size_t age = _sampled; age-- > 0;) {
+                    const auto index = (_newest + window_samples - age) % window_samples;
+                    if (now - _samples[index].time < _window) {
+                        break;
+                    }
+                    base = index;
+                }
+                const auto &start = _samples[base];
+                if (now > start.time) {
+                    _windowed.store(static_cast<double>(total - start.total)
+                                    / std::chrono::duration<double>(now - start.time).count(),
+                                    std::memory_order_relaxed);
+                }
+            }
+            _updating.clear(std::memory_order_release);
+        }
+
+        /// Return all amounts recorded so far.
+        [[nodiscard]] bytes total() const noexcept { return bytes{_total.load(std::memory_order_relaxed)}; }
+
+        /// Return the exponentially weighted moving average of the rate as of the last \ref update.
+        [[nodiscard]] rate_type average_rate() const noexcept {
+            return rate_type{rate_type::memory_unit_type{_average.load(std::memory_order_relaxed)}};
+        }
+
+        /// Return the rate over the sliding window as of the last \ref update.
+        ///
+        /// The window starts at the newest sample at least the window size before the update, so it may span
+        /// up to 1/32 of the window more. Until then it starts at the construction of the meter.
+        [[nodiscard]] rate_type window_rate() const noexcept {
+            return rate_type{rate_type::memory_unit_type{_windowed.load(std::memory_order_relaxed)}};
+        }
+    };
+}
+
+namespace std {
+    /// Formats any memory rate like its amount per period, followed by the suffix of the period, e.g.
+    /// `std::format("{:.1h}", bytes(3_gb) / 2s) == "1.5gb/s"`. See the formatter of memory units for the spec.
+    template<afs::mem_units::MemoryUnitType MemoryUnit, afs::mem_units::RatioType Period>
+    struct formatter<afs::mem_units::memory_rate<MemoryUnit, Period>, char> : formatter<MemoryUnit, char> {
+        template<typename FormatContext>
+        auto format(const afs::mem_units::memory_rate<MemoryUnit, Period> &rate, FormatContext &context) const {
+            return this->format_with_suffix(rate.per_period(), afs::mem_units::memory_rate_suffix<Period>(), context);
+        }
+    };
+}
+
+#endif // FBE3CE72_3BB6_4B7F_8E54_264445AEA812
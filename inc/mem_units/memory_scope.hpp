@@ -0,0 +1,493 @@
+#ifndef D10D58C8_31E1_44C4_9F2A_3F43FBEBA659
+#define D10D58C8_31E1_44C4_9F2A_3F43FBEBA659
+
+#include "memory_probe.hpp"
+#include "sharded_memory_counter.hpp"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// Set to 0 to compile every \ref afs::mem_units::memory_scope "memory_scope" to nothing.
+#ifndef AFS_MEM_UNITS_TRACING
+#define AFS_MEM_UNITS_TRACING 1
+#endif
+
+namespace afs::mem_units {
+    /// Amounts allocated and deallocated so far, as returned by an \ref allocation_counter.
+    struct allocation_counts {
+        /// Amount allocated in total, regardless of deallocations.
+        bytes allocated{};
+        /// Amount deallocated in total.
+        bytes deallocated{};
+    };
+
+    /// A function returning the \ref allocation_counts of the calling thread, called when a \ref memory_scope
+    /// begins and ends.
+    using allocation_counter = allocation_counts (*)() noexcept;
+
+    namespace detail {
+        // constant initialized, so accounting needs no guard
+        inline thread_local allocation_counts this_thread_allocations;
+    }
+
+    /// Account an allocation of \a size to the calling thread, e.g. from a replaced `operator new`.
+    template<MemoryUnitType MemoryUnit>
+    void count_allocation(const MemoryUnit &size) noexcept {
+        detail::this_thread_allocations.allocated += memory_unit_cast<bytes>(size);
+    }
+
+    /// Account a deallocation of \a size to the calling thread, e.g. from a replaced `operator delete`.
+    template<MemoryUnitType MemoryUnit>
+    void count_deallocation(const MemoryUnit &size) noexcept {
+        detail::this_thread_allocations.deallocated += memory_unit_cast<bytes>(size);
+    }
+
+    /// Return what was passed to \ref count_allocation and \ref count_deallocation by the calling thread so
+    /// far, the default \ref allocation_counter.
+    [[nodiscard]] inline allocation_counts this_thread_allocation_counts() noexcept {
+        return detail::this_thread_allocations;
+    }
+
+    /// Return the resident set size of the process, or zero if it cannot be read.
+    ///
+    /// Reads `/proc/self/statm` on Linux, which costs a system call, and always returns zero elsewhere.
+    [[nodiscard]] inline bytes current_resident_set_size() noexcept {
+#if defined(__linux__)
+        static const file_descriptor statm("/proc/self/statm");
+        static const auto page_size = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+        std::array<char, 128> buffer{};
+        std::string_view content;
+        try {
+            content = statm.read(buffer);
+        } catch (const std::system_error &) {
+            return bytes{};
+        }
+        // the second field is the number of resident pages
+        const auto separator = content.find(' ');
+        if (separator == std::string_view::npos) {
+            return bytes{};
+        }
+        std::uint64_t pages = 0;
+        std::from_chars(content.data() + separator + 1, content.data() + content.size(), pages);
+        return bytes{pages * page_size};
+#else
+        return bytes{};
+#endif
+    }
+
+    /// What a \ref memory_scope records about its lifetime, exactly one cache line large.
+    struct memory_scope_record {
+        /// Name of the scope, which must outlive the \ref memory_tracer, like a string literal.
+        const char *name = nullptr;
+        /// When the scope began.
+        std::chrono::steady_clock::time_point begin{};
+        /// How long the scope lasted.
+        std::chrono::nanoseconds duration{};
+        /// Amount allocated by the thread within the scope, including nested scopes.
+        bytes allocated{};
+        /// Amount deallocated by the thread within the scope, including nested scopes.
+        bytes deallocated{};
+        /// Resident set size of the process when the scope began, zero unless sampled.
+        bytes rss_begin{};
+        /// Resident set size of the process when the scope ended, zero unless sampled.
+        bytes rss_end{};
+        /// The \ref this_thread_shard_index of the thread, so unique among the threads alive at once.
+        std::uint32_t thread = 0;
+        /// Number of scopes of the thread the scope is nested in.
+        std::uint32_t depth = 0;
+    };
+
+    /// A ring of \ref memory_scope_record "records" written by one thread and drained by another.
+    class memory_trace_ring {
+    public:
+        /// Number of records a ring holds before further ones are dropped.
+        static constexpr std::size_t capacity = 4'096;
+
+    private:
+        static_assert(std::has_single_bit(capacity));
+
+        alignas(cache_line_size) std::atomic<std::size_t> _head{0};
+        std::atomic<std::uint64_t> _dropped{0};
+        alignas(cache_line_size) std::atomic<std::size_t> _tail{0};
+        alignas(cache_line_size) std::array<memory_scope_record, capacity> _records;
+
+    public:
+        /// Append \a record, returning `false` and counting it as dropped if the ring is full.
+        ///
+        /// Must only be called by the thread owning the ring.
+        bool push(const memory_scope_record &record) noexcept {
+            const auto head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == capacity) {
+                _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+            _records[head & (capacity - 1)] = record;
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Pass all records pushed so far to \a consume in order, returning their number.
+        ///
+        /// Must not be called by several threads at once.
+        template<std::invocable<const memory_scope_record &> Consume>
+        std::size_t drain(Consume &&consume) {
+            const auto tail = _tail.load(std::memory_order_relaxed);
+            const auto head = _head.load(std::memory_order_acquire);
+            for (auto position = tail; position != head; ++position) {
+                consume(_records[position & (capacity - 1)]);
+            }
+            _tail.store(head, std::memory_order_release);
+            return head - tail;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+        }
+
+        /// Return the number of records dropped because the ring was full.
+        [[nodiscard]] std::uint64_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+    };
+
+    /// The process wide registry of the \ref memory_trace_ring "rings" of all threads that recorded a
+    /// \ref memory_scope, and of the \ref allocation_counter they use.
+    ///
+    /// Every thread gets its own ring on its first record, so recording takes no lock and shares no cache line
+    /// with other threads. Rings of exited threads are kept until drained.
+    class memory_tracer {
+        struct registration {
+            std::shared_ptr<memory_trace_ring> ring = std::make_shared<memory_trace_ring>();
+            std::atomic<bool> exited{false};
+        };
+
+        std::atomic<allocation_counter> _counter{&this_thread_allocation_counts};
+        std::mutex _mutex;
+        std::vector<std::shared_ptr<registration> > _registrations;
+        std::uint64_t _retired_dropped = 0;
+        std::atomic<std::uint64_t> _exiting_dropped{0};
+
+        memory_tracer() = default;
+
+        /// Return the ring of the calling thread, or `nullptr` once the thread began destroying its `thread_local`
+        /// objects, after which the ring may be freed by \ref drain any time.
+        [[nodiscard]] memory_trace_ring* this_thread_ring() {
+            // constant initialized, so reading them needs no guard, unlike the holder marking the thread as exited
+            thread_local memory_trace_ring *ring = nullptr;
+            thread_local bool exiting = false;
+            if (ring != nullptr) [[likely]] {
+                return ring;
+            }
+            if (exiting) {
+                return nullptr;
+            }
+
+            struct holder {
+                std::shared_ptr<registration> own = std::make_shared<registration>();
+
+                explicit holder(memory_tracer &tracer) {
+                    const std::scoped_lock lock(tracer._mutex);
+                    tracer._registrations.push_back(own);
+                }
+
+                ~holder() {
+                    // before marking the thread as exited, since its ring may be freed from then on
+                    ring = nullptr;
+                    exiting = true;
+                    own->exited.store(true, std::memory_order_release);
+                }
+            };
+            thread_local const holder own(*this);
+            ring = own.own->ring.get();
+            return ring;
+        }
+
+    public:
+        memory_tracer(const memory_tracer &) = delete;
+        memory_tracer& operator=(const memory_tracer &) = delete;
+
+        [[nodiscard]] static memory_tracer& instance() {
+            // never destroyed, since threads may still record after static destruction
+            static memory_tracer &tracer = *new memory_tracer;
+            return tracer;
+        }
+
+        /// Make \ref memory_scope "scopes" begun from now on count allocations by \a counter, or by
+        /// \ref this_thread_allocation_counts if it is `nullptr`.
+        void set_allocation_counter(const allocation_counter counter) noexcept {
+            _counter.store(counter != nullptr ? counter : &this_thread_allocation_counts, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] allocation_counter counter() const noexcept { return _counter.load(std::memory_order_relaxed); }
+
+        /// Append \a record to the ring of the calling thread, returning `false` if it was dropped.
+        ///
+        /// Records of scopes ending in destructors of `thread_local` objects that run after the ring was given up
+        /// are dropped.
+        bool record(const memory_scope_record &record) {
+            auto *const ring = this_thread_ring();
+            if (ring == nullptr) [[unlikely]] {
+                _exiting_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return ring->push(record);
+        }
+
+        /// Pass the records of all threads to \a consume, returning their number.
+        ///
+        /// The records of one thread are passed in the order their scopes ended, so nested scopes come first.
+        template<std::invocable<const memory_scope_record &> Consume>
+        std::size_t drain(Consume &&consume) {
+            const std::scoped_lock lock(_mutex);
+            std::size_t drained = 0;
+            std::erase_if(_registrations, [&](const std::shared_ptr<registration> &registration) {
+                const bool exited = registration->exited.load(std::memory_order_acquire);
+                drained += registration->ring->drain(consume);
+                if (exited) {
+                    _retired_dropped += registration->ring->dropped();
+                }
+                return exited;
+            });
+            return drained;
+        }
+
+        /// Return the number of records dropped because the ring of their thread was full or given up.
+        [[nodiscard]] std::uint64_t dropped() {
+            const std::scoped_lock lock(_mutex);
+            auto dropped = _retired_dropped + _exiting_dropped.load(std::memory_order_relaxed);
+            for (const auto &registration : _registrations) {
+                dropped += registration->ring->dropped();
+            }
+            return dropped;
+        }
+    };
+
+    /// Whether a \ref memory_scope samples the resident set size of the process, which costs two system calls.
+    enum class rss_sampling : bool {
+        off,
+        on
+    };
+
+#if AFS_MEM_UNITS_TRACING
+    /// Records the allocations of the current thread and optionally the growth of the resident set size
+    /// during its lifetime to the \ref memory_tracer.
+    ///
+    /// ~~~~~.cpp
+    /// void parse(std::span<const message> batch) {
+    ///     const memory_scope scope("parse_batch");
+    ///     ...
+    /// }
+    /// ~~~~~
+    ///
+    /// Scopes nest, each record holds its depth. Allocations are counted by the \ref allocation_counter set
+    /// on the tracer, which by default returns what was passed to \ref count_allocation and
+    /// \ref count_deallocation. Compiling with `AFS_MEM_UNITS_TRACING` set to 0 removes all scopes.
+    class memory_scope {
+        static inline thread_local std::uint32_t _depth = 0;
+
+        memory_scope_record _record;
+        allocation_counter _counter;
+        allocation_counts _counts_begin;
+
+    public:
+        /// Begin the scope \a name, which must outlive the \ref memory_tracer, like a string literal.
+        explicit memory_scope(const char *name, const rss_sampling rss = rss_sampling::off) noexcept
+            : _counter(memory_tracer::instance().counter()) {
+            _record.name = name;
+            _record.depth = _depth++;
+            if (rss == rss_sampling::on) {
+                _record.rss_begin = current_resident_set_size();
+            }
+            _counts_begin = _counter();
+            _record.begin = std::chrono::steady_clock::now();
+        }
+
+        memory_scope(const memory_scope &) = delete;
+        memory_scope& operator=(const memory_scope &) = delete;
+
+        /// End the scope and record it, dropping the record if the ring of the thread is full.
+        ~memory_scope() {
+            _record.duration = std::chrono::steady_clock::now() - _record.begin;
+            const auto counts_end = _counter();
+            _record.allocated = counts_end.allocated - _counts_begin.allocated;
+            _record.deallocated = counts_end.deallocated - _counts_begin.deallocated;
+            if (_record.rss_begin != bytes{}) {
+                _record.rss_end = current_resident_set_size();
+            }
+            _record.thread = static_cast<std::uint32_t>(this_thread_shard_index());
+            --_depth;
+            (void)memory_tracer::instance().record(_record);
+        }
+
+        static constexpr bool enabled = true;
+    };
+#else
+    class memory_scope {
+    public:
+        explicit constexpr memory_scope(const char *, const rss_sampling = rss_sampling::off) noexcept {}
+
+        memory_scope(const memory_scope &) = delete;
+        memory_scope& operator=(const memory_scope &) = delete;
+
+        static constexpr bool enabled = false;
+    };
+#endif
+
+    /// Writes \ref memory_scope_record "records" as complete events of the Chrome trace event format, which
+    /// `chrome://tracing` and Perfetto open.
+    ///
+    /// The trace is opened on construction and closed on destruction, so the stream holds a valid trace
+    /// only after the writer is gone.
+    class chrome_trace_writer {
+        std::ostream &_out;
+        bool _first = true;
+
+        /// Write \a duration as microseconds with three decimal places.
+        void write_microseconds(const std::chrono::nanoseconds duration) {
+            const auto count = static_cast<std::uint64_t>(duration.count());
+            std::array<char, 24> digits{};
+            const auto end = std::to_chars(digits.data(), digits.data() + digits.size(), count / 1'000).ptr;
+            _out.write(digits.data(), end - digits.data());
+            const auto fraction = count % 1'000;
+            const std::array<char, 4> decimals{'.', static_cast<char>('0' + fraction / 100),
+                                               static_cast<char>('0' + fraction / 10 % 10), static_cast<char>('0' + fraction % 10)};
+            _out.write(decimals.data(), decimals.size());
+        }
+
+        void write_string(const std::string_view text) {
+            _out.put('"');
+            for (const char character : text) {
+                if (character == '"' || character == '\\') {
+                    _out.put('\\');
+                }
+                _out.put(static_cast<unsigned char>(character) < 0x20 ? ' ' : character);
+            }
+            _out.put('"');
+        }
+
+    public:
+        explicit chrome_trace_writer(std::ostream &out) : _out(out) { _out << R"({"traceEvents":[)"; }
+
+        chrome_trace_writer(const chrome_trace_writer &) = delete;
+        chrome_trace_writer& operator=(const chrome_trace_writer &) = delete;
+
+        ~chrome_trace_writer() { _out << "]}\n"; }
+
+        void operator()(const memory_scope_record &record) {
+            _out << (_first ? "\n" : ",\n") << R"({"name":)";
+            _first = false;
+            write_string(record.name != nullptr ? record.name : "");
+            _out << R"(,"cat":"memory","ph":"X","pid":1,"tid":)" << record.thread << R"(,"ts":)";
+            write_microseconds(record.begin.time_since_epoch());
+            _out << R"(,"dur":)";
+            write_microseconds(record.duration);
+            _out << R"(,"args":{"depth":)" << record.depth << R"(,"allocated":)" << record.allocated.count()
+                 << R"(,"deallocated":)" << record.deallocated.count();
+            if (record.rss_begin != bytes{}) {
+                const auto rss_delta = static_cast<std::int64_t>(record.rss_end.count() - record.rss_begin.count());
+                _out << R"(,"rss_delta":)" << rss_delta;
+            }
+            _out << "}}";
+        }
+    };
+
+    /// Writes \ref memory_scope_record "records" in a compact binary format.
+    ///
+    /// The stream starts with the 8 characters `afsmsc01` followed by entries in native byte order, each
+    /// beginning with a one byte tag:
+    /// - `0`, a name: its 32 bit id, its 32 bit length and its characters, written before its first scope.
+    /// - `1`, a scope: the 32 bit id of its name, its 32 bit thread and depth, the 64 bit nanoseconds of its
+    ///   begin since the epoch of `std::chrono::steady_clock` and of its duration, and the 64 bit bytes
+    ///   allocated, deallocated and of the resident set size at its begin and end.
+    class binary_trace_writer {
+        std::ostream &_out;
+        std::unordered_map<const char *, std::uint32_t> _names;
+
+        template<typename... Fields>
+        void write(const Fields... fields) {
+            std::array<char, (sizeof(Fields) + ...)> buffer{};
+            std::size_t offset = 0;
+            ((std::memcpy(buffer.data() + offset, &fields, sizeof(Fields)), offset += sizeof(Fields)), ...);
+            _out.write(buffer.data(), buffer.size());
+        }
+
+        [[nodiscard]] std::uint32_t name_id(const char *name) {
+            const auto [position, inserted] = _names.try_emplace(name, static_cast<std::uint32_t>(_names.size()));
+            if (inserted) {
+                const std::string_view text = name != nullptr ? name : "";
+                write(std::uint8_t{0}, position->second, static_cast<std::uint32_t>(text.size()));
+                _out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+            return position->second;
+        }
+
+    public:
+        explicit binary_trace_writer(std::ostream &out) : _out(out) { _out.write("afsmsc01", 8); }
+
+        binary_trace_writer(const binary_trace_writer &) = delete;
+        binary_trace_writer& operator=(const binary_trace_writer &) = delete;
+
+        void operator()(const memory_scope_record &record) {
+            const auto name = name_id(record.name);
+            write(std::uint8_t{1}, name, record.thread, record.depth,
+                  static_cast<std::uint64_t>(std::chrono::nanoseconds(record.begin.time_since_epoch()).count()),
+                  static_cast<std::uint64_t>(record.duration.count()), record.allocated.count(),
+                  record.deallocated.count(), record.rss_begin.count(), record.rss_end.count());
+        }
+    };
+
+    /// A background thread draining the \ref memory_tracer periodically, and a last time on destruction.
+    ///
+    /// ~~~~~.cpp
+    /// std::ofstream file("memory.json");
+    /// chrome_trace_writer writer(file);
+    /// memory_trace_drainer drainer(std::ref(writer));
+    /// ~~~~~
+    class memory_trace_drainer {
+    public:
+        using consumer_type = std::function<void(const memory_scope_record &)>;
+
+    private:
+        consumer_type _consume;
+        std::chrono::milliseconds _interval;
+        std::mutex _mutex;
+        std::condition_variable_any _wakeup;
+        std::jthread _thread;
+
+        void run(const std::stop_token &stop) {
+            while (not stop.stop_requested()) {
+                (void)memory_tracer::instance().drain(_consume);
+                std::unique_lock lock(_mutex);
+                (void)_wakeup.wait_for(lock, stop, _interval, [] { return false; });
+            }
+        }
+
+    public:
+        /// Start a thread passing all records to \a consume every \a interval.
+        explicit memory_trace_drainer(consumer_type consume,
+                                      const std::chrono::milliseconds interval = std::chrono::milliseconds(100))
+            : _consume(std::move(consume)), _interval(interval),
+              _thread([this](const std::stop_token &stop) { run(stop); }) {}
+
+        memory_trace_drainer(const memory_trace_drainer &) = delete;
+        memory_trace_drainer& operator=(const memory_trace_drainer &) = delete;
+
+        /// Stop the thread and pass the records left to the consumer.
+        ~memory_trace_drainer() {
+            _thread.request_stop();
+            _thread.join();
+            (void)memory_tracer::instance().drain(_consume);
+        }
+    };
+}
+
+#endif // D10D58C8_31E1_44C4_9F2A_3F43FBEBA659
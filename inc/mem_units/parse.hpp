@@ -0,0 +1,199 @@
+#ifndef FFB63B7B_D98A_462E_A0F4_E179B1DB993F
+#define FFB63B7B_D98A_462E_A0F4_E179B1DB993F
+
+#include "../mem_units.hpp"
+
+#include <algorithm>
+#include <expected>
+#include <numeric>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+namespace afs::mem_units {
+    /// Returns the unit of \ref known_units denoted by \a suffix, compared case insensitive.
+    ///
+    /// Besides the suffixes of \ref known_units, the short (`k`), long (`kb`) and binary (`kib`) forms as well as
+    /// `byte`, `bytes` and `bits` are accepted. Since all units of this library are multiples of 1024, `kb` and
+    /// `kib` both denote \ref kilobytes.
+    [[nodiscard]] constexpr std::optional<unit_description> unit_from_suffix(const std::string_view suffix) {
+        constexpr auto to_lower = [](const char character) {
+            return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+        };
+        constexpr auto equals = [to_lower](const std::string_view lhs, const std::string_view rhs) {
+            return std::ranges::equal(lhs, rhs, {}, to_lower, to_lower);
+        };
+
+        if (equals(suffix, known_units[0].suffix) || equals(suffix, "bits")) {
+            return known_units[0];
+        }
+        if (equals(suffix, known_units[1].suffix) || equals(suffix, "byte") || equals(suffix, "bytes")) {
+            return known_units[1];
+        }
+        if (suffix.empty()) {
+            return std::nullopt;
+        }
+        const auto rest = suffix.substr(1);
+        if (not rest.empty() && not equals(rest, "b") && not equals(rest, "ib")) {
+            return std::nullopt;
+        }
+        for (auto unit = known_units.begin() + 2; unit != known_units.end(); ++unit) {
+            if (to_lower(suffix.front()) == unit->suffix.front()) {
+                return *unit;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Result of \ref from_chars, like `std::from_chars_result` plus whether the parsed amount was representable
+    /// exactly by the target unit.
+    struct memory_unit_from_chars_result {
+        const char *ptr;
+        std::errc ec;
+        bool exact;
+
+        friend constexpr bool operator==(const memory_unit_from_chars_result &,
+                                         const memory_unit_from_chars_result &) = default;
+    };
+
+    /// Parses an amount of memory like `4096`, `512k`, `1.5GiB` or `64 MB` from [\a first, \a last) into \a value.
+    ///
+    /// The amount is a decimal number with optional fractional digits, optionally followed by blanks and a suffix
+    /// accepted by \ref unit_from_suffix. A number without suffix is a count of bytes.
+    ///
+    /// Like `std::from_chars` this neither allocates nor throws. On success `ptr` points behind the amount and
+    /// `ec` is value initialized. If the amount is no whole multiple of \t MemoryUnit, it is rounded down and
+    /// `exact` is `false`. On failure \a value is not modified and `ec` is
+    /// - `std::errc::invalid_argument` if there is no number or its suffix is unknown, `ptr` is \a first then,
+    /// - `std::errc::result_out_of_range` if the amount does not fit into \t MemoryUnit, `ptr` points behind it.
+    template<MemoryUnitType MemoryUnit>
+        requires std::is_integral_v<typename MemoryUnit::rep>
+    constexpr memory_unit_from_chars_result from_chars(const char *first, const char *last, MemoryUnit &value) {
+#ifdef __SIZEOF_INT128__
+        using wide_uint = unsigned __int128;
+#else
+        using wide_uint = std::uintmax_t;
+#endif
+        using rep = typename MemoryUnit::rep;
+        using ratio = typename MemoryUnit::ratio;
+        constexpr auto is_digit = [](const char character) { return character >= '0' && character <= '9'; };
+        constexpr auto is_letter = [](const char character) {
+            return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z');
+        };
+        constexpr auto max_mantissa = std::numeric_limits<std::uint64_t>::max();
+
+        const char *it = first;
+        std::uint64_t mantissa = 0;
+        std::uint64_t scale = 1;
+        bool any_digit = false;
+        bool too_big = false;
+        bool truncated = false;
+        for (; it != last && is_digit(*it); ++it) {
+            const auto digit = static_cast<std::uint64_t>(*it - '0');
+            any_digit = true;
+            if (mantissa > (max_mantissa - digit) / 10) {
+                too_big = true;
+            } else {
+                mantissa = mantissa * 10 + digit;
+            }
+        }
+        if (it != last && *it == '.' && (any_digit || (it + 1 != last && is_digit(*(it + 1))))) {
+            for (++it; it != last && is_digit(*it); ++it) {
+                const auto digit = static_cast<std::uint64_t>(*it - '0');
+                any_digit = true;
+                if (scale <= max_mantissa / 10 && mantissa <= (max_mantissa - digit) / 10) {
+                    mantissa = mantissa * 10 + digit;
+                    scale *= 10;
+                } else if (digit != 0) {
+                    truncated = true;
+                }
+            }
+        }
+        if (not any_digit) {
+            return {first, std::errc::invalid_argument, false};
+        }
+
+        unit_description unit = known_units[1];
+        const char *suffix_begin = it;
+        while (suffix_begin != last && (*suffix_begin == ' ' || *suffix_begin == '\t')) {
+            ++suffix_begin;
+        }
+        const char *suffix_end = suffix_begin;
+        while (suffix_end != last && is_letter(*suffix_end)) {
+            ++suffix_end;
+        }
+        if (suffix_end != suffix_begin) {
+            const auto known = unit_from_suffix(std::string_view(suffix_begin, suffix_end));
+            if (not known) {
+                return {first, std::errc::invalid_argument, false};
+            }
+            unit = *known;
+            it = suffix_end;
+        }
+        if (too_big) {
+            return {it, std::errc::result_out_of_range, false};
+        }
+
+        // amount in MemoryUnit = mantissa / scale * unit / ratio, with both fractions reduced first
+        const auto unit_num = static_cast<std::uintmax_t>(unit.num);
+        const auto unit_den = static_cast<std::uintmax_t>(unit.den);
+        const auto target_num = static_cast<std::uintmax_t>(ratio::num);
+        const auto target_den = static_cast<std::uintmax_t>(ratio::den);
+        const auto num_gcd = std::gcd(unit_num, target_num);
+        const auto den_gcd = std::gcd(unit_den, target_den);
+        constexpr auto multiply = [](wide_uint &product, const wide_uint factor) {
+            if (factor != 0 && product > static_cast<wide_uint>(-1) / factor) {
+                return false;
+            }
+            product *= factor;
+            return true;
+        };
+        wide_uint numerator = mantissa;
+        wide_uint denominator = scale;
+        if (not multiply(numerator, unit_num / num_gcd) || not multiply(numerator, target_den / den_gcd)
+            || not multiply(denominator, unit_den / den_gcd) || not multiply(denominator, target_num / num_gcd)) {
+            return {it, std::errc::result_out_of_range, false};
+        }
+        const wide_uint count = numerator / denominator;
+        if (count > static_cast<wide_uint>(std::numeric_limits<rep>::max())) {
+            return {it, std::errc::result_out_of_range, false};
+        }
+        value = MemoryUnit{static_cast<rep>(count)};
+        return {it, std::errc{}, numerator % denominator == 0 && not truncated};
+    }
+
+    /// Parses \a text, which has to consist of a single amount of memory as accepted by \ref from_chars
+    /// and optional surrounding blanks.
+    ///
+    /// ~~~~~.cpp
+    /// static_assert(parse_memory_unit<kilobytes>("1.5 MiB") == 1'536_kb);
+    /// ~~~~~
+    ///
+    /// Returns `std::errc::invalid_argument` if \a text is malformed and `std::errc::result_out_of_range` if the
+    /// amount is not representable by \t MemoryUnit, because it is too big or no whole multiple of it.
+    template<MemoryUnitType MemoryUnit>
+        requires std::is_integral_v<typename MemoryUnit::rep>
+    constexpr std::expected<MemoryUnit, std::errc> parse_memory_unit(std::string_view text) {
+        constexpr std::string_view blanks = " \t\r\n";
+        const auto text_begin = text.find_first_not_of(blanks);
+        if (text_begin == std::string_view::npos) {
+            return std::unexpected(std::errc::invalid_argument);
+        }
+        text = text.substr(text_begin, text.find_last_not_of(blanks) - text_begin + 1);
+
+        MemoryUnit value{};
+        const auto result = from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec != std::errc{}) {
+            return std::unexpected(result.ec);
+        }
+        if (result.ptr != text.data() + text.size()) {
+            return std::unexpected(std::errc::invalid_argument);
+        }
+        if (not result.exact) {
+            return std::unexpected(std::errc::result_out_of_range);
+        }
+        return value;
+    }
+}
+
+#endif // FFB63B7B_D98A_462E_A0F4_E179B1DB993F
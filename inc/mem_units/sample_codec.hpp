@@ -0,0 +1,333 @@
+#ifndef DD656125_7A8E_446B_BF4C_9E95AC7A1EAD
+#define DD656125_7A8E_446B_BF4C_9E95AC7A1EAD
+
+#include "../mem_units.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// A compact encoding for sequences of memory unit samples, like the sizes an agent reports periodically.
+//
+// A block of samples starts with a header of three varints: the numerator and denominator of the ratio of
+// the unit, followed by the number of samples. Each sample is then stored as the zigzag varint of its
+// difference to the previous one (the first to zero), so slowly changing series take one or two bytes per
+// sample. Varints are LEB128: seven bits per byte, least significant first, the high bit set on all but the
+// last byte.
+//
+// Differences and zigzag codes are computed in separate branch free passes over chunks of samples, so
+// compilers can vectorize them. Varints of up to eight bytes are written and read as one 64 bit word,
+// with BMI2 `pdep`/`pext` when building with `-mbmi2` (e.g. via `-march=native`).
+
+namespace afs::mem_units {
+    /// Memory units that can be encoded by \ref encode_samples, i.e. those with an integral rep of up to 64 bits.
+    template<typename T>
+    concept SampleMemoryUnitType = MemoryUnitType<T>
+                                   && std::is_integral_v<typename T::rep>
+                                   && sizeof(typename T::rep) <= sizeof(std::uint64_t);
+
+    /// Header of a block written by \ref encode_samples.
+    struct sample_block_header {
+        /// Numerator of the ratio of the unit of the samples.
+        std::uint64_t ratio_num = 0;
+        /// Denominator of the ratio of the unit of the samples.
+        std::uint64_t ratio_den = 0;
+        /// Number of samples in the block.
+        std::uint64_t size = 0;
+
+        /// Returns whether the block holds samples of a unit with the ratio of \t MemoryUnit.
+        template<MemoryUnitType MemoryUnit>
+        [[nodiscard]] constexpr bool holds() const noexcept {
+            return ratio_num == static_cast<std::uint64_t>(MemoryUnit::ratio::num)
+                   && ratio_den == static_cast<std::uint64_t>(MemoryUnit::ratio::den);
+        }
+
+        friend constexpr bool operator==(const sample_block_header &, const sample_block_header &) = default;
+    };
+
+    /// Result of \ref decode_samples, like `std::from_chars_result` for a block of samples.
+    struct decode_samples_result {
+        /// The bytes behind the block, where the next block starts.
+        std::span<const std::byte> rest;
+        /// Number of samples decoded.
+        std::size_t size;
+        std::errc ec;
+    };
+
+    namespace codec {
+        /// Most bytes a varint of 64 bits takes.
+        inline constexpr std::size_t max_varint_size = 10;
+
+        /// Number of samples whose differences are computed in one pass.
+        inline constexpr std::size_t chunk_size = 256;
+
+        inline constexpr std::uint64_t low_bits = 0x7F7F'7F7F'7F7F'7F7F;
+        inline constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080;
+
+        /// Returns \a count as 64 bits, sign extended if \t Rep is signed so small negative counts stay small.
+        template<typename Rep>
+        [[nodiscard]] constexpr std::uint64_t widen(const Rep count) noexcept {
+            if constexpr (std::is_signed_v<Rep>) {
+                return static_cast<std::uint64_t>(static_cast<std::int64_t>(count));
+            } else {
+                return static_cast<std::uint64_t>(count);
+            }
+        }
+
+        [[nodiscard]] constexpr std::uint64_t zigzag(const std::uint64_t delta) noexcept {
+            return (delta << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(delta) >> 63);
+        }
+
+        [[nodiscard]] constexpr std::uint64_t unzigzag(const std::uint64_t code) noexcept {
+            return (code >> 1) ^ (0 - (code & 1));
+        }
+
+        /// Spreads the low 56 bits of \a value over the low seven bits of each byte.
+        [[nodiscard]] inline std::uint64_t spread(const std::uint64_t value) noexcept {
+#if defined(__BMI2__)
+            return _pdep_u64(value, low_bits);
+#else
+            // halves the width of the groups moved in each step: 28, 14 and 7 bits
+            auto spread = value & 0x00FF'FFFF'FFFF'FFFF;
+            spread = (spread & 0x0000'0000'0FFF'FFFF) | ((spread & 0x00FF'FFFF'F000'0000) << 4);
+            spread = (spread & 0x0000'3FFF'0000'3FFF) | ((spread & 0x0FFF'C000'0FFF'C000) << 2);
+            return (spread & 0x007F'007F'007F'007F) | ((spread & 0x3F80'3F80'3F80'3F80) << 1);
+#endif
+        }
+
+        /// Gathers the low seven bits of each byte of \a word, the inverse of \ref spread.
+        [[nodiscard]] inline std::uint64_t gather(const std::uint64_t word) noexcept {
+#if defined(__BMI2__)
+            return _pext_u64(word, low_bits);
+#else
+            // doubles the width of the groups moved in each step: 7, 14 and 28 bits
+            auto value = word & low_bits;
+            value = (value & 0x007F'007F'007F'007F) | ((value & 0x7F00'7F00'7F00'7F00) >> 1);
+            value = (value & 0x0000'3FFF'0000'3FFF) | ((value & 0x3FFF'0000'3FFF'0000) >> 2);
+            return (value & 0x0000'0000'0FFF'FFFF) | ((value & 0x0FFF'FFFF'0000'0000) >> 4);
+#endif
+        }
+
+        /// Writes \a value as varint to \a out, which must have room for \ref max_varint_size bytes.
+        inline std::byte* write_varint(std::byte *out, std::uint64_t value) noexcept {
+            if constexpr (std::endian::native == std::endian::little) {
+                if (value < std::uint64_t{1} << 56) {
+                    const auto length = static_cast<unsigned>(std::bit_width(value | 1) + 6) / 7;
+                    const auto word = spread(value) | (high_bits & ((std::uint64_t{1} << (8 * (length - 1))) - 1));
+                    std::memcpy(out, &word, sizeof(word));
+                    return out + length;
+                }
+            }
+            while (value >= 0x80) {
+                *out++ = static_cast<std::byte>(value | 0x80);
+                value >>= 7;
+            }
+            *out++ = static_cast<std::byte>(value);
+            return out;
+        }
+
+        /// Reads a varint from [\a in, \a end) into \a value, returning behind it or `nullptr` if it is
+        /// truncated or longer than 64 bits.
+        inline const std::byte* read_varint(const std::byte *in, const std::byte *end, std::uint64_t &value) noexcept {
+            if constexpr (std::endian::native == std::endian::little) {
+                if (end - in >= 8) {
+                    std::uint64_t word;
+                    std::memcpy(&word, in, sizeof(word));
+                    if (const auto stops = ~word & high_bits; stops != 0) {
+                        // keeps all bytes up to the first without continuation bit
+                        value = gather(word & (stops ^ (stops - 1)));
+                        return in + std::countr_zero(stops) / 8 + 1;
+                    }
+                }
+            }
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (in == end) {
+                    return nullptr;
+                }
+                const auto byte = std::to_integer<std::uint64_t>(*in++);
+                value |= (byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return shift == 63 && byte > 1 ? nullptr : in;
+                }
+            }
+            return nullptr;
+        }
+
+        /// Reads \a count varints from [\a in, \a end) into \a values, returning behind them or `nullptr` if one
+        /// is truncated or longer than 64 bits.
+        ///
+        /// Decodes all varints ending within the same 64 bit word at once, so only words are loaded one after
+        /// another, not every single varint.
+        inline const std::byte* read_varints(const std::byte *in, const std::byte *end, std::uint64_t *values,
+                                             const std::size_t count) noexcept {
+            std::size_t index = 0;
+            if constexpr (std::endian::native == std::endian::little) {
+                while (index < count && end - in >= 8) {
+                    std::uint64_t word;
+                    std::memcpy(&word, in, sizeof(word));
+                    auto stops = ~word & high_bits;
+                    if (stops == 0) {
+                        in = read_varint(in, end, values[index++]);
+                        if (in == nullptr) {
+                            return nullptr;
+                        }
+                        continue;
+                    }
+                    int offset = 0;
+                    do {
+                        // all bytes up to the next without continuation bit
+                        const auto through = stops ^ (stops - 1);
+                        values[index++] = gather((word & through) >> offset);
+                        offset = std::countr_zero(stops) + 1;
+                        word &= ~through;
+                        stops &= stops - 1;
+                    } while (stops != 0 && index < count);
+                    in += offset / 8;
+                }
+            }
+            for (; index < count; ++index) {
+                in = read_varint(in, end, values[index]);
+                if (in == nullptr) {
+                    return nullptr;
+                }
+            }
+            return in;
+        }
+    }
+
+    /// Returns the most bytes \ref encode_samples writes for \a size samples.
+    [[nodiscard]] constexpr std::size_t max_encoded_size(const std::size_t size) noexcept {
+        return (3 + size) * codec::max_varint_size;
+    }
+
+    /// Encodes \a samples as one block into \a out, returning the part of \a out written.
+    ///
+    /// ~~~~~.cpp
+    /// std::vector<std::byte> buffer(max_encoded_size(samples.size()));
+    /// send(encode_samples(std::span<const kilobytes>(samples), buffer));
+    /// ~~~~~
+    ///
+    /// \throws std::invalid_argument if \a out is smaller than \ref max_encoded_size of the number of \a samples.
+    template<SampleMemoryUnitType MemoryUnit>
+    std::span<std::byte> encode_samples(const std::span<const MemoryUnit> samples, const std::span<std::byte> out) {
+        if (out.size() < max_encoded_size(samples.size())) {
+            AFS_MEM_UNITS_THROW(std::invalid_argument("Span of encoded samples is too small!"));
+        }
+        std::byte *cursor = out.data();
+        cursor = codec::write_varint(cursor, static_cast<std::uint64_t>(MemoryUnit::ratio::num));
+        cursor = codec::write_varint(cursor, static_cast<std::uint64_t>(MemoryUnit::ratio::den));
+        cursor = codec::write_varint(cursor, samples.size());
+
+        std::array<std::uint64_t, codec::chunk_size> codes;
+        std::uint64_t previous = 0;
+        for (std::size_t offset = 0; offset < samples.size(); offset += codec::chunk_size) {
+            const auto chunk = samples.subspan(offset, std::min(codec::chunk_size, samples.size() - offset));
+            codes[0] = codec::zigzag(codec::widen(chunk[0].count()) - previous);
+            for (std::size_t index = 1; index < chunk.size(); ++index) {
+                codes[index] = codec::zigzag(codec::widen(chunk[index].count()) - codec::widen(chunk[index - 1].count()));
+            }
+            for (std::size_t index = 0; index < chunk.size(); ++index) {
+                cursor = codec::write_varint(cursor, codes[index]);
+            }
+            previous = codec::widen(chunk.back().count());
+        }
+        return out.first(static_cast<std::size_t>(cursor - out.data()));
+    }
+
+    /// Encodes \a samples as one block appended to \a out.
+    template<SampleMemoryUnitType MemoryUnit>
+    void encode_samples(const std::span<const MemoryUnit> samples, std::vector<std::byte> &out) {
+        const auto size = out.size();
+        out.resize(size + max_encoded_size(samples.size()));
+        const auto written = encode_samples(samples, std::span(out).subspan(size));
+        out.resize(size + written.size());
+    }
+
+    /// Returns the header of the block \a in starts with, or `std::errc::invalid_argument` if it is malformed.
+    [[nodiscard]] inline std::expected<sample_block_header, std::errc> peek_sample_block(
+        const std::span<const std::byte> in) noexcept {
+        const std::byte *cursor = in.data();
+        const std::byte *end = in.data() + in.size();
+        sample_block_header header;
+        for (auto *field : {&header.ratio_num, &header.ratio_den, &header.size}) {
+            cursor = codec::read_varint(cursor, end, *field);
+            if (cursor == nullptr) {
+                return std::unexpected(std::errc::invalid_argument);
+            }
+        }
+        if (header.ratio_num == 0 || header.ratio_den == 0) {
+            return std::unexpected(std::errc::invalid_argument);
+        }
+        return header;
+    }
+
+    /// Decodes the block \a in starts with into \a out, reading straight from \a in without copying it.
+    ///
+    /// ~~~~~.cpp
+    /// auto header = peek_sample_block(received);
+    /// std::vector<kilobytes> samples(header->size);
+    /// auto [rest, size, ec] = decode_samples(received, std::span(samples));
+    /// ~~~~~
+    ///
+    /// Like `std::from_chars` this neither allocates nor throws. On success `rest` holds the bytes behind the
+    /// block and `ec` is value initialized. On failure `rest` is \a in and `ec` is
+    /// - `std::errc::invalid_argument` if the block is malformed or truncated, or holds samples of a unit with
+    ///   another ratio than \t MemoryUnit, see \ref sample_block_header::holds,
+    /// - `std::errc::result_out_of_range` if \a out is smaller than the block or a sample does not fit into
+    ///   the rep of \t MemoryUnit.
+    ///
+    /// \a out may have been written to even on failure.
+    template<SampleMemoryUnitType MemoryUnit>
+    [[nodiscard]] decode_samples_result decode_samples(const std::span<const std::byte> in,
+                                                       const std::span<MemoryUnit> out) noexcept {
+        using rep = typename MemoryUnit::rep;
+        const auto header = peek_sample_block(in);
+        if (not header || not header->template holds<MemoryUnit>()) {
+            return {in, 0, std::errc::invalid_argument};
+        }
+        if (header->size > out.size()) {
+            return {in, 0, std::errc::result_out_of_range};
+        }
+        const auto size = static_cast<std::size_t>(header->size);
+        const std::byte *end = in.data() + in.size();
+        const std::byte *cursor = in.data();
+        std::uint64_t ignored;
+        for (int field = 0; field < 3; ++field) {
+            cursor = codec::read_varint(cursor, end, ignored);
+        }
+
+        std::array<std::uint64_t, codec::chunk_size> codes;
+        std::uint64_t previous = 0;
+        bool out_of_range = false;
+        for (std::size_t offset = 0; offset < size; offset += codec::chunk_size) {
+            const auto chunk = out.subspan(offset, std::min(codec::chunk_size, size - offset));
+            cursor = codec::read_varints(cursor, end, codes.data(), chunk.size());
+            if (cursor == nullptr) {
+                return {in, 0, std::errc::invalid_argument};
+            }
+            for (std::size_t index = 0; index < chunk.size(); ++index) {
+                previous += codec::unzigzag(codes[index]);
+                chunk[index] = MemoryUnit{static_cast<rep>(previous)};
+                out_of_range |= codec::widen(static_cast<rep>(previous)) != previous;
+            }
+        }
+        if (out_of_range) {
+            return {in, 0, std::errc::result_out_of_range};
+        }
+        return {std::span(cursor, end), size, std::errc{}};
+    }
+}
+
+#endif // DD656125_7A8E_446B_BF4C_9E95AC7A1EAD
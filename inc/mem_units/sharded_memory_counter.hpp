@@ -0,0 +1,191 @@
+#ifndef B940A3A2_F42C_460F_9B27_5F87C3C99258
+#define B940A3A2_F42C_460F_9B27_5F87C3C99258
+
+#include "../mem_units.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace afs::mem_units {
+    /// Assumed size of a cache line, used to keep independently modified counters apart.
+    ///
+    /// `std::hardware_destructive_interference_size` is not used, since its value may differ between
+    /// translation units compiled with different flags.
+    inline constexpr std::size_t cache_line_size = 64;
+
+    /// Returned by \ref this_thread_shard_index to a thread whose number was already given back, which happens in
+    /// destructors of `thread_local` objects running after the one giving it back. Since it is greater than any
+    /// shard count, callers treat it as a shard shared with other threads and modify it by atomic read-modify-write.
+    inline constexpr std::size_t shared_shard_index = std::numeric_limits<std::size_t>::max();
+
+    /// Returns a small number that is unique per thread and stable for the lifetime of the thread, up to the
+    /// destruction of its `thread_local` objects. Returns \ref shared_shard_index afterwards.
+    ///
+    /// Numbers are handed out in the order threads first call this function, so `% shard count` spreads
+    /// threads evenly over shards. The numbers of exited threads are handed out again, smallest first, so
+    /// they stay below the number of threads that called this function and are alive at once.
+    [[nodiscard]] inline std::size_t this_thread_shard_index() noexcept {
+        constexpr auto unassigned = shared_shard_index - 1;
+        // constant initialized, so reading it needs no guard, unlike the holder giving the number back
+        thread_local std::size_t index = unassigned;
+        if (index != unassigned) [[likely]] {
+            return index;
+        }
+
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::size_t> released;
+            std::size_t next = 0;
+        };
+        // never destroyed, since threads may still exit after static destruction
+        static registry &numbers = *new registry;
+
+        struct holder {
+            std::size_t number;
+
+            holder() {
+                const std::scoped_lock lock(numbers.mutex);
+                if (numbers.released.empty()) {
+                    number = numbers.next++;
+                } else {
+                    const auto smallest = std::ranges::min_element(numbers.released);
+                    number = *smallest;
+                    numbers.released.erase(smallest);
+                }
+            }
+
+            ~holder() {
+                // before giving the number back, since the next thread handed it out may be running already
+                index = shared_shard_index;
+                const std::scoped_lock lock(numbers.mutex);
+                numbers.released.push_back(number);
+            }
+        };
+        thread_local const holder own;
+        index = own.number;
+        return index;
+    }
+
+    /// A counter of \t MemoryUnit that scales with the number of threads modifying it.
+    ///
+    /// Every thread adds to and subtracts from its own cache line padded shard. Once the amount in a shard
+    /// reaches the batch size, it is folded into a shared total. Hence:
+    /// - \ref read is a single load, but lags behind by at most \ref error_bound.
+    /// - \ref snapshot sums all shards, which is exact once concurrent modifications have completed.
+    ///
+    /// ~~~~~.cpp
+    /// sharded_memory_counter<bytes> live;
+    /// live.add(4_kb);   // on every allocation
+    /// live.sub(4_kb);   // on every deallocation
+    /// const bytes approximately = live.read();
+    /// ~~~~~
+    ///
+    /// Counts are kept modulo the range of \ref rep, so shards may temporarily hold "negative" amounts
+    /// when memory is released on a thread other than the one that acquired it. No overflow checks are done.
+    template<MemoryUnitType MemoryUnit>
+        requires std::is_integral_v<typename MemoryUnit::rep>
+    class sharded_memory_counter {
+    public:
+        using value_type = MemoryUnit;
+        using rep = typename MemoryUnit::rep;
+        using ratio = typename MemoryUnit::ratio;
+
+        /// Default amount a shard accumulates before folding it into the shared total.
+        static constexpr value_type default_batch{static_cast<rep>(std::min<std::uintmax_t>(
+            std::uintmax_t{1} << 16, std::numeric_limits<rep>::max()))};
+
+    private:
+        using unsigned_rep = std::make_unsigned_t<rep>;
+        using signed_rep = std::make_signed_t<rep>;
+
+        struct alignas(cache_line_size) shard {
+            std::atomic<unsigned_rep> count{0};
+        };
+
+        alignas(cache_line_size) std::atomic<unsigned_rep> _total{0};
+        std::size_t _shard_mask;
+        unsigned_rep _batch;
+        std::unique_ptr<shard[]> _shards;
+
+        [[nodiscard]] static std::size_t default_shard_count() noexcept {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        [[nodiscard]] shard& this_thread_shard() const noexcept {
+            return _shards[this_thread_shard_index() & _shard_mask];
+        }
+
+        void modify(const unsigned_rep delta) noexcept {
+            auto &own = this_thread_shard();
+            const unsigned_rep local = own.count.fetch_add(delta, std::memory_order_relaxed) + delta;
+            const auto magnitude = static_cast<signed_rep>(local) < 0 ? static_cast<unsigned_rep>(0 - local) : local;
+            if (magnitude >= _batch) {
+                _total.fetch_add(own.count.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        /// Construct with \ref default_batch and one shard per hardware thread.
+        sharded_memory_counter() : sharded_memory_counter(default_batch) {}
+
+        /// Construct with \a shard_count shards (rounded up to a power of two), each folding into the
+        /// shared total after accumulating \a batch.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        explicit sharded_memory_counter(const memory_unit<rep, OtherRatio, OtherPolicy> &batch,
+                                        const std::size_t shard_count = default_shard_count())
+            : _shard_mask(std::bit_ceil(std::max<std::size_t>(shard_count, 1)) - 1),
+              _batch(static_cast<unsigned_rep>(std::max<rep>(memory_unit_cast<value_type>(batch).count(), 1))),
+              _shards(std::make_unique<shard[]>(_shard_mask + 1)) {}
+
+        sharded_memory_counter(const sharded_memory_counter &) = delete;
+        sharded_memory_counter& operator=(const sharded_memory_counter &) = delete;
+
+        /// Return the number of shards.
+        [[nodiscard]] std::size_t shard_count() const noexcept { return _shard_mask + 1; }
+
+        /// Return how far \ref read may lag behind \ref snapshot, ignoring modifications still in flight.
+        [[nodiscard]] value_type error_bound() const noexcept {
+            return value_type{static_cast<rep>(_batch * shard_count())};
+        }
+
+        /// Add \a value, which may have the same or a greater ratio than \t MemoryUnit.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        void add(const memory_unit<rep, OtherRatio, OtherPolicy> &value) {
+            modify(static_cast<unsigned_rep>(memory_unit_cast<value_type>(value).count()));
+        }
+
+        /// Subtract \a value, which may have the same or a greater ratio than \t MemoryUnit.
+        template<RatioType OtherRatio, OverflowPolicyType OtherPolicy>
+            requires std::ratio_greater_equal_v<OtherRatio, ratio>
+        void sub(const memory_unit<rep, OtherRatio, OtherPolicy> &value) {
+            modify(static_cast<unsigned_rep>(0 - static_cast<unsigned_rep>(memory_unit_cast<value_type>(value).count())));
+        }
+
+        /// Return the approximate total, which differs from \ref snapshot by at most \ref error_bound.
+        [[nodiscard]] value_type read() const noexcept {
+            return value_type{static_cast<rep>(_total.load(std::memory_order_relaxed))};
+        }
+
+        /// Return the exact total by summing up all shards.
+        ///
+        /// Modifications running concurrently may or may not be included.
+        [[nodiscard]] value_type snapshot() const noexcept {
+            unsigned_rep sum = _total.load(std::memory_order_acquire);
+            for (std::size_t index = 0; index < shard_count(); ++index) {
+                sum += _shards[index].count.load(std::memory_order_acquire);
+            }
+            return value_type{static_cast<rep>(sum)};
+        }
+    };
+}
+
+#endif // B940A3A2_F42C_460F_9B27_5F87C3C99258
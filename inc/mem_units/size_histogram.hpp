@@ -0,0 +1,281 @@
+#ifndef A53DDA25_B524_4D1E_92CE_E72F710C3844
+#define A53DDA25_B524_4D1E_92CE_E72F710C3844
+
+#include "memory_accumulator.hpp"
+#include "sharded_memory_counter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace afs::mem_units {
+    /// Buckets of a \ref size_histogram: a bucket for 0 followed by one per power of two of bits from
+    /// 2^0 to 2^127, each split into 2^\t SubBucketBits sub-buckets.
+    ///
+    /// All values of a bucket are at most 2^-\t SubBucketBits of its lower bound apart.
+    template<std::size_t SubBucketBits>
+        requires (SubBucketBits <= 8)
+    struct size_buckets {
+        static constexpr std::size_t sub_bucket_count = std::size_t{1} << SubBucketBits;
+        static constexpr std::size_t count = 1 + 128 * sub_bucket_count;
+
+        /// Return the index of the bucket of \a value.
+        template<AccumulableMemoryUnitType MemoryUnit>
+        [[nodiscard]] static constexpr std::size_t index(const MemoryUnit &value) noexcept {
+            constexpr std::uint64_t bits_per_count
+                = static_cast<std::uint64_t>(MemoryUnit::ratio::num) * (8 / MemoryUnit::ratio::den);
+            const auto count = static_cast<std::uint64_t>(value.count());
+            if (count == 0) {
+                return 0;
+            }
+            if constexpr (std::has_single_bit(bits_per_count)) {
+                // scaling by a power of two only moves the leading bit, the sub-bucket bits stay the same
+                const auto top = static_cast<std::size_t>(std::bit_width(count)) - 1;
+                return index_of(top + std::countr_zero(bits_per_count), top, count, 0);
+            } else {
+                std::uint64_t high = 0;
+                const std::uint64_t low = detail::multiply_wide(count, bits_per_count, high);
+                const auto top = high != 0 ? 64 + static_cast<std::size_t>(std::bit_width(high)) - 1
+                                           : static_cast<std::size_t>(std::bit_width(low)) - 1;
+                return index_of(top, top, low, high);
+            }
+        }
+
+        /// Return the smallest amount of bucket \a index, rounded down to bytes and limited to the maximum
+        /// of \ref bytes.
+        [[nodiscard]] static constexpr bytes lower_bound(const std::size_t index) noexcept {
+            if (index == 0) {
+                return bytes{0};
+            }
+            const auto [mantissa, shift] = bucket_of(index);
+            return bits_to_bytes(mantissa, shift, 0);
+        }
+
+        /// Return the largest amount of bucket \a index, rounded up to bytes and limited to the maximum
+        /// of \ref bytes.
+        [[nodiscard]] static constexpr bytes upper_bound(const std::size_t index) noexcept {
+            if (index == 0) {
+                return bytes{0};
+            }
+            const auto [mantissa, shift] = bucket_of(index);
+            return bits_to_bytes(mantissa + 1, shift, 1);
+        }
+
+    private:
+        /// Return the index of a value with its leading bit at \a exponent, whose bits \a high : \a low have
+        /// their leading bit at \a top.
+        [[nodiscard]] static constexpr std::size_t index_of(const std::size_t exponent, const std::size_t top,
+                                                            const std::uint64_t low, const std::uint64_t high) noexcept {
+            std::size_t sub_bucket = 0;
+            if constexpr (SubBucketBits > 0) {
+                constexpr std::uint64_t mask = sub_bucket_count - 1;
+                if (top >= SubBucketBits) {
+                    const auto shift = top - SubBucketBits;
+                    const std::uint64_t shifted = shift >= 64 ? high >> (shift - 64)
+                                                  : shift == 0 ? low
+                                                               : (low >> shift) | (high << (64 - shift));
+                    sub_bucket = static_cast<std::size_t>(shifted & mask);
+                } else {
+                    sub_bucket = static_cast<std::size_t>((low << (SubBucketBits - top)) & mask);
+                }
+            }
+            return 1 + (exponent << SubBucketBits) + sub_bucket;
+        }
+
+        struct bucket {
+            // the bucket starts at mantissa * 2^shift bits, where mantissa has SubBucketBits + 1 bits
+            std::uint64_t mantissa;
+            std::size_t shift;
+        };
+
+        [[nodiscard]] static constexpr bucket bucket_of(const std::size_t index) noexcept {
+            const auto exponent = (index - 1) >> SubBucketBits;
+            const auto sub_bucket = (index - 1) & (sub_bucket_count - 1);
+            const std::uint64_t mantissa = sub_bucket_count + sub_bucket;
+            if (exponent >= SubBucketBits) {
+                return {mantissa, exponent - SubBucketBits};
+            }
+            // buckets below 2^SubBucketBits bits hold single values, so their mantissa has fewer bits
+            return {mantissa >> (SubBucketBits - exponent), 0};
+        }
+
+        /// Return \a mantissa * 2^\a shift bits minus \a less, rounded up to bytes if \a less, else down.
+        [[nodiscard]] static constexpr bytes bits_to_bytes(const std::uint64_t mantissa, const std::size_t shift,
+                                                           const std::uint64_t less) noexcept {
+            constexpr auto max = std::numeric_limits<bytes::rep>::max();
+            if (shift >= 3) {
+                const auto bytes_shift = shift - 3;
+                if (bytes_shift >= 64 || static_cast<std::size_t>(std::bit_width(mantissa)) + bytes_shift > 64) {
+                    return bytes{max};
+                }
+                // mantissa * 2^shift is a whole number of bytes, so rounding up undoes subtracting less
+                return bytes{mantissa << bytes_shift};
+            }
+            const auto bits = (mantissa << shift) - less;
+            return bytes{less != 0 ? (bits + 7) / 8 : bits / 8};
+        }
+    };
+
+    /// Counts of a \ref size_histogram at one point in time, which can be merged and queried for percentiles.
+    template<std::size_t SubBucketBits = 0>
+    class size_histogram_snapshot {
+    public:
+        using buckets = size_buckets<SubBucketBits>;
+
+    private:
+        std::array<std::uint64_t, buckets::count> _counts{};
+
+    public:
+        /// Add \a times to the bucket at \a index.
+        constexpr void add(const std::size_t index, const std::uint64_t times) noexcept {
+            _counts[index] += times;
+        }
+
+        /// Merge the counts of \a other, e.g. of another thread or process.
+        constexpr size_histogram_snapshot& operator+=(const size_histogram_snapshot &other) noexcept {
+            for (std::size_t index = 0; index < buckets::count; ++index) {
+                _counts[index] += other._counts[index];
+            }
+            return *this;
+        }
+
+        friend constexpr size_histogram_snapshot operator+(size_histogram_snapshot lhs,
+                                                           const size_histogram_snapshot &rhs) noexcept {
+            lhs += rhs;
+            return lhs;
+        }
+
+        /// Return the count of bucket \a index, see \ref size_buckets.
+        [[nodiscard]] constexpr std::uint64_t count(const std::size_t index) const noexcept { return _counts[index]; }
+
+        /// Return the number of values recorded.
+        [[nodiscard]] constexpr std::uint64_t total() const noexcept {
+            return std::accumulate(_counts.begin(), _counts.end(), std::uint64_t{0});
+        }
+
+        /// Return the amount that \a fraction of all values are less than or equal to, as upper bound of its
+        /// bucket. Returns 0 bytes if the histogram is empty.
+        ///
+        /// ~~~~~.cpp
+        /// const bytes p99 = histogram.snapshot().percentile(0.99);
+        /// ~~~~~
+        [[nodiscard]] constexpr bytes percentile(const double fraction) const noexcept {
+            const auto all = total();
+            if (all == 0) {
+                return bytes{0};
+            }
+            const auto rank = std::clamp(static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(all))),
+                                         std::uint64_t{1}, all);
+            std::uint64_t seen = 0;
+            for (std::size_t index = 0; index < buckets::count; ++index) {
+                seen += _counts[index];
+                if (seen >= rank) {
+                    return buckets::upper_bound(index);
+                }
+            }
+            return buckets::upper_bound(buckets::count - 1);
+        }
+
+        /// Return the upper bound of the bucket of the smallest value, 0 bytes if empty.
+        [[nodiscard]] constexpr bytes min() const noexcept {
+            const auto found = std::ranges::find_if(_counts, [](const auto count) { return count != 0; });
+            return found == _counts.end() ? bytes{0} : buckets::upper_bound(static_cast<std::size_t>(found - _counts.begin()));
+        }
+
+        /// Return the upper bound of the bucket of the largest value, 0 bytes if empty.
+        [[nodiscard]] constexpr bytes max() const noexcept {
+            for (std::size_t index = buckets::count; index > 0; --index) {
+                if (_counts[index - 1] != 0) {
+                    return buckets::upper_bound(index - 1);
+                }
+            }
+            return bytes{0};
+        }
+
+        friend constexpr bool operator==(const size_histogram_snapshot &, const size_histogram_snapshot &) = default;
+    };
+
+    /// A histogram of amounts of memory, bucketed by powers of two of bits from \ref bits to \ref exabytes,
+    /// optionally split into 2^\t SubBucketBits sub-buckets each.
+    ///
+    /// Recording is wait-free and cheap enough to leave on for every allocation:
+    /// ~~~~~.cpp
+    /// size_histogram<2> sizes;
+    /// sizes.record(request.size);  // on any thread
+    /// const auto snapshot = sizes.snapshot();
+    /// std::println("p50 {} p99 {} max {}", snapshot.percentile(0.5), snapshot.percentile(0.99), snapshot.max());
+    /// ~~~~~
+    ///
+    /// Like \ref tracking_memory_resource every thread records to its own cache line aligned shard, by plain
+    /// loads and stores as long as it is the only thread doing so. Threads beyond \ref shard_count share
+    /// further shards by atomic increments.
+    template<std::size_t SubBucketBits = 0>
+    class size_histogram {
+    public:
+        using snapshot_type = size_histogram_snapshot<SubBucketBits>;
+        using buckets = size_buckets<SubBucketBits>;
+
+    private:
+        struct alignas(cache_line_size) shard {
+            std::array<std::atomic<std::uint64_t>, buckets::count> counts{};
+        };
+
+        std::size_t _exclusive_shards;
+        std::unique_ptr<shard[]> _shards;
+
+        [[nodiscard]] static std::size_t default_shard_count() noexcept {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+    public:
+        /// Construct with \a shard_count shards (rounded up to a power of two) for as many threads.
+        explicit size_histogram(const std::size_t shard_count = default_shard_count())
+            : _exclusive_shards(std::bit_ceil(std::max<std::size_t>(shard_count, 1))),
+              // shards beyond the exclusive ones are shared by all further threads
+              _shards(std::make_unique<shard[]>(2 * _exclusive_shards)) {}
+
+        size_histogram(const size_histogram &) = delete;
+        size_histogram& operator=(const size_histogram &) = delete;
+
+        /// Return the number of threads that record without atomic read-modify-write operations.
+        [[nodiscard]] std::size_t shard_count() const noexcept { return _exclusive_shards; }
+
+        /// Record \a value \a times.
+        template<AccumulableMemoryUnitType MemoryUnit>
+        void record(const MemoryUnit &value, const std::uint64_t times = 1) noexcept {
+            const auto index = buckets::index(value);
+            const auto thread_index = this_thread_shard_index();
+            if (thread_index < _exclusive_shards) [[likely]] {
+                auto &counter = _shards[thread_index].counts[index];
+                counter.store(counter.load(std::memory_order_relaxed) + times, std::memory_order_relaxed);
+            } else {
+                _shards[_exclusive_shards + (thread_index & (_exclusive_shards - 1))].counts[index].fetch_add(
+                    times, std::memory_order_relaxed);
+            }
+        }
+
+        /// Return the counts of all shards summed up.
+        ///
+        /// Values recorded concurrently may or may not be included.
+        [[nodiscard]] snapshot_type snapshot() const noexcept {
+            snapshot_type sum;
+            for (std::size_t shard = 0; shard < 2 * _exclusive_shards; ++shard) {
+                for (std::size_t index = 0; index < buckets::count; ++index) {
+                    sum.add(index, _shards[shard].counts[index].load(std::memory_order_relaxed));
+                }
+            }
+            return sum;
+        }
+
+        /// Clear all counts. Values recorded concurrently may or may not be cleared.
+        void reset() noexcept {
+            for (std::size_t shard = 0; shard < 2 * _exclusive_shards; ++shard) {
+                for (auto &count : _shards[shard].counts) {
+                    count.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+}
+
+#endif // A53DDA25_B524_4D1E_92CE_E72F710C3844
@@ -0,0 +1,201 @@
+#ifndef FA99DE7A_055F_488E_8F20_57561566E6C6
+#define FA99DE7A_055F_488E_8F20_57561566E6C6
+
+#include "sharded_memory_counter.hpp"
+
+#include <algorithm>
+#include <memory_resource>
+
+namespace afs::mem_units {
+    /// Number of size classes counted by a \ref tracking_memory_resource.
+    inline constexpr std::size_t allocation_size_class_count = 32;
+
+    /// Returns the size class of an allocation of \a size, i.e. the smallest `n` with `size <= 2^n`, limited
+    /// to the last class.
+    [[nodiscard]] constexpr std::size_t allocation_size_class(const bytes size) noexcept {
+        const auto count = size.count();
+        const auto width = count <= 1 ? 0 : static_cast<std::size_t>(std::bit_width(count - 1));
+        return std::min(width, allocation_size_class_count - 1);
+    }
+
+    /// Returns the largest allocation of size class \a index, the last class holds all larger ones as well.
+    [[nodiscard]] constexpr bytes allocation_size_class_limit(const std::size_t index) noexcept {
+        return bytes{bytes::rep{1} << index};
+    }
+
+    /// Statistics of the allocations done through a \ref tracking_memory_resource.
+    struct allocation_stats {
+        /// Amount currently allocated.
+        bytes live{};
+        /// Highest amount allocated at once.
+        bytes peak{};
+        /// Amount allocated in total, regardless of deallocations.
+        bytes allocated{};
+        /// Number of allocations.
+        std::uint64_t allocations = 0;
+        /// Number of deallocations.
+        std::uint64_t deallocations = 0;
+        /// Number of allocations per size class, see \ref allocation_size_class.
+        std::array<std::uint64_t, allocation_size_class_count> size_classes{};
+    };
+
+    /// A `std::pmr::memory_resource` that forwards to an upstream resource and accounts all allocations.
+    ///
+    /// Drops into any allocator aware container:
+    /// ~~~~~.cpp
+    /// tracking_memory_resource tracking;
+    /// std::pmr::vector<int> values(&tracking);
+    /// values.resize(1'000);
+    /// const bytes live = tracking.stats().live;
+    /// ~~~~~
+    ///
+    /// Like \ref sharded_memory_counter every thread accounts to its own cache line padded shard. A thread that
+    /// is the only one using its shard updates it by plain loads and stores, so accounting costs no atomic
+    /// read-modify-write operation. Only threads beyond \ref shard_count share shards and pay for them.
+    /// The amount live in a shard is folded into a shared total once it reaches the batch size. Each shard
+    /// tracks its peak as the shared total it saw when folding plus its own live amount, so
+    /// \ref allocation_stats::peak "the peak" is exact for a single thread, but may miss spikes of several
+    /// threads at once by up to \ref error_bound.
+    class tracking_memory_resource : public std::pmr::memory_resource {
+    public:
+        /// Default amount a shard accumulates before folding it into the shared total.
+        static constexpr bytes default_batch{std::uint64_t{1} << 16};
+
+    private:
+        struct alignas(cache_line_size) shard {
+            std::atomic<std::uint64_t> live{0};
+            // shared total seen when last folding, and the peak of it plus live
+            std::atomic<std::uint64_t> base{0};
+            std::atomic<std::uint64_t> peak{0};
+            std::atomic<std::uint64_t> allocated{0};
+            std::atomic<std::uint64_t> deallocations{0};
+            std::array<std::atomic<std::uint64_t>, allocation_size_class_count> size_classes{};
+        };
+
+        std::pmr::memory_resource *_upstream;
+        std::uint64_t _batch;
+        std::size_t _exclusive_shards;
+        std::unique_ptr<shard[]> _shards;
+        alignas(cache_line_size) std::atomic<std::uint64_t> _live{0};
+
+        [[nodiscard]] static std::size_t default_shard_count() noexcept {
+            return std::max(64u, 4 * std::thread::hardware_concurrency());
+        }
+
+        /// Add \a delta to \a counter, which no other thread modifies if \a exclusive.
+        static std::uint64_t bump(std::atomic<std::uint64_t> &counter, const std::uint64_t delta,
+                                  const bool exclusive) noexcept {
+            if (exclusive) [[likely]] {
+                const auto value = counter.load(std::memory_order_relaxed) + delta;
+                counter.store(value, std::memory_order_relaxed);
+                return value;
+            }
+            return counter.fetch_add(delta, std::memory_order_relaxed) + delta;
+        }
+
+        /// Fold the amount \a local live in \a own into the shared total if it reached the batch size.
+        void fold(shard &own, const std::uint64_t local, const bool exclusive) noexcept {
+            const auto magnitude = static_cast<std::int64_t>(local) < 0 ? 0 - local : local;
+            if (magnitude < _batch) [[likely]] {
+                return;
+            }
+            std::uint64_t folded = local;
+            if (exclusive) {
+                own.live.store(0, std::memory_order_relaxed);
+            } else {
+                folded = own.live.exchange(0, std::memory_order_relaxed);
+            }
+            own.base.store(_live.fetch_add(folded, std::memory_order_relaxed) + folded, std::memory_order_relaxed);
+        }
+
+        /// Return the shard of the calling thread and if that thread is the only one using it.
+        [[nodiscard]] std::pair<shard&, bool> this_thread_shard() const noexcept {
+            const auto index = this_thread_shard_index();
+            if (index < _exclusive_shards) [[likely]] {
+                return {_shards[index], true};
+            }
+            return {_shards[_exclusive_shards + (index & (_exclusive_shards - 1))], false};
+        }
+
+    protected:
+        void* do_allocate(const std::size_t size, const std::size_t alignment) override {
+            void *pointer = _upstream->allocate(size, alignment);
+            auto [own, exclusive] = this_thread_shard();
+            bump(own.allocated, size, exclusive);
+            bump(own.size_classes[allocation_size_class(bytes{size})], 1, exclusive);
+            const auto local = bump(own.live, size, exclusive);
+            const auto live = own.base.load(std::memory_order_relaxed) + local;
+            if (static_cast<std::int64_t>(live) > static_cast<std::int64_t>(own.peak.load(std::memory_order_relaxed))) {
+                own.peak.store(live, std::memory_order_relaxed);
+            }
+            fold(own, local, exclusive);
+            return pointer;
+        }
+
+        void do_deallocate(void *pointer, const std::size_t size, const std::size_t alignment) override {
+            _upstream->deallocate(pointer, size, alignment);
+            auto [own, exclusive] = this_thread_shard();
+            bump(own.deallocations, 1, exclusive);
+            fold(own, bump(own.live, 0 - std::uint64_t{size}, exclusive), exclusive);
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        /// Construct forwarding to \a upstream, with \a shard_count shards (rounded up to a power of two)
+        /// for as many threads, each folding into the shared total after accumulating \a batch.
+        template<MemoryUnitType Batch = bytes>
+        explicit tracking_memory_resource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource(),
+                                          const Batch &batch = default_batch,
+                                          const std::size_t shard_count = default_shard_count())
+            : _upstream(upstream),
+              _batch(std::max<std::uint64_t>(memory_unit_cast<bytes>(batch).count(), 1)),
+              _exclusive_shards(std::bit_ceil(std::max<std::size_t>(shard_count, 1))),
+              // shards beyond the exclusive ones are shared by all further threads
+              _shards(std::make_unique<shard[]>(2 * _exclusive_shards)) {}
+
+        tracking_memory_resource(const tracking_memory_resource &) = delete;
+        tracking_memory_resource& operator=(const tracking_memory_resource &) = delete;
+
+        /// Return the resource allocations are forwarded to.
+        [[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return _upstream; }
+
+        /// Return the number of threads that account without atomic read-modify-write operations.
+        [[nodiscard]] std::size_t shard_count() const noexcept { return _exclusive_shards; }
+
+        /// Return by how much \ref allocation_stats::peak may miss the actual peak of several threads.
+        [[nodiscard]] bytes error_bound() const noexcept {
+            return bytes{_batch * 2 * _exclusive_shards};
+        }
+
+        /// Return the statistics by summing up all shards.
+        ///
+        /// Allocations running concurrently may or may not be included.
+        [[nodiscard]] allocation_stats stats() const noexcept {
+            allocation_stats stats;
+            std::uint64_t live = _live.load(std::memory_order_acquire);
+            std::uint64_t allocated = 0;
+            std::uint64_t peak = 0;
+            for (std::size_t index = 0; index < 2 * _exclusive_shards; ++index) {
+                const auto &shard = _shards[index];
+                live += shard.live.load(std::memory_order_relaxed);
+                allocated += shard.allocated.load(std::memory_order_relaxed);
+                peak = std::max(peak, shard.peak.load(std::memory_order_relaxed));
+                stats.deallocations += shard.deallocations.load(std::memory_order_relaxed);
+                for (std::size_t size_class = 0; size_class < allocation_size_class_count; ++size_class) {
+                    const auto count = shard.size_classes[size_class].load(std::memory_order_relaxed);
+                    stats.size_classes[size_class] += count;
+                    stats.allocations += count;
+                }
+            }
+            stats.live = bytes{live};
+            stats.peak = bytes{std::max(live, peak)};
+            stats.allocated = bytes{allocated};
+            return stats;
+        }
+    };
+}
+
+#endif // FA99DE7A_055F_488E_8F20_57561566E6C6
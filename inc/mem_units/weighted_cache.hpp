@@ -0,0 +1,248 @@
+#ifndef C43A8304_2B0C_44CC_98E3_E4D3670D0792
+#define C43A8304_2B0C_44CC_98E3_E4D3670D0792
+
+#include "byte_size.hpp"
+#include "sharded_memory_counter.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace afs::mem_units {
+    /// Statistics of a \ref weighted_cache or one of its shards.
+    struct cache_stats {
+        /// Amount of all entries held.
+        bytes resident{};
+        /// Amount that can be held at most.
+        bytes capacity{};
+        /// Number of entries held.
+        std::size_t entries = 0;
+        /// Number of lookups that found an entry.
+        std::uint64_t hits = 0;
+        /// Number of lookups that found no entry.
+        std::uint64_t misses = 0;
+        /// Number of entries removed to make room for others.
+        std::uint64_t evictions = 0;
+
+        /// Return the share of lookups that found an entry, 0 if there were none.
+        [[nodiscard]] double hit_ratio() const noexcept {
+            const auto lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    /// A concurrent cache whose capacity is an amount of memory and whose entries weigh as much memory as they
+    /// take up, as told by a weigher function.
+    ///
+    /// ~~~~~.cpp
+    /// weighted_cache<std::string, std::shared_ptr<const image> > thumbnails{
+    ///     2_gb, [](const std::string &, const auto &thumbnail) { return thumbnail->size(); }};
+    ///
+    /// if (auto cached = thumbnails.get(path)) {
+    ///     return *cached;
+    /// }
+    /// thumbnails.put(path, render(path));
+    /// ~~~~~
+    ///
+    /// Keys are spread over \ref shard_count shards, each with its own lock and an equal share of the capacity,
+    /// so an entry must not weigh more than that share. Entries are evicted by the CLOCK algorithm: a hit only
+    /// marks an entry as referenced, so lookups take the lock of their shard shared. Making room sweeps over
+    /// the entries of the shard, evicting those not referenced since the last sweep.
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key> >
+    class weighted_cache {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using weigher_type = std::function<bytes(const Key &, const Value &)>;
+
+    private:
+        struct entry {
+            Key key;
+            Value value;
+            bytes weight;
+            std::atomic<bool> referenced{false};
+        };
+
+        using ring_type = std::list<entry>;
+
+        struct alignas(cache_line_size) shard {
+            mutable std::shared_mutex mutex;
+            // entries in the order the clock hand passes them, new ones are inserted right behind the hand
+            ring_type ring;
+            typename ring_type::iterator hand = ring.end();
+            std::unordered_map<Key, typename ring_type::iterator, Hash, KeyEqual> index;
+            std::uint64_t resident = 0;
+            std::uint64_t evictions = 0;
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+        };
+
+        weigher_type _weigher;
+        Hash _hash;
+        int _shard_bits;
+        std::unique_ptr<shard[]> _shards;
+        std::atomic<std::uint64_t> _shard_capacity;
+
+        [[nodiscard]] static std::size_t default_shard_count() noexcept {
+            return 4 * std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        [[nodiscard]] static bytes default_weight(const Key &key, const Value &value) noexcept {
+            return default_byte_size<Key>{}(key) + default_byte_size<Value>{}(value);
+        }
+
+        [[nodiscard]] shard& shard_of(const Key &key) const noexcept {
+            if (_shard_bits == 0) {
+                return _shards[0];
+            }
+            // the upper bits of the product depend on all bits of the hash, unlike its lower bits used by the index
+            const auto mixed = static_cast<std::uint64_t>(_hash(key)) * 0x9E37'79B9'7F4A'7C15;
+            return _shards[mixed >> (64 - _shard_bits)];
+        }
+
+        /// Remove the entry \a position points to from \a owner.
+        static void remove(shard &owner, const typename ring_type::iterator position) {
+            if (owner.hand == position) {
+                ++owner.hand;
+            }
+            owner.resident -= position->weight.count();
+            owner.index.erase(position->key);
+            owner.ring.erase(position);
+        }
+
+        /// Evict from \a owner until \a weight fits into \a capacity along with all entries held.
+        static void make_room(shard &owner, const std::uint64_t weight, const std::uint64_t capacity) {
+            while (owner.resident + weight > capacity && not owner.ring.empty()) {
+                if (owner.hand == owner.ring.end()) {
+                    owner.hand = owner.ring.begin();
+                }
+                if (owner.hand->referenced.exchange(false, std::memory_order_relaxed)) {
+                    ++owner.hand;
+                } else {
+                    remove(owner, owner.hand);
+                    ++owner.evictions;
+                }
+            }
+        }
+
+        [[nodiscard]] cache_stats stats_of(const shard &owner) const {
+            const std::shared_lock lock(owner.mutex);
+            return cache_stats{
+                .resident = bytes{owner.resident},
+                .capacity = bytes{_shard_capacity.load(std::memory_order_relaxed)},
+                .entries = owner.index.size(),
+                .hits = owner.hits.load(std::memory_order_relaxed),
+                .misses = owner.misses.load(std::memory_order_relaxed),
+                .evictions = owner.evictions,
+            };
+        }
+
+    public:
+        /// Construct holding up to \a capacity, weighing entries by \a weigher, with \a shard_count shards
+        /// (rounded up to a power of two).
+        ///
+        /// Without \a weigher entries weigh the \ref default_byte_size of their key and value.
+        template<MemoryUnitType Capacity>
+        explicit weighted_cache(const Capacity &capacity, weigher_type weigher = &weighted_cache::default_weight,
+                                const std::size_t shard_count = default_shard_count(), Hash hash = Hash{})
+            : _weigher(weigher ? std::move(weigher) : weigher_type(&weighted_cache::default_weight)), _hash(std::move(hash)),
+              _shard_bits(std::countr_zero(std::bit_ceil(std::max<std::size_t>(shard_count, 1)))),
+              _shards(std::make_unique<shard[]>(std::size_t{1} << _shard_bits)),
+              _shard_capacity(memory_unit_cast<bytes>(capacity).count() >> _shard_bits) {}
+
+        weighted_cache(const weighted_cache &) = delete;
+        weighted_cache& operator=(const weighted_cache &) = delete;
+
+        /// Return a copy of the value of \a key, or `std::nullopt` if it is not cached.
+        [[nodiscard]] std::optional<Value> get(const Key &key) const {
+            shard &owner = shard_of(key);
+            const std::shared_lock lock(owner.mutex);
+            const auto found = owner.index.find(key);
+            if (found == owner.index.end()) {
+                owner.misses.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            owner.hits.fetch_add(1, std::memory_order_relaxed);
+            auto &referenced = found->second->referenced;
+            if (not referenced.load(std::memory_order_relaxed)) {
+                referenced.store(true, std::memory_order_relaxed);
+            }
+            return found->second->value;
+        }
+
+        /// Cache \a value for \a key, replacing the previous value and evicting other entries as needed.
+        ///
+        /// Returns `false` without caching \a value if it weighs more than the capacity of a shard, in which
+        /// case a previous value of \a key is removed.
+        bool put(Key key, Value value) {
+            const auto weight = _weigher(key, value).count();
+            shard &owner = shard_of(key);
+            const std::unique_lock lock(owner.mutex);
+            if (const auto found = owner.index.find(key); found != owner.index.end()) {
+                remove(owner, found->second);
+            }
+            const auto capacity = _shard_capacity.load(std::memory_order_relaxed);
+            if (weight > capacity) {
+                return false;
+            }
+            make_room(owner, weight, capacity);
+            const auto position = owner.ring.emplace(owner.hand, std::move(key), std::move(value), bytes{weight});
+            owner.index.emplace(position->key, position);
+            owner.resident += weight;
+            return true;
+        }
+
+        /// Remove \a key, returning if it was cached.
+        bool erase(const Key &key) {
+            shard &owner = shard_of(key);
+            const std::unique_lock lock(owner.mutex);
+            const auto found = owner.index.find(key);
+            if (found == owner.index.end()) {
+                return false;
+            }
+            remove(owner, found->second);
+            return true;
+        }
+
+        /// Change the capacity to \a capacity, evicting entries right away if it shrinks.
+        template<MemoryUnitType Capacity>
+        void set_capacity(const Capacity &capacity) {
+            const auto shard_capacity = memory_unit_cast<bytes>(capacity).count() >> _shard_bits;
+            _shard_capacity.store(shard_capacity, std::memory_order_relaxed);
+            for (std::size_t index = 0; index < shard_count(); ++index) {
+                const std::unique_lock lock(_shards[index].mutex);
+                make_room(_shards[index], 0, shard_capacity);
+            }
+        }
+
+        /// Return the amount that can be held at most.
+        [[nodiscard]] bytes capacity() const noexcept {
+            return bytes{_shard_capacity.load(std::memory_order_relaxed) << _shard_bits};
+        }
+
+        [[nodiscard]] std::size_t shard_count() const noexcept { return std::size_t{1} << _shard_bits; }
+
+        /// Return the statistics of shard \a index.
+        [[nodiscard]] cache_stats shard_stats(const std::size_t index) const { return stats_of(_shards[index]); }
+
+        /// Return the statistics of all shards summed up.
+        [[nodiscard]] cache_stats stats() const {
+            cache_stats sum;
+            for (std::size_t index = 0; index < shard_count(); ++index) {
+                const auto shard = stats_of(_shards[index]);
+                sum.resident += shard.resident;
+                sum.capacity += shard.capacity;
+                sum.entries += shard.entries;
+                sum.hits += shard.hits;
+                sum.misses += shard.misses;
+                sum.evictions += shard.evictions;
+            }
+            return sum;
+        }
+    };
+}
+
+#endif // C43A8304_2B0C_44CC_98E3_E4D3670D0792
@@ -0,0 +1,78 @@
+#include "mem_units/alignment.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(AnAlignment, RoundsUpToPowerOfTwo) {
+    static_assert(align_up(5'000_b, 4_kb) == 8_kb);
+    ASSERT_THAT(align_up(1_b, 2_mb), Eq(2_mb));
+    ASSERT_THAT(align_up(2_mb, 2_mb), Eq(2_mb));
+    ASSERT_THAT(align_up(0_b, 4_kb), Eq(0_b));
+    ASSERT_THAT(align_up(3_gb + 1_b, 1_gb), Eq(4_gb));
+}
+
+TEST(AnAlignment, RoundsDownToPowerOfTwo) {
+    static_assert(align_down(5'000_b, 4_kb) == 4_kb);
+    ASSERT_THAT(align_down(4'095_b, 4_kb), Eq(0_b));
+    ASSERT_THAT(align_down(5_mb, 2_mb), Eq(4_mb));
+}
+
+TEST(AnAlignment, SupportsOtherAlignments) {
+    ASSERT_THAT(align_up(100_b, 48_b), Eq(144_b));
+    ASSERT_THAT(align_down(100_b, 48_b), Eq(96_b));
+    ASSERT_TRUE(is_aligned(96_b, 48_b));
+    ASSERT_FALSE(is_aligned(100_b, 48_b));
+    ASSERT_THAT(pages_in(100_b, 48_b), Eq(3));
+}
+
+TEST(AnAlignment, ChecksWhetherValueIsAligned) {
+    static_assert(is_aligned(6_mb, 2_mb));
+    ASSERT_TRUE(is_aligned(0_b, 64_b));
+    ASSERT_FALSE(is_aligned(65_b, 64_b));
+    ASSERT_TRUE(is_aligned(1_kb, 1_kb));
+}
+
+TEST(AnAlignment, CountsPagesRoundingUp) {
+    static_assert(pages_in(5'000_b, 4_kb) == 2);
+    ASSERT_THAT(pages_in(0_b, 4_kb), Eq(0));
+    ASSERT_THAT(pages_in(8_kb, 4_kb), Eq(2));
+    ASSERT_THAT(pages_in(bytes(std::numeric_limits<std::uint64_t>::max()), 4_kb), Eq(std::uint64_t{1} << 52));
+}
+
+TEST(AnAlignment, DoesNotOverflowNearTopOfRep) {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    const bytes aligned(max & ~std::uint64_t{4'095});
+    ASSERT_THAT(align_up(aligned, 4_kb), Eq(aligned));
+    ASSERT_THROW(std::ignore = align_up(aligned + 1_b, 4_kb), std::overflow_error);
+    ASSERT_THAT(align_up(saturating_bytes(max - 1), 4_kb).count(), Eq(max));
+    ASSERT_THAT(align_up(wrapping_bytes(max - 1), 4_kb).count(), Eq(0));
+    ASSERT_THAT(align_down(bytes(max), 4_kb), Eq(aligned));
+}
+
+TEST(AnAlignment, ThrowsOnZeroOrUnrepresentableAlignment) {
+    ASSERT_THROW(std::ignore = align_up(1_b, 0_kb), std::invalid_argument);
+    ASSERT_THROW(std::ignore = is_aligned(1_b, 0_b), std::invalid_argument);
+    ASSERT_THROW(std::ignore = align_up(1_b, 16_eb), std::overflow_error);
+}
+
+TEST(AnAlignment, WorksWithCompactReps) {
+    ASSERT_THAT(align_up(kilobytes16(3), 2_mb).count(), Eq(2'048));
+    ASSERT_THAT(pages_in(kilobytes16(65'535), 4_kb), Eq(16'384));
+}
+
+TEST(APageSize, IsAPowerOfTwoOfAtLeast4Kb) {
+    ASSERT_TRUE(std::has_single_bit(page_size().count()));
+    ASSERT_TRUE(page_size() >= 4_kb);
+    ASSERT_THAT(page_size(), Eq(bytes(static_cast<bytes::rep>(sysconf(_SC_PAGESIZE)))));
+}
@@ -0,0 +1,127 @@
+#include "mem_units/arena.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    template<MemoryUnitType auto Amount>
+    struct sized {
+        static constexpr auto amount = Amount;
+    };
+
+    bool is_aligned_to(const void *pointer, const std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+    }
+}
+
+TEST(AMemoryUnit, IsUsableAsTemplateArgument) {
+    static_assert(sized<64_mb>::amount == 64_mb);
+    static_assert(std::is_same_v<sized<1_kb>, sized<kilobytes{1}>>);
+    static_assert(not std::is_same_v<sized<1_kb>, sized<2_kb>>);
+    static_assert(byte_count_v<16_mb> == 16 * 1'024 * 1'024);
+}
+
+TEST(AMonotonicArena, ComputesItsSizesAtCompileTime) {
+    static_assert(monotonic_arena<64_mb>::capacity() == 64_mb);
+    static_assert(monotonic_arena<64_mb>::alignment() == default_allocation_alignment);
+    static_assert(monotonic_arena<1_kb, 64_b>::alignment_count == 64);
+}
+
+TEST(AMonotonicArena, HandsOutAlignedMemory) {
+    monotonic_arena<4_kb, 64_b> arena;
+    void *first = arena.allocate(10);
+    void *second = arena.allocate(10);
+    void *third = arena.allocate(1, 1);
+    void *page = arena.allocate(8, 1'024);
+    ASSERT_TRUE(is_aligned_to(first, 64));
+    ASSERT_TRUE(is_aligned_to(second, 64));
+    ASSERT_TRUE(is_aligned_to(page, 1'024));
+    ASSERT_THAT(static_cast<std::byte *>(second) - static_cast<std::byte *>(first), Eq(64));
+    ASSERT_THAT(static_cast<std::byte *>(third) - static_cast<std::byte *>(second), Eq(10));
+    ASSERT_TRUE(arena.owns(third));
+    ASSERT_FALSE(arena.owns(&arena));
+}
+
+TEST(AMonotonicArena, ReportsUsage) {
+    monotonic_arena<1_kb, 16_b> arena;
+    ASSERT_THAT(arena.used(), Eq(0_b));
+    (void) arena.allocate(100);
+    (void) arena.allocate(100);
+    ASSERT_THAT(arena.used(), Eq(212_b));
+    ASSERT_THAT(arena.remaining(), Eq(812_b));
+}
+
+TEST(AMonotonicArena, FailsWhenExhausted) {
+    monotonic_arena<1_kb> arena;
+    (void) arena.allocate(1'000);
+    ASSERT_THAT(arena.try_allocate(100), Eq(nullptr));
+    ASSERT_THROW((void) arena.allocate(100), std::bad_alloc);
+    ASSERT_THAT(arena.try_allocate(std::numeric_limits<std::size_t>::max()), Eq(nullptr));
+}
+
+TEST(AMonotonicArena, ReleasesEverythingOnReset) {
+    monotonic_arena<1_kb> arena;
+    void *first = arena.allocate(1'024);
+    arena.reset();
+    ASSERT_THAT(arena.used(), Eq(0_b));
+    ASSERT_THAT(arena.allocate(1'024), Eq(first));
+}
+
+TEST(ABlockPool, ComputesItsSizesAtCompileTime) {
+    using pool = block_pool<256_b, 16_mb>;
+    static_assert(pool::block_count == 65'536);
+    static_assert(pool::block_size() == 256_b);
+    static_assert(pool::capacity() == 16_mb);
+    static_assert(block_pool<1_b, 1_kb>::block_size() == default_allocation_alignment);
+    static_assert(block_pool<100_b, 1_kb, 64_b>::block_size() == 128_b);
+    static_assert(block_pool<100_b, 1_kb, 64_b>::block_count == 8);
+}
+
+TEST(ABlockPool, HandsOutDistinctAlignedBlocks) {
+    block_pool<100_b, 1_kb, 64_b> pool;
+    std::vector<void *> blocks;
+    while (void *block = pool.try_allocate()) {
+        ASSERT_TRUE(is_aligned_to(block, 64));
+        ASSERT_TRUE(pool.owns(block));
+        blocks.push_back(block);
+    }
+    ASSERT_THAT(blocks.size(), Eq(8));
+    std::ranges::sort(blocks);
+    ASSERT_THAT(std::ranges::adjacent_find(blocks), Eq(blocks.end()));
+    ASSERT_THROW((void) pool.allocate(), std::bad_alloc);
+}
+
+TEST(ABlockPool, ReusesFreedBlocks) {
+    block_pool<64_b, 1_kb> pool;
+    void *first = pool.allocate();
+    void *second = pool.allocate();
+    pool.deallocate(first);
+    ASSERT_THAT(pool.allocate(), Eq(first));
+    pool.deallocate(second);
+    ASSERT_THAT(pool.allocate(), Eq(second));
+}
+
+TEST(ABlockPool, ReportsUsage) {
+    block_pool<256_b, 1_mb> pool;
+    void *first = pool.allocate();
+    (void) pool.allocate();
+    ASSERT_THAT(pool.used(), Eq(512_b));
+    pool.deallocate(first);
+    ASSERT_THAT(pool.used(), Eq(256_b));
+    ASSERT_THAT(pool.remaining(), Eq(1_mb - 256_b));
+    pool.reset();
+    ASSERT_THAT(pool.used(), Eq(0_b));
+}
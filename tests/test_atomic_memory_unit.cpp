@@ -0,0 +1,138 @@
+#include "mem_units/atomic_memory_unit.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(AnAtomicMemoryUnit, HasCountOf0WhenDefaultConstructed) {
+    const atomic_memory_unit<bytes> unit;
+    ASSERT_THAT(unit.load(), Eq(0_b));
+}
+
+TEST(AnAtomicMemoryUnit, IsLockFreeFor64BitReps) {
+    static_assert(atomic_memory_unit<bytes>::is_always_lock_free);
+    static_assert(atomic_memory_unit<unchecked_exabytes>::is_always_lock_free);
+    ASSERT_TRUE(atomic_memory_unit<bytes>().is_lock_free());
+}
+
+TEST(AnAtomicMemoryUnit, IsConstructibleFromGreaterRatio) {
+    const atomic_memory_unit<bytes> unit(2_kb);
+    ASSERT_THAT(unit.load(), Eq(2'048_b));
+}
+
+TEST(AnAtomicMemoryUnit, StoresAndExchangesUnitsWithGreaterRatio) {
+    atomic_memory_unit<kilobytes> unit;
+    unit.store(3_mb);
+    ASSERT_THAT(unit.exchange(1_gb), Eq(3'072_kb));
+    ASSERT_THAT(unit.load(), Eq(1_gb));
+}
+
+TEST(AnAtomicMemoryUnit, FetchAddReturnsPreviousValue) {
+    atomic_memory_unit<bytes> unit(42_b);
+    ASSERT_THAT(unit.fetch_add(1_kb), Eq(42_b));
+    ASSERT_THAT(unit.load(), Eq(1'066_b));
+}
+
+TEST(AnAtomicMemoryUnit, FetchSubReturnsPreviousValue) {
+    atomic_memory_unit<bytes> unit(2_kb);
+    ASSERT_THAT(unit.fetch_sub(1_kb), Eq(2_kb));
+    ASSERT_THAT(unit.load(), Eq(1_kb));
+}
+
+TEST(AnAtomicMemoryUnit, CompoundAssignmentReturnsNewValue) {
+    atomic_memory_unit<megabytes> unit;
+    ASSERT_THAT(unit += 1_gb, Eq(1'024_mb));
+    ASSERT_THAT(unit -= 24_mb, Eq(1'000_mb));
+}
+
+TEST(AnAtomicMemoryUnit, CompareExchangeReplacesExpectedValue) {
+    atomic_memory_unit<bytes> unit(1_kb);
+    bytes expected(1_kb);
+    ASSERT_TRUE(unit.compare_exchange_strong(expected, 2_kb));
+    ASSERT_THAT(unit.load(), Eq(2_kb));
+}
+
+TEST(AnAtomicMemoryUnit, CompareExchangeLoadsCurrentValueOnMismatch) {
+    atomic_memory_unit<bytes> unit(1_kb);
+    bytes expected = 4_b;
+    ASSERT_FALSE(unit.compare_exchange_strong(expected, 2_kb));
+    ASSERT_THAT(expected, Eq(1_kb));
+}
+
+TEST(AnAtomicMemoryUnit, FetchAddThrowsOnOverflowAndKeepsValue) {
+    using test_unit = memory_unit<std::uint8_t, std::ratio<1>>;
+    atomic_memory_unit<test_unit> unit(test_unit(250));
+    ASSERT_THROW(unit.fetch_add(test_unit(10)), std::overflow_error);
+    ASSERT_THAT(unit.load().count(), Eq(250));
+}
+
+TEST(AnAtomicMemoryUnit, FetchSubThrowsOnUnderflowAndKeepsValue) {
+    atomic_memory_unit<bytes> unit(1_b);
+    ASSERT_THROW(unit.fetch_sub(2_b), std::underflow_error);
+    ASSERT_THAT(unit.load(), Eq(1_b));
+}
+
+TEST(AnAtomicMemoryUnit, SaturatesWithSaturatingPolicy) {
+    atomic_memory_unit<saturating_bytes> unit(saturating_bytes(1));
+    unit.fetch_sub(saturating_bytes(2));
+    ASSERT_THAT(unit.load().count(), Eq(0));
+}
+
+TEST(AnAtomicMemoryUnit, WrapsWithWrappingPolicy) {
+    atomic_memory_unit<wrapping_bytes> unit;
+    unit.fetch_sub(wrapping_bytes(1));
+    ASSERT_THAT(unit.load().count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+}
+
+TEST(AnAtomicMemoryUnit, KeepsExactTotalUnderConcurrentModification) {
+    constexpr int thread_count = 16;
+    constexpr int iterations = 20'000;
+    atomic_memory_unit<bytes> live;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&live] {
+            for (int i = 0; i < iterations; ++i) {
+                live.fetch_add(3_kb);
+                live.fetch_sub(2'048_b);
+                live += 1_b;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_THAT(live.load(), Eq(bytes(thread_count * iterations * 1'025ULL)));
+}
+
+TEST(AnAtomicMemoryUnit, KeepsExactTotalUnderConcurrentCompareExchange) {
+    constexpr int thread_count = 8;
+    constexpr int iterations = 10'000;
+    atomic_memory_unit<kilobytes> live;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&live] {
+            for (int i = 0; i < iterations; ++i) {
+                auto expected = live.load(std::memory_order_relaxed);
+                while (not live.compare_exchange_weak(expected, expected + 1_kb)) {
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_THAT(live.load(), Eq(kilobytes(thread_count * iterations)));
+}
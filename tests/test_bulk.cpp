@@ -0,0 +1,198 @@
+#include "mem_units/bulk.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+// also built with exceptions disabled, see CMakeLists.txt
+
+namespace {
+    template<MemoryUnitType MemoryUnit>
+    std::vector<MemoryUnit> random_units(const std::size_t size, const int shift = 8) {
+        std::mt19937_64 random(size);
+        std::vector<MemoryUnit> units;
+        for (std::size_t index = 0; index < size; ++index) {
+            units.emplace_back(random() >> shift);
+        }
+        return units;
+    }
+
+    // sizes around the vector widths, so every path including the scalar tail is hit
+    constexpr std::array<std::size_t, 8> sizes{0, 1, 3, 4, 7, 8, 17, 1'000};
+}
+
+TEST(ABulkSum, EqualsSumOfElements) {
+    for (const auto size : sizes) {
+        const auto units = random_units<bytes>(size, 16);
+        const auto expected = std::accumulate(units.begin(), units.end(), 0_b);
+        ASSERT_THAT(sum<bytes>(units), Eq(expected)) << size;
+    }
+}
+
+#if defined(__cpp_exceptions)
+TEST(ABulkSum, ThrowsOnceOnOverflow) {
+    for (const auto size : sizes) {
+        auto units = random_units<bytes>(std::max<std::size_t>(size, 2), 1);
+        units.back() = bytes(std::numeric_limits<bytes::rep>::max());
+        ASSERT_THROW(std::ignore = sum<bytes>(units), std::overflow_error) << size;
+    }
+}
+
+TEST(ABulkSum, DetectsOverflowWithinSingleLane) {
+    std::vector<bytes> units(16, bytes(1ULL << 62));
+    ASSERT_THROW(std::ignore = sum<bytes>(units), std::overflow_error);
+}
+#endif
+
+TEST(ABulkSum, HandlesOverflowAccordingToPolicy) {
+    const std::vector<saturating_bytes> saturating(9, saturating_bytes(1ULL << 62));
+    ASSERT_THAT(sum<saturating_bytes>(saturating).count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+    const std::vector<wrapping_bytes> wrapping(9, wrapping_bytes(1ULL << 62));
+    ASSERT_THAT(sum<wrapping_bytes>(wrapping).count(), Eq(1ULL << 62));
+}
+
+TEST(ABulkSum, CountsCarriesBeyondRangeOfNarrowReps) {
+    // 65'538 * 65'535 wraps 65'536 times, which a carry counter of the rep itself would count as 0
+    const std::vector<bytes16> units(65'538, bytes16(std::numeric_limits<std::uint16_t>::max()));
+#if defined(__cpp_exceptions)
+    ASSERT_THROW(std::ignore = sum<bytes16>(units), std::overflow_error);
+#endif
+    using saturating_bytes16 = with_rep_t<saturating_bytes, std::uint16_t>;
+    const std::vector<saturating_bytes16> saturating(65'538, saturating_bytes16(std::numeric_limits<std::uint16_t>::max()));
+    ASSERT_THAT(sum<saturating_bytes16>(saturating).count(), Eq(std::numeric_limits<std::uint16_t>::max()));
+}
+
+TEST(ABulkSum, CountsCarriesBeyondRangeOfByteReps) {
+    // 258 * 255 wraps 256 times
+    using bytes8 = with_rep_t<bytes, std::uint8_t>;
+    const std::vector<bytes8> units(258, bytes8(std::numeric_limits<std::uint8_t>::max()));
+#if defined(__cpp_exceptions)
+    ASSERT_THROW(std::ignore = sum<bytes8>(units), std::overflow_error);
+#endif
+    using saturating_bytes8 = with_rep_t<saturating_bytes, std::uint8_t>;
+    const std::vector<saturating_bytes8> saturating(258, saturating_bytes8(std::numeric_limits<std::uint8_t>::max()));
+    ASSERT_THAT(sum<saturating_bytes8>(saturating).count(), Eq(std::numeric_limits<std::uint8_t>::max()));
+}
+
+TEST(ABulkConvert, ShiftsToSmallerRatio) {
+    for (const auto size : sizes) {
+        const auto units = random_units<kilobytes>(size, 16);
+        std::vector<bytes> converted(size);
+        convert<bytes, kilobytes>(units, converted);
+        for (std::size_t index = 0; index < size; ++index) {
+            ASSERT_THAT(converted[index], Eq(memory_unit_cast<bytes>(units[index])));
+        }
+    }
+}
+
+TEST(ABulkConvert, ShiftsToGreaterRatio) {
+    for (const auto size : sizes) {
+        const auto units = random_units<bits>(size);
+        std::vector<megabytes> converted(size);
+        convert<megabytes, bits>(units, converted);
+        for (std::size_t index = 0; index < size; ++index) {
+            ASSERT_THAT(converted[index], Eq(memory_unit_cast<megabytes>(units[index])));
+        }
+    }
+}
+
+TEST(ABulkConvert, ConvertsNonPowerOfTwoRatios) {
+    using decimal_kilobytes = memory_unit<std::uint64_t, std::ratio<1'000>>;
+    const std::vector<kilobytes> units{1_kb, 2_kb, 1'000_kb};
+    std::vector<decimal_kilobytes> converted(units.size());
+    convert<decimal_kilobytes, kilobytes>(units, converted);
+    ASSERT_THAT(converted[0].count(), Eq(1));
+    ASSERT_THAT(converted[1].count(), Eq(2));
+    ASSERT_THAT(converted[2].count(), Eq(1'024));
+}
+
+#if defined(__cpp_exceptions)
+TEST(ABulkConvert, ThrowsOnceOnOverflow) {
+    for (const auto size : sizes) {
+        if (size == 0) {
+            continue;
+        }
+        auto units = random_units<gigabytes>(size, 40);
+        units[size / 2] = gigabytes(1ULL << 40);
+        std::vector<bits> converted(size);
+        ASSERT_THROW((convert<bits, gigabytes>(units, converted)), std::overflow_error) << size;
+    }
+}
+#endif
+
+TEST(ABulkConvert, SaturatesOverflowingElementsOnly) {
+    const std::vector<saturating_gigabytes> units(9, saturating_gigabytes(2));
+    std::vector<saturating_bits> converted(units.size());
+    std::vector<saturating_gigabytes> overflowing = units;
+    overflowing[5] = saturating_gigabytes(1ULL << 40);
+    convert<saturating_bits, saturating_gigabytes>(overflowing, converted);
+    ASSERT_THAT(converted[4].count(), Eq(2ULL << 33));
+    ASSERT_THAT(converted[5].count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+}
+
+#if defined(__cpp_exceptions)
+TEST(ABulkConvert, RejectsTooSmallOutput) {
+    const std::vector<kilobytes> units(4);
+    std::vector<bytes> converted(3);
+    ASSERT_THROW((convert<bytes, kilobytes>(units, converted)), std::invalid_argument);
+}
+#endif
+
+TEST(ABulkCountGreater, CountsElementsAboveThreshold) {
+    for (const auto size : sizes) {
+        const auto units = random_units<bytes>(size);
+        const bytes threshold(1ULL << 55);
+        const auto expected = std::ranges::count_if(units, [&](const bytes unit) { return unit > threshold; });
+        ASSERT_THAT(count_greater<bytes>(units, threshold), Eq(static_cast<std::size_t>(expected))) << size;
+    }
+}
+
+TEST(ABulkCountGreater, ComparesExactlyAcrossRatios) {
+    const std::vector<kilobytes> units{1_kb, 2_kb, 3_kb, 4_kb, 5_kb};
+    EXPECT_THAT(count_greater<kilobytes>(units, 2'048_b), Eq(3));
+    EXPECT_THAT(count_greater<kilobytes>(units, 2'047_b), Eq(4));
+    EXPECT_THAT(count_greater<kilobytes>(units, 1_mb), Eq(0));
+    EXPECT_THAT(count_greater<kilobytes>(units, 16_eb), Eq(0));
+    EXPECT_THAT(count_greater<bytes>(std::vector<bytes>{1_b, 2_b}, 1_bit), Eq(2));
+}
+
+TEST(ABulkMinMax, FindsSmallestAndGreatest) {
+    for (const auto size : sizes) {
+        if (size == 0) {
+            continue;
+        }
+        const auto units = random_units<bytes>(size, 0);
+        ASSERT_THAT(min<bytes>(units), Eq(*std::min_element(units.begin(), units.end()))) << size;
+        ASSERT_THAT(max<bytes>(units), Eq(*std::max_element(units.begin(), units.end()))) << size;
+    }
+}
+
+#if defined(__cpp_exceptions)
+TEST(ABulkMinMax, ThrowsOnEmptySpan) {
+    ASSERT_THROW(std::ignore = min<bytes>({}), std::invalid_argument);
+    ASSERT_THROW(std::ignore = max<bytes>({}), std::invalid_argument);
+}
+#endif
+
+TEST(ABulkKernel, SupportsSmallerReps) {
+    using compact_kilobytes = memory_unit<std::uint32_t, kilobytes::ratio>;
+    const std::vector<compact_kilobytes> units{compact_kilobytes(3), compact_kilobytes(1), compact_kilobytes(7)};
+    ASSERT_THAT(sum<compact_kilobytes>(units).count(), Eq(11));
+    ASSERT_THAT(max<compact_kilobytes>(units).count(), Eq(7));
+    ASSERT_THAT(count_greater<compact_kilobytes>(units, compact_kilobytes(2)), Eq(2));
+}
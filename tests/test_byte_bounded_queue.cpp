@@ -0,0 +1,172 @@
+#include "mem_units/byte_bounded_queue.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <future>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+using namespace std::chrono_literals;
+
+TEST(DefaultByteSize, IsSizeOfElementsOfContiguousRanges) {
+    ASSERT_THAT(default_byte_size<std::string>{}(std::string(100, 'x')), Eq(100_b));
+    ASSERT_THAT(default_byte_size<std::vector<std::uint32_t> >{}(std::vector<std::uint32_t>(10)), Eq(40_b));
+    ASSERT_THAT(default_byte_size<std::uint64_t>{}(42), Eq(8_b));
+}
+
+TEST(AByteBoundedQueue, PopsItemsInOrderOfPushing) {
+    byte_bounded_queue<std::string> queue{1_kb};
+    ASSERT_TRUE(queue.try_push("first"));
+    ASSERT_TRUE(queue.try_push("second"));
+    ASSERT_THAT(queue.try_pop(), Optional(Eq("first")));
+    ASSERT_THAT(queue.try_pop(), Optional(Eq("second")));
+    ASSERT_THAT(queue.try_pop(), Eq(std::nullopt));
+}
+
+TEST(AByteBoundedQueue, AccountsQueuedBytes) {
+    byte_bounded_queue<std::string> queue{1_kb};
+    ASSERT_TRUE(queue.try_push(std::string(300, 'a')));
+    ASSERT_TRUE(queue.try_push(std::string(200, 'b')));
+    ASSERT_THAT(queue.queued(), Eq(500_b));
+    ASSERT_THAT(queue.available(), Eq(524_b));
+    ASSERT_THAT(queue.size(), Eq(2));
+    (void)queue.try_pop();
+    ASSERT_THAT(queue.queued(), Eq(200_b));
+    ASSERT_THAT(queue.peak(), Eq(500_b));
+}
+
+TEST(AByteBoundedQueue, RejectsItemsBeyondCapacity) {
+    byte_bounded_queue<std::string> queue{1_kb};
+    ASSERT_TRUE(queue.try_push(std::string(1'000, 'a')));
+    std::string rejected(100, 'b');
+    ASSERT_FALSE(queue.try_push(std::move(rejected)));
+    ASSERT_THAT(rejected.size(), Eq(100));
+    ASSERT_TRUE(queue.try_push(std::string(24, 'c')));
+}
+
+TEST(AByteBoundedQueue, ThrowsForItemLargerThanCapacity) {
+    byte_bounded_queue<std::string> queue{1_kb};
+    ASSERT_THROW((void)queue.try_push(std::string(1'025, 'a')), std::length_error);
+    ASSERT_THROW(queue.push(std::string(1'025, 'a')), std::length_error);
+}
+
+TEST(AByteBoundedQueue, UsesGivenSizeFunction) {
+    byte_bounded_queue<int> queue{10_mb, [](const int count) { return bytes(megabytes(count)); }};
+    ASSERT_TRUE(queue.try_push(6));
+    ASSERT_FALSE(queue.try_push(5));
+    ASSERT_THAT(queue.queued(), Eq(6_mb));
+}
+
+TEST(AByteBoundedQueue, IsBoundedBySlotCount) {
+    byte_bounded_queue<int> queue{1_mb, default_byte_size<int>{}, backpressure::block, 3};
+    ASSERT_THAT(queue.slot_count(), Eq(4));
+    for (int item = 0; item < 4; ++item) {
+        ASSERT_TRUE(queue.try_push(int{item}));
+    }
+    ASSERT_FALSE(queue.try_push(4));
+    ASSERT_THAT(queue.queued(), Eq(16_b));
+}
+
+TEST(AByteBoundedQueue, FailsFastWithFailingBackpressure) {
+    byte_bounded_queue<std::string> queue{1_kb, default_byte_size<std::string>{}, backpressure::fail};
+    ASSERT_TRUE(queue.push(std::string(1'024, 'a')));
+    ASSERT_FALSE(queue.push(std::string(1, 'b')));
+}
+
+TEST(AByteBoundedQueue, BlocksProducerUntilConsumerMadeRoom) {
+    for (const auto policy : {backpressure::block, backpressure::spin}) {
+        byte_bounded_queue<std::string> queue{1_kb, default_byte_size<std::string>{}, policy};
+        ASSERT_TRUE(queue.push(std::string(1'000, 'a')));
+        auto producer = std::async(std::launch::async, [&queue] { return queue.push(std::string(100, 'b')); });
+        ASSERT_THAT(producer.wait_for(20ms), Eq(std::future_status::timeout));
+        ASSERT_THAT(queue.pop(), Optional(Eq(std::string(1'000, 'a'))));
+        ASSERT_TRUE(producer.get());
+        ASSERT_THAT(queue.queued(), Eq(100_b));
+    }
+}
+
+TEST(AByteBoundedQueue, BlocksConsumerUntilItemIsPushed) {
+    byte_bounded_queue<int> queue{1_kb};
+    auto consumer = std::async(std::launch::async, [&queue] { return queue.pop(); });
+    ASSERT_THAT(consumer.wait_for(20ms), Eq(std::future_status::timeout));
+    ASSERT_TRUE(queue.push(42));
+    ASSERT_THAT(consumer.get(), Optional(Eq(42)));
+}
+
+TEST(AByteBoundedQueue, WakesWaitingThreadsWhenClosed) {
+    byte_bounded_queue<int> empty{1_kb};
+    auto consumer = std::async(std::launch::async, [&empty] { return empty.pop(); });
+    byte_bounded_queue<int> full{4_b};
+    ASSERT_TRUE(full.push(1));
+    auto producer = std::async(std::launch::async, [&full] { return full.push(2); });
+    std::this_thread::sleep_for(20ms);
+    empty.close();
+    full.close();
+    ASSERT_THAT(consumer.get(), Eq(std::nullopt));
+    ASSERT_FALSE(producer.get());
+    ASSERT_THAT(full.pop(), Optional(Eq(1)));
+    ASSERT_THAT(full.pop(), Eq(std::nullopt));
+}
+
+TEST(AByteBoundedQueue, DestroysQueuedItems) {
+    auto tracked = std::make_shared<int>(0);
+    {
+        byte_bounded_queue<std::shared_ptr<int> > queue{1_kb};
+        ASSERT_TRUE(queue.try_push(std::shared_ptr<int>(tracked)));
+        ASSERT_THAT(tracked.use_count(), Eq(2));
+    }
+    ASSERT_THAT(tracked.use_count(), Eq(1));
+}
+
+TEST(AByteBoundedQueue, PassesEveryItemExactlyOnceBetweenManyThreads) {
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr int items_per_producer = 20'000;
+    byte_bounded_queue<std::vector<int> > queue{4_kb, default_byte_size<std::vector<int> >{}, backpressure::block, 64};
+    std::vector<std::future<long long> > sums;
+    for (int consumer = 0; consumer < consumers; ++consumer) {
+        sums.push_back(std::async(std::launch::async, [&queue] {
+            long long sum = 0;
+            while (auto item = queue.pop()) {
+                sum += std::accumulate(item->begin(), item->end(), 0LL);
+            }
+            return sum;
+        }));
+    }
+    {
+        std::vector<std::jthread> threads;
+        for (int producer = 0; producer < producers; ++producer) {
+            threads.emplace_back([&queue] {
+                for (int item = 1; item <= items_per_producer; ++item) {
+                    queue.push(std::vector<int>(1 + item % 100, item));
+                }
+            });
+        }
+    }
+    queue.close();
+    long long expected = 0;
+    for (int item = 1; item <= items_per_producer; ++item) {
+        expected += static_cast<long long>(1 + item % 100) * item;
+    }
+    long long sum = 0;
+    for (auto &consumer : sums) {
+        sum += consumer.get();
+    }
+    ASSERT_THAT(sum, Eq(producers * expected));
+    ASSERT_THAT(queue.queued(), Eq(0_b));
+    ASSERT_TRUE(queue.peak() <= 4_kb);
+}
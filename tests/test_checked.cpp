@@ -0,0 +1,132 @@
+#include "mem_units/checked.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <limits>
+#include <utility>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+// also built with exceptions disabled, see CMakeLists.txt
+
+namespace {
+    constexpr auto max_bytes = bytes(std::numeric_limits<std::uint64_t>::max());
+
+    using signed_kilobytes = with_rep_t<kilobytes, std::int64_t>;
+    using signed_bytes32 = with_rep_t<bytes, std::int32_t>;
+    using floating_kilobytes = with_rep_t<kilobytes, double>;
+}
+
+static_assert(checked_add(1_kb, 2_b) == 1'026_b);
+static_assert(checked_add(16_eb, 1_b).error() == mem_unit_error::overflow);
+static_assert(checked_sub(1_mb, 1_kb) == 1'023_kb);
+static_assert(checked_sub(1_kb, 1_mb).error() == mem_unit_error::underflow);
+static_assert(checked_mul(21_kb, 2) == 42_kb);
+static_assert(checked_mul(bytes(std::uint64_t{1} << 63), 2).error() == mem_unit_error::overflow);
+static_assert(checked_cast<kilobytes32>(4_mb) == kilobytes32(4'096));
+static_assert(checked_cast<kilobytes32>(8_tb).error() == mem_unit_error::overflow);
+static_assert(noexcept(checked_add(std::declval<kilobytes>(), std::declval<bytes>())));
+
+TEST(ACheckedAdd, ReturnsSumOfSameUnits) {
+    ASSERT_THAT(checked_add(32_mb, 6_mb), Eq(38_mb));
+    ASSERT_THAT(checked_add(max_bytes, 0_b), Eq(max_bytes));
+}
+
+TEST(ACheckedAdd, ReturnsSumInCommonUnit) {
+    const auto sum = checked_add(kilobytes32(3), 512_b);
+    static_assert(std::is_same_v<decltype(sum)::value_type, bytes>);
+    ASSERT_THAT(sum, Eq(3'584_b));
+}
+
+TEST(ACheckedAdd, ReportsOverflow) {
+    ASSERT_THAT(checked_add(max_bytes, 1_b).error(), Eq(mem_unit_error::overflow));
+    ASSERT_THAT(checked_add(bytes32(std::numeric_limits<std::uint32_t>::max()), bytes32(1)).error(),
+                Eq(mem_unit_error::overflow));
+}
+
+TEST(ACheckedAdd, ReportsOverflowOfConversionToCommonUnit) {
+    ASSERT_THAT(checked_add(16_eb, 0_b).error(), Eq(mem_unit_error::overflow));
+}
+
+TEST(ACheckedAdd, ReportsUnderflowOfSignedReps) {
+    const signed_kilobytes lowest(std::numeric_limits<std::int64_t>::min());
+    ASSERT_THAT(checked_add(lowest, signed_kilobytes(-1)).error(), Eq(mem_unit_error::underflow));
+    ASSERT_THAT(checked_add(lowest, signed_kilobytes(1)), Eq(signed_kilobytes(std::numeric_limits<std::int64_t>::min() + 1)));
+}
+
+TEST(ACheckedSub, ReturnsDifference) {
+    ASSERT_THAT(checked_sub(32_mb, 6_mb), Eq(26_mb));
+    ASSERT_THAT(checked_sub(1'200_kb, 1_mb), Eq(176_kb));
+}
+
+TEST(ACheckedSub, ReportsUnderflow) {
+    ASSERT_THAT(checked_sub(1_b, 2_b).error(), Eq(mem_unit_error::underflow));
+    ASSERT_THAT(checked_sub(signed_bytes32(std::numeric_limits<std::int32_t>::min()), signed_bytes32(1)).error(),
+                Eq(mem_unit_error::underflow));
+}
+
+TEST(ACheckedSub, ReportsOverflowOfSignedReps) {
+    ASSERT_THAT(checked_sub(signed_bytes32(std::numeric_limits<std::int32_t>::max()), signed_bytes32(-1)).error(),
+                Eq(mem_unit_error::overflow));
+}
+
+TEST(ACheckedMul, ReturnsProduct) {
+    ASSERT_THAT(checked_mul(21_kb, 2), Eq(42_kb));
+    ASSERT_THAT(checked_mul(signed_kilobytes(3), -2), Eq(signed_kilobytes(-6)));
+    ASSERT_THAT(checked_mul(max_bytes, 0), Eq(0_b));
+}
+
+TEST(ACheckedMul, ReportsOverflowAndUnderflow) {
+    ASSERT_THAT(checked_mul(max_bytes, 2).error(), Eq(mem_unit_error::overflow));
+    ASSERT_THAT(checked_mul(1_b, -1).error(), Eq(mem_unit_error::underflow));
+    ASSERT_THAT(checked_mul(signed_kilobytes(std::numeric_limits<std::int64_t>::max()), -2).error(),
+                Eq(mem_unit_error::underflow));
+    ASSERT_THAT(checked_mul(signed_kilobytes(std::numeric_limits<std::int64_t>::min()), -1).error(),
+                Eq(mem_unit_error::overflow));
+}
+
+TEST(ACheckedCast, ConvertsLikeMemoryUnitCast) {
+    ASSERT_THAT(checked_cast<bytes>(4_mb), Eq(4_mb));
+    ASSERT_THAT(checked_cast<kilobytes>(1'200_b), Eq(1_kb));
+    ASSERT_THAT(checked_cast<bits>(1_pb), Eq(bits(std::uint64_t{1} << 53)));
+    ASSERT_THAT(checked_cast<kilobytes16>(64_mb - 1_kb), Eq(kilobytes16(65'535)));
+}
+
+TEST(ACheckedCast, ReportsOverflowAndUnderflow) {
+    ASSERT_THAT(checked_cast<bits>(1_eb), Eq(bits(std::uint64_t{1} << 63)));
+    ASSERT_THAT(checked_cast<bits>(2_eb).error(), Eq(mem_unit_error::overflow));
+    ASSERT_THAT(checked_cast<exabytes>(bits(std::numeric_limits<std::uint64_t>::max())), Eq(1_eb));
+    ASSERT_THAT(checked_cast<kilobytes16>(64_mb).error(), Eq(mem_unit_error::overflow));
+    ASSERT_THAT(checked_cast<kilobytes>(signed_kilobytes(-1)).error(), Eq(mem_unit_error::underflow));
+    ASSERT_THAT(checked_cast<signed_bytes32>(signed_kilobytes(-3 << 20)).error(), Eq(mem_unit_error::underflow));
+}
+
+TEST(ACheckedCast, ConvertsFloatingPointReps) {
+    ASSERT_THAT(checked_cast<floating_kilobytes>(1'536_b), Eq(floating_kilobytes(1.5)));
+}
+
+TEST(AMemUnitError, HasDescription) {
+    ASSERT_THAT(to_string(mem_unit_error::overflow), Eq("Result would cause an overflow!"));
+    ASSERT_THAT(to_string(mem_unit_error::underflow), Eq("Result would cause an underflow!"));
+}
+
+#if defined(__cpp_exceptions)
+TEST(ACheckedAdd, FailsWhereOperatorThrows) {
+    ASSERT_THROW((void)(max_bytes + 1_b), std::overflow_error);
+    ASSERT_FALSE(checked_add(max_bytes, 1_b).has_value());
+    ASSERT_THROW((void)(1_b - 2_b), std::underflow_error);
+    ASSERT_FALSE(checked_sub(1_b, 2_b).has_value());
+    ASSERT_THROW((void)memory_unit_cast<kilobytes16>(64_mb), std::overflow_error);
+    ASSERT_FALSE(checked_cast<kilobytes16>(64_mb).has_value());
+}
+#endif
@@ -0,0 +1,98 @@
+#include "mem_units/format.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <iterator>
+#include <limits>
+
+using ::testing::Eq;
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(AFormattedMemoryUnit, HasCountAndSuffixOfItsUnit) {
+    EXPECT_THAT(std::format("{}", 3_bit), Eq("3bit"));
+    EXPECT_THAT(std::format("{}", 42_b), Eq("42b"));
+    EXPECT_THAT(std::format("{}", 1'536_kb), Eq("1536kb"));
+    EXPECT_THAT(std::format("{}", 7_mb), Eq("7mb"));
+    EXPECT_THAT(std::format("{}", 8_gb), Eq("8gb"));
+    EXPECT_THAT(std::format("{}", 9_tb), Eq("9tb"));
+    EXPECT_THAT(std::format("{}", 10_pb), Eq("10pb"));
+    EXPECT_THAT(std::format("{}", 11_eb), Eq("11eb"));
+}
+
+TEST(AFormattedMemoryUnit, IsIndependentOfOverflowPolicy) {
+    ASSERT_THAT(std::format("{}", unchecked_megabytes(12)), Eq("12mb"));
+}
+
+TEST(AFormattedMemoryUnit, HasQuestionMarkSuffixForUnknownRatio) {
+    ASSERT_THAT(std::format("{}", memory_unit<std::uint64_t, std::ratio<1'000>>(5)), Eq("5?"));
+}
+
+TEST(AFormattedMemoryUnit, IsScaledToGreatestFittingUnit) {
+    EXPECT_THAT(std::format("{:h}", 1'536_mb), Eq("1.5gb"));
+    EXPECT_THAT(std::format("{:h}", 1'023_b), Eq("1023b"));
+    EXPECT_THAT(std::format("{:h}", 1'024_b), Eq("1kb"));
+    EXPECT_THAT(std::format("{:h}", 4_bit), Eq("4bit"));
+    EXPECT_THAT(std::format("{:h}", 0_gb), Eq("0b"));
+    EXPECT_THAT(std::format("{:h}", 2'048_pb), Eq("2eb"));
+}
+
+TEST(AFormattedMemoryUnit, IsScaledWithPrecision) {
+    EXPECT_THAT(std::format("{:.2h}", 1'500_kb), Eq("1.46mb"));
+    EXPECT_THAT(std::format("{:.2kb}", 1'000_b), Eq("0.98kb"));
+    EXPECT_THAT(std::format("{:.0h}", 1'536_kb), Eq("2mb"));
+}
+
+TEST(AFormattedMemoryUnit, IsConvertedToFixedUnit) {
+    EXPECT_THAT(std::format("{:kb}", 4_mb), Eq("4096kb"));
+    EXPECT_THAT(std::format("{:mb}", 512_kb), Eq("0.5mb"));
+    EXPECT_THAT(std::format("{:bit}", 2_b), Eq("16bit"));
+    EXPECT_THAT(std::format("{:.3gb}", 1_mb), Eq("0.001gb"));
+}
+
+TEST(AFormattedMemoryUnit, HasFractionalDigitsOfPrecisionInOwnUnit) {
+    ASSERT_THAT(std::format("{:.2}", 42_kb), Eq("42.00kb"));
+}
+
+TEST(AFormattedMemoryUnit, HasAllDigitsOfLargeCountsInOtherUnits) {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    EXPECT_THAT(std::format("{:b}", bits(max)), Eq("2305843009213693951.875b"));
+    EXPECT_THAT(std::format("{:.2b}", bits(max)), Eq("2305843009213693951.88b"));
+    EXPECT_THAT(std::format("{:kb}", bytes(max)), Eq("18014398509481983.9990234375kb"));
+    EXPECT_THAT(std::format("{:.2h}", bytes(max)), Eq("16.00eb"));
+    EXPECT_THAT(std::format("{:.0h}", bytes(max - 1'023)), Eq("16eb"));
+    EXPECT_THAT(std::format("{:.3}", bytes(max)), Eq("18446744073709551615.000b"));
+    EXPECT_THAT(std::format("{:b}", kilobytes(max / 1'024)), Eq("18446744073709550592b"));
+}
+
+TEST(AFormattedMemoryUnit, HasSignOfNegativeCounts) {
+    using signed_bytes = with_rep_t<bytes, std::int64_t>;
+    EXPECT_THAT(std::format("{:kb}", signed_bytes(-1'536)), Eq("-1.5kb"));
+    EXPECT_THAT(std::format("{:.1h}", signed_bytes(-1'024)), Eq("-1.0kb"));
+    EXPECT_THAT(std::format("{:.0kb}", signed_bytes(-1)), Eq("0kb"));
+}
+
+TEST(AFormattedMemoryUnit, IsPaddedToWidth) {
+    EXPECT_THAT(std::format("{:8}", 42_kb), Eq("    42kb"));
+    EXPECT_THAT(std::format("{:<8}", 42_kb), Eq("42kb    "));
+    EXPECT_THAT(std::format("{:^9}", 3_gb), Eq("   3gb   "));
+    EXPECT_THAT(std::format("{:*<8h}", 1'536_mb), Eq("1.5gb***"));
+    EXPECT_THAT(std::format("{:>3.1h}", 1'536_mb), Eq("1.5gb"));
+}
+
+TEST(AFormattedMemoryUnit, IsWrittenToOutputIterator) {
+    std::array<char, 16> buffer{};
+    const auto end = std::format_to(buffer.data(), "{:h}", 3_gb);
+    ASSERT_THAT(std::string_view(buffer.data(), end), Eq("3gb"));
+}
+
+TEST(AFormattedMemoryUnit, RejectsInvalidFormatSpec) {
+    // checked at compile time by std::format, so only runtime format strings reach the parser invalid
+    const auto value = 1_kb;
+    EXPECT_THROW((void)std::vformat("{:xb}", std::make_format_args(value)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:.h}", std::make_format_args(value)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:.100h}", std::make_format_args(value)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:08}", std::make_format_args(value)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:{}}", std::make_format_args(value)), std::format_error);
+}
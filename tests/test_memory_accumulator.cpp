@@ -0,0 +1,146 @@
+#include "mem_units/memory_accumulator.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <numeric>
+#include <random>
+#include <vector>
+
+// the parallel algorithms of libstdc++ need exceptions
+#if defined(__cpp_exceptions)
+#include <execution>
+#endif
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+// also built with exceptions disabled, see CMakeLists.txt
+
+TEST(AMemoryAccumulator, IsZeroByDefault) {
+    constexpr memory_accumulator<bytes> total;
+    static_assert(total.result() == 0_b);
+    ASSERT_THAT(total.result(), Eq(0_b));
+}
+
+TEST(AMemoryAccumulator, AddsMixedRatios) {
+    memory_accumulator<bytes> total;
+    total += 16_bit;
+    total += 1_kb;
+    total += 3_b;
+    total += 1_mb;
+    ASSERT_THAT(total.result(), Eq(bytes(2 + 1'024 + 3 + 1'048'576)));
+}
+
+TEST(AMemoryAccumulator, KeepsFractionsUntilResult) {
+    memory_accumulator<kilobytes> total;
+    for (int index = 0; index < 4; ++index) {
+        total += 256_b;
+    }
+    total += 7_bit;
+    ASSERT_THAT(total.result(), Eq(1_kb));
+    ASSERT_THAT(total.result<bits>(), Eq(bits(8'192 + 7)));
+}
+
+TEST(AMemoryAccumulator, IsUsableInConstantExpressions) {
+    constexpr auto total = memory_accumulator<megabytes>{512_kb} + 512_kb + 1_gb;
+    static_assert(total.result() == 1'025_mb);
+}
+
+TEST(AMemoryAccumulator, HoldsSumsBeyondRep) {
+    memory_accumulator<exabytes> total;
+    total += bits(std::numeric_limits<std::uint64_t>::max());
+    total += bits(std::numeric_limits<std::uint64_t>::max());
+    total += exabytes(std::numeric_limits<std::uint64_t>::max() - 3);
+#if defined(__cpp_exceptions)
+    ASSERT_THROW(std::ignore = total.result<bits>(), std::overflow_error);
+#endif
+    ASSERT_THAT(total.result(), Eq(exabytes(std::numeric_limits<std::uint64_t>::max())));
+}
+
+TEST(AMemoryAccumulator, ChecksNarrowingOnResult) {
+    memory_accumulator<bytes> total{bytes(std::numeric_limits<std::uint64_t>::max())};
+    total += 1_b;
+#if defined(__cpp_exceptions)
+    ASSERT_THROW(std::ignore = total.result(), std::overflow_error);
+#endif
+    ASSERT_THAT(total.result<saturating_bytes>().count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+    ASSERT_THAT(total.result<wrapping_bytes>().count(), Eq(0));
+    ASSERT_THAT(total.result<kilobytes>(), Eq(kilobytes(1ULL << 54)));
+}
+
+TEST(AMemoryAccumulator, CarriesCountsBeyondRep) {
+    memory_accumulator<bytes> total;
+    for (int index = 0; index < 1'024; ++index) {
+        total += bytes(std::numeric_limits<std::uint64_t>::max());
+    }
+    ASSERT_THAT(total.result<kilobytes>(), Eq(kilobytes(std::numeric_limits<std::uint64_t>::max())));
+    ASSERT_THAT(memory_accumulator<kilobytes>{total}.result(), Eq(kilobytes(std::numeric_limits<std::uint64_t>::max())));
+}
+
+TEST(AMemoryAccumulator, DetectsOverflowOfRegister) {
+    memory_accumulator<exabytes> total;
+    for (int index = 0; index < 3; ++index) {
+        total += exabytes(std::numeric_limits<std::uint64_t>::max());
+    }
+#if defined(__cpp_exceptions)
+    ASSERT_THROW(std::ignore = total.result(), std::overflow_error);
+#endif
+    ASSERT_THAT(total.result<saturating_exabytes>().count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+    ASSERT_THAT(total.result<wrapping_exabytes>().count(), Eq(std::numeric_limits<std::uint64_t>::max() - 2));
+}
+
+TEST(AMemoryAccumulator, SupportsNonPowerOfTwoRatios) {
+    using decimal_kilobytes = memory_unit<std::uint64_t, std::ratio<1'000>>;
+    memory_accumulator<decimal_kilobytes> total;
+    total += 3_kb;
+    total += decimal_kilobytes(1);
+    ASSERT_THAT(total.result(), Eq(decimal_kilobytes(4)));
+    ASSERT_THAT(total.result<bytes>(), Eq(4'072_b));
+    total += decimal_kilobytes(std::numeric_limits<std::uint64_t>::max());
+#if defined(__cpp_exceptions)
+    ASSERT_THROW(std::ignore = total.result(), std::overflow_error);
+#endif
+    ASSERT_THAT(total.result<saturating_bytes>().count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+    ASSERT_THAT(total.result<kilobytes>(), Eq(kilobytes(18'014'398'509'481'984'003ULL)));
+
+    const memory_accumulator<decimal_kilobytes> exact{decimal_kilobytes(std::numeric_limits<std::uint64_t>::max())};
+    ASSERT_THAT(exact.result(), Eq(decimal_kilobytes(std::numeric_limits<std::uint64_t>::max())));
+}
+
+TEST(AMemoryAccumulator, CombinesAccumulators) {
+    memory_accumulator<bytes> lhs{1_kb};
+    const memory_accumulator<kilobytes> rhs{512_b};
+    lhs += rhs;
+    ASSERT_THAT((lhs + 1_bit + lhs).result<bits>(), Eq(bits(2 * 1'536 * 8 + 1)));
+}
+
+TEST(AMemoryAccumulator, ReducesSequentially) {
+    const std::vector<kilobytes> sizes{1_kb, 2_kb, 3_kb};
+    const auto total = std::accumulate(sizes.begin(), sizes.end(), memory_accumulator<bytes>{},
+                                       memory_accumulator<bytes>::plus{});
+    ASSERT_THAT(total.result(), Eq(6'144_b));
+}
+
+#if defined(__cpp_exceptions)
+TEST(AMemoryAccumulator, ReducesInParallel) {
+    std::mt19937_64 random(42);
+    std::vector<bytes> sizes;
+    std::uint64_t expected = 0;
+    for (int index = 0; index < 100'000; ++index) {
+        sizes.emplace_back(random() >> 20);
+        expected += sizes.back().count();
+    }
+    const auto total = std::reduce(std::execution::par, sizes.begin(), sizes.end(), memory_accumulator<bytes>{},
+                                   memory_accumulator<bytes>::plus{});
+    ASSERT_THAT(total.result(), Eq(bytes(expected)));
+}
+#endif
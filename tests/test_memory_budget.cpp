@@ -0,0 +1,128 @@
+#include "mem_units/memory_budget.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(AMemoryBudget, HasCapacityOfConstruction) {
+    const memory_budget budget{4_gb};
+    ASSERT_THAT(budget.capacity(), Eq(4_gb));
+    ASSERT_THAT(budget.used(), Eq(0_b));
+    ASSERT_THAT(budget.available(), Eq(4_gb));
+}
+
+TEST(AMemoryBudget, ReservesWhileAvailable) {
+    memory_budget budget{1_gb};
+    ASSERT_TRUE(budget.try_reserve(512_mb));
+    ASSERT_TRUE(budget.try_reserve(512_mb));
+    ASSERT_FALSE(budget.try_reserve(1_b));
+    ASSERT_THAT(budget.used(), Eq(1_gb));
+}
+
+TEST(AMemoryBudget, CanReserveAgainAfterRelease) {
+    memory_budget budget{1_mb};
+    ASSERT_TRUE(budget.try_reserve(1_mb));
+    budget.release(256_kb);
+    ASSERT_THAT(budget.available(), Eq(256_kb));
+    ASSERT_TRUE(budget.try_reserve(256_kb));
+}
+
+TEST(AMemoryBudget, RejectsAmountsThatWouldOverflow) {
+    memory_budget budget{bytes(std::numeric_limits<bytes::rep>::max())};
+    ASSERT_TRUE(budget.try_reserve(1_kb));
+    ASSERT_FALSE(budget.try_reserve(bytes(std::numeric_limits<bytes::rep>::max())));
+    ASSERT_THAT(budget.used(), Eq(1_kb));
+}
+
+TEST(AMemoryBudget, ReleasesReservationOnDestruction) {
+    memory_budget budget{64_mb};
+    {
+        const auto reservation = budget.reserve(48_mb);
+        ASSERT_TRUE(reservation.has_value());
+        ASSERT_THAT(reservation->size(), Eq(48_mb));
+        ASSERT_FALSE(budget.reserve(32_mb).has_value());
+    }
+    ASSERT_THAT(budget.used(), Eq(0_b));
+}
+
+TEST(AMemoryBudget, TransfersReservationOnMove) {
+    memory_budget budget{64_mb};
+    memory_reservation outer;
+    {
+        auto reservation = budget.reserve(16_mb);
+        outer = std::move(*reservation);
+        ASSERT_FALSE(*reservation);
+    }
+    ASSERT_THAT(budget.used(), Eq(16_mb));
+    outer.release();
+    ASSERT_THAT(budget.used(), Eq(0_b));
+    ASSERT_THAT(outer.size(), Eq(0_b));
+}
+
+TEST(AMemoryBudget, ChargesReservationsOfChildToParents) {
+    memory_budget process{4_gb};
+    memory_budget tenant{1_gb, process};
+    memory_budget subsystem{512_mb, tenant};
+    const auto reservation = subsystem.reserve(100_mb);
+    ASSERT_THAT(subsystem.used(), Eq(100_mb));
+    ASSERT_THAT(tenant.used(), Eq(100_mb));
+    ASSERT_THAT(process.used(), Eq(100_mb));
+}
+
+TEST(AMemoryBudget, RejectsReservationOfChildIfParentIsExhausted) {
+    memory_budget process{1_gb};
+    memory_budget first{1_gb, process};
+    memory_budget second{1_gb, process};
+    ASSERT_TRUE(first.try_reserve(768_mb));
+    ASSERT_FALSE(second.try_reserve(512_mb));
+    ASSERT_THAT(second.used(), Eq(0_b));
+    ASSERT_THAT(process.used(), Eq(768_mb));
+}
+
+TEST(AMemoryBudget, PreventsNewReservationsWhenShrunkBelowUsed) {
+    memory_budget budget{1_gb};
+    ASSERT_TRUE(budget.try_reserve(512_mb));
+    budget.set_capacity(256_mb);
+    ASSERT_THAT(budget.available(), Eq(0_b));
+    ASSERT_FALSE(budget.try_reserve(1_b));
+}
+
+TEST(AMemoryBudget, NeverExceedsCapacityUnderContention) {
+    constexpr int thread_count = 16;
+    constexpr int iterations = 10'000;
+    memory_budget process{1_mb};
+    memory_budget tenant{768_kb, process};
+    std::atomic<bool> exceeded{false};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&, thread] {
+            memory_budget &budget = thread % 2 == 0 ? process : tenant;
+            for (int i = 0; i < iterations; ++i) {
+                if (const auto reservation = budget.reserve(64_kb)) {
+                    if (process.used() > process.capacity() || tenant.used() > tenant.capacity()) {
+                        exceeded = true;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_FALSE(exceeded);
+    ASSERT_THAT(process.used(), Eq(0_b));
+    ASSERT_THAT(tenant.used(), Eq(0_b));
+}
@@ -0,0 +1,163 @@
+#include "mem_units/memory_pressure_watcher.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <random>
+#include <sstream>
+
+#if defined(__linux__)
+
+using ::testing::Eq;
+using ::testing::StartsWith;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+using namespace std::chrono_literals;
+
+class AMemoryPressureWatcher : public ::testing::Test {
+protected:
+    std::filesystem::path root;
+
+    void SetUp() override {
+        std::random_device random;
+        root = std::filesystem::temp_directory_path() / ("mem_units_watcher_" + std::to_string(random()));
+        std::filesystem::create_directories(root / "proc/self");
+        std::filesystem::create_directories(root / "proc/pressure");
+        std::filesystem::create_directories(root / "cgroup/test.service");
+        write("proc/meminfo", "MemTotal:       16384000 kB\n");
+        write("proc/self/status", "VmHWM:\t    4096 kB\nVmRSS:\t    3072 kB\n");
+        write("proc/self/cgroup", "0::/test.service\n");
+        write("proc/pressure/memory", "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+        write("cgroup/test.service/memory.max", "max\n");
+        write("cgroup/test.service/memory.current", "67108864\n");
+        write("cgroup/test.service/memory.events", "low 0\nhigh 0\nmax 0\noom 0\noom_kill 0\n");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    void write(const std::filesystem::path &file, const std::string_view content) const {
+        std::ofstream stream(root / file, std::ios::trunc);
+        stream << content;
+    }
+
+    [[nodiscard]] std::string read(const std::filesystem::path &file) const {
+        std::ifstream stream(root / file);
+        std::stringstream content;
+        content << stream.rdbuf();
+        return content.str();
+    }
+
+    [[nodiscard]] memory_pressure_watcher watcher() const {
+        return memory_pressure_watcher(1ms, (root / "proc").string(), (root / "cgroup").string());
+    }
+};
+
+TEST_F(AMemoryPressureWatcher, CallsBackWhenUsageExceedsThreshold) {
+    auto watcher = this->watcher();
+    std::promise<bytes> exceeded;
+    watcher.on_usage_above(100_mb, [&exceeded](const bytes usage) { exceeded.set_value(usage); });
+    watcher.start();
+    write("cgroup/test.service/memory.current", "134217728\n");
+    auto usage = exceeded.get_future();
+    ASSERT_THAT(usage.wait_for(5s), Eq(std::future_status::ready));
+    ASSERT_THAT(usage.get(), Eq(128_mb));
+}
+
+TEST_F(AMemoryPressureWatcher, CallsBackAgainOnlyAfterUsageFellBelowThreshold) {
+    auto watcher = this->watcher();
+    std::atomic<int> calls = 0;
+    watcher.on_usage_above(32_mb, [&calls](bytes) { calls.fetch_add(1); calls.notify_all(); });
+    watcher.start();
+    calls.wait(0);
+    std::this_thread::sleep_for(20ms);
+    ASSERT_THAT(calls.load(), Eq(1));
+
+    write("cgroup/test.service/memory.current", "1048576\n");
+    std::this_thread::sleep_for(20ms);
+    write("cgroup/test.service/memory.current", "67108864\n");
+    calls.wait(1);
+    ASSERT_THAT(calls.load(), Eq(2));
+}
+
+TEST_F(AMemoryPressureWatcher, UsesResidentSetSizeWithoutCgroup) {
+    write("proc/self/cgroup", "");
+    auto watcher = this->watcher();
+    std::promise<bytes> exceeded;
+    watcher.on_usage_above(2_mb, [&exceeded](const bytes usage) { exceeded.set_value(usage); });
+    watcher.start();
+    auto usage = exceeded.get_future();
+    ASSERT_THAT(usage.wait_for(5s), Eq(std::future_status::ready));
+    ASSERT_THAT(usage.get(), Eq(3_mb));
+}
+
+TEST_F(AMemoryPressureWatcher, RegistersPressureTrigger) {
+    auto watcher = this->watcher();
+    watcher.on_pressure(memory_stall::full, 150ms, 2s, [] {});
+    ASSERT_THAT(read("proc/pressure/memory"), StartsWith(std::string_view("full 150000 2000000\0", 20)));
+}
+
+TEST_F(AMemoryPressureWatcher, CallsBackOnPressure) {
+    auto watcher = this->watcher();
+    std::promise<void> pressure;
+    watcher.on_pressure(memory_stall::some, 150ms, 2s, [&pressure, called = false]() mutable {
+        if (not std::exchange(called, true)) {
+            pressure.set_value();
+        }
+    });
+    watcher.start();
+    write("proc/pressure/memory", "some avg10=12.00 avg60=3.00 avg300=1.00 total=150000\n");
+    ASSERT_THAT(pressure.get_future().wait_for(5s), Eq(std::future_status::ready));
+}
+
+TEST_F(AMemoryPressureWatcher, CallsBackOnChangedMemoryEvents) {
+    auto watcher = this->watcher();
+    std::promise<memory_events> changed;
+    watcher.on_memory_events([&changed](const memory_events &events) { changed.set_value(events); });
+    watcher.start();
+    write("cgroup/test.service/memory.events", "low 0\nhigh 3\nmax 2\noom 1\noom_kill 1\n");
+    auto events = changed.get_future();
+    ASSERT_THAT(events.wait_for(5s), Eq(std::future_status::ready));
+    ASSERT_THAT(events.get(), Eq(memory_events{.low = 0, .high = 3, .max = 2, .oom = 1, .oom_kill = 1}));
+}
+
+TEST_F(AMemoryPressureWatcher, RequiresCgroupForMemoryEvents) {
+    write("proc/self/cgroup", "");
+    auto watcher = this->watcher();
+    ASSERT_THROW(watcher.on_memory_events([](const memory_events &) {}), std::system_error);
+}
+
+TEST_F(AMemoryPressureWatcher, RejectsThresholdsWhileRunning) {
+    auto watcher = this->watcher();
+    watcher.start();
+    ASSERT_TRUE(watcher.running());
+    ASSERT_THROW(watcher.on_usage_above(1_gb, [](bytes) {}), std::logic_error);
+    watcher.stop();
+    ASSERT_FALSE(watcher.running());
+}
+
+TEST_F(AMemoryPressureWatcher, CanBeRestarted) {
+    auto watcher = this->watcher();
+    std::atomic<int> calls = 0;
+    watcher.on_memory_events([&calls](const memory_events &) { calls.fetch_add(1); calls.notify_all(); });
+    watcher.start();
+    watcher.stop();
+    watcher.start();
+    write("cgroup/test.service/memory.events", "low 0\nhigh 1\nmax 0\noom 0\noom_kill 0\n");
+    calls.wait(0);
+    ASSERT_THAT(calls.load(), Eq(1));
+}
+
+#endif
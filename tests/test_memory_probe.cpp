@@ -0,0 +1,148 @@
+#include "mem_units/memory_probe.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#if defined(__linux__)
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    constexpr std::string_view meminfo = "MemTotal:       16384000 kB\n"
+                                         "MemFree:         2048000 kB\n"
+                                         "MemAvailable:    8192000 kB\n"
+                                         "Buffers:          512000 kB\n"
+                                         "Cached:          4096000 kB\n"
+                                         "SwapCached:            0 kB\n"
+                                         "SwapTotal:       1024000 kB\n"
+                                         "SwapFree:        1000000 kB\n"
+                                         "HugePages_Total:       0\n"
+                                         "Hugepagesize:       2048 kB\n";
+
+    constexpr std::string_view status = "Name:\ttest\n"
+                                        "Umask:\t0022\n"
+                                        "State:\tR (running)\n"
+                                        "VmPeak:\t   20480 kB\n"
+                                        "VmSize:\t   18432 kB\n"
+                                        "VmHWM:\t    4096 kB\n"
+                                        "VmRSS:\t    3072 kB\n"
+                                        "Threads:\t1\n";
+}
+
+class AMemoryProbe : public ::testing::Test {
+protected:
+    std::filesystem::path root;
+
+    void SetUp() override {
+        std::random_device random;
+        root = std::filesystem::temp_directory_path() / ("mem_units_probe_" + std::to_string(random()));
+        std::filesystem::create_directories(root / "proc/self");
+        std::filesystem::create_directories(root / "cgroup/app.slice/test.service");
+        write("proc/meminfo", meminfo);
+        write("proc/self/status", status);
+        write("proc/self/cgroup", "0::/app.slice/test.service\n");
+        write("cgroup/app.slice/test.service/memory.max", "536870912\n");
+        write("cgroup/app.slice/test.service/memory.current", "134217728\n");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    void write(const std::filesystem::path &file, const std::string_view content) const {
+        std::ofstream stream(root / file, std::ios::trunc);
+        stream << content;
+    }
+};
+
+TEST_F(AMemoryProbe, ReadsSystemMemory) {
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.total, Eq(16'384'000_kb));
+    ASSERT_THAT(snapshot.free, Eq(2'048'000_kb));
+    ASSERT_THAT(snapshot.available, Eq(8'192'000_kb));
+    ASSERT_THAT(snapshot.cached, Eq(4'096'000_kb));
+    ASSERT_THAT(snapshot.swap_total, Eq(1'024'000_kb));
+    ASSERT_THAT(snapshot.swap_free, Eq(1'000'000_kb));
+}
+
+TEST_F(AMemoryProbe, ReadsProcessMemory) {
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.rss, Eq(3_mb));
+    ASSERT_THAT(snapshot.peak_rss, Eq(4_mb));
+}
+
+TEST_F(AMemoryProbe, ReadsCgroupMemory) {
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    ASSERT_TRUE(probe.has_cgroup());
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.cgroup_limit, Optional(Eq(512_mb)));
+    ASSERT_THAT(snapshot.cgroup_usage, Optional(Eq(128_mb)));
+}
+
+TEST_F(AMemoryProbe, ReportsUnlimitedCgroupAsNoLimit) {
+    write("cgroup/app.slice/test.service/memory.max", "max\n");
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.cgroup_limit, Eq(std::nullopt));
+    ASSERT_THAT(snapshot.cgroup_usage, Optional(Eq(128_mb)));
+}
+
+TEST_F(AMemoryProbe, WorksWithoutCgroup) {
+    write("proc/self/cgroup", "12:memory:/user.slice\n");
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    ASSERT_FALSE(probe.has_cgroup());
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.cgroup_limit, Eq(std::nullopt));
+    ASSERT_THAT(snapshot.cgroup_usage, Eq(std::nullopt));
+    ASSERT_THAT(snapshot.rss, Eq(3_mb));
+}
+
+TEST_F(AMemoryProbe, RereadsFilesOnEverySample) {
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    ASSERT_THAT(probe.sample().rss, Eq(3_mb));
+    write("proc/self/status", "VmHWM:\t    8192 kB\nVmRSS:\t    6144 kB\n");
+    write("cgroup/app.slice/test.service/memory.current", "268435456\n");
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.rss, Eq(6_mb));
+    ASSERT_THAT(snapshot.peak_rss, Eq(8_mb));
+    ASSERT_THAT(snapshot.cgroup_usage, Optional(Eq(256_mb)));
+}
+
+TEST_F(AMemoryProbe, LeavesMissingFieldsZero) {
+    write("proc/meminfo", "MemTotal:       1024 kB\n");
+    auto probe = memory_probe((root / "proc").string(), (root / "cgroup").string());
+    const auto snapshot = probe.sample();
+    ASSERT_THAT(snapshot.total, Eq(1_mb));
+    ASSERT_THAT(snapshot.available, Eq(0_kb));
+}
+
+TEST_F(AMemoryProbe, ThrowsIfProcFileIsMissing) {
+    std::filesystem::remove(root / "proc/meminfo");
+    ASSERT_THROW(memory_probe((root / "proc").string(), (root / "cgroup").string()), std::system_error);
+}
+
+TEST(ALiveMemoryProbe, ReadsOwnProcess) {
+    memory_probe probe;
+    const auto snapshot = probe.sample();
+    ASSERT_GT(snapshot.total, 0_kb);
+    ASSERT_GT(snapshot.rss, 0_kb);
+    ASSERT_GE(snapshot.peak_rss, snapshot.rss);
+}
+
+#endif
@@ -0,0 +1,211 @@
+#include "mem_units/memory_rate.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <format>
+#include <thread>
+#include <vector>
+
+using ::testing::DoubleNear;
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+
+    template<MemoryUnitType MemoryUnit, RatioType Period>
+    void PrintTo(const memory_rate<MemoryUnit, Period>& rate, std::ostream* os) {
+        *os << rate.count() << memory_unit_suffix<MemoryUnit>() << memory_rate_suffix<Period>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+using namespace std::chrono_literals;
+
+TEST(AMemoryRate, ResultsFromDividingByDuration) {
+    constexpr auto rate = 512_mb / 2s;
+    static_assert(std::is_same_v<decltype(rate), const memory_rate<megabytes> >);
+    ASSERT_THAT(rate.count(), Eq(256));
+}
+
+TEST(AMemoryRate, KeepsPeriodOfDuration) {
+    constexpr auto rate = 10_kb / 5ms;
+    static_assert(std::is_same_v<decltype(rate)::period, std::milli>);
+    ASSERT_THAT(rate.per_period(), Eq(2_kb));
+}
+
+TEST(AMemoryRate, RoundsDownIntegralDivision) {
+    ASSERT_THAT(1_gb / 3s, Eq(gigabytes_per_second(0_gb)));
+    ASSERT_THAT(bytes(1_gb) / 3s, Eq(bytes_per_second(357'913'941_b)));
+}
+
+TEST(AMemoryRate, HasFloatingPointRepForFloatingPointDuration) {
+    const auto rate = 3_gb / std::chrono::duration<double>(2.0);
+    ASSERT_THAT(rate.count(), Eq(1.5));
+}
+
+TEST(AMemoryRate, ThrowsOnDivisionByZeroDuration) {
+    ASSERT_THROW((void)(1_mb / 0s), std::overflow_error);
+    ASSERT_THAT((saturating_megabytes(1) / 0s).count(), Eq(std::numeric_limits<std::uint64_t>::max()));
+}
+
+TEST(AMemoryRate, ResultsInAmountWhenMultipliedByDuration) {
+    constexpr megabytes_per_second rate(100_mb);
+    ASSERT_THAT(rate * 1'500ms, Eq(150_mb));
+    ASSERT_THAT(1min * rate, Eq(6'000_mb));
+}
+
+TEST(AMemoryRate, ThrowsWhenAmountOverflows) {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    ASSERT_THROW((void)(gigabytes_per_second(gigabytes(max / 2)) * 3s), std::overflow_error);
+    ASSERT_THROW((void)(gigabytes_per_second(gigabytes(max / 1'000)) * 1h), std::overflow_error);
+}
+
+TEST(AMemoryRate, ThrowsOnlyWhenAmountItselfOverflows) {
+    // the product in nanoseconds overflows, the amount of 20gb does not
+    ASSERT_THAT(bytes_per_second(10'000'000'000_b) * std::chrono::nanoseconds(2s), Eq(20'000'000'000_b));
+    ASSERT_THAT(bytes_per_second(bytes(std::numeric_limits<std::uint64_t>::max())) * std::chrono::nanoseconds(1s),
+                Eq(bytes(std::numeric_limits<std::uint64_t>::max())));
+    ASSERT_THROW((void)(bytes_per_second(bytes(std::numeric_limits<std::uint64_t>::max())) * std::chrono::nanoseconds(1'000'000'001)),
+                 std::overflow_error);
+    ASSERT_THROW((void)(1_mb / 1s * -1s), std::underflow_error);
+}
+
+TEST(AMemoryRate, SaturatesWhenAmountOverflows) {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    ASSERT_THAT(memory_rate<saturating_gigabytes>(saturating_gigabytes(max / 2)) * 3s, Eq(saturating_gigabytes(max)));
+    ASSERT_THAT(memory_rate<saturating_gigabytes>(saturating_gigabytes(max / 1'000)) * 1h, Eq(saturating_gigabytes(max)));
+    // the product in milliseconds overflows, the amount does not
+    ASSERT_THAT(memory_rate<saturating_bytes>(saturating_bytes(std::uint64_t{1} << 62)) * 1'500ms,
+                Eq(saturating_bytes(std::uint64_t{3} << 61)));
+    using saturating_signed_bytes = with_rep_t<saturating_bytes, std::int64_t>;
+    ASSERT_THAT(memory_rate<saturating_signed_bytes>(saturating_signed_bytes(-(std::int64_t{1} << 62))) * 3s,
+                Eq(saturating_signed_bytes(std::numeric_limits<std::int64_t>::min())));
+}
+
+TEST(AMemoryRate, WrapsWhenAmountOverflows) {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    ASSERT_THAT(memory_rate<wrapping_bytes>(wrapping_bytes(max)) * 2s, Eq(wrapping_bytes(max - 1)));
+}
+
+TEST(AMemoryRate, RejectsNegativeDurationForUnsignedRep) {
+    ASSERT_THROW((void)(1_mb / -2s), std::underflow_error);
+    ASSERT_THAT((saturating_megabytes(1) / -2s).count(), Eq(0));
+    ASSERT_THAT((with_rep_t<megabytes, std::int64_t>(4) / -2s).count(), Eq(-2));
+}
+
+TEST(AMemoryRate, ResultsInDurationWhenDividingAmount) {
+    ASSERT_THAT(1_gb / megabytes_per_second(256_mb), Eq(4s));
+}
+
+TEST(AMemoryRate, ConvertsLosslesslyToSmallerUnitAndLongerPeriod) {
+    constexpr memory_rate<bytes, std::ratio<60> > per_minute{megabytes_per_second(1_mb)};
+    ASSERT_THAT(per_minute.per_period(), Eq(60_mb));
+    static_assert(not std::is_constructible_v<megabytes_per_second, kilobytes_per_second>);
+    static_assert(not std::is_constructible_v<memory_rate<bytes, std::milli>, bytes_per_second>);
+}
+
+TEST(AMemoryRate, CastsRoundingDown) {
+    ASSERT_THAT(memory_rate_cast<kilobytes_per_second>(memory_rate<bytes, std::milli>(512_b)),
+                Eq(kilobytes_per_second(500_kb)));
+    ASSERT_THAT(memory_rate_cast<megabytes_per_second>(kilobytes_per_second(2'047_kb)), Eq(megabytes_per_second(1_mb)));
+}
+
+TEST(AMemoryRate, ComparesExactlyAcrossUnitsAndPeriods) {
+    static_assert(memory_rate<kilobytes, std::milli>(1_kb) == bytes_per_second(1'024'000_b));
+    static_assert(memory_rate<kilobytes, std::milli>(1_kb) > bytes_per_second(1'023'999_b));
+    static_assert(megabytes_per_second(1_mb) < memory_rate<bits, std::micro>(bits(8'389)));
+}
+
+TEST(AMemoryRate, AddsAndSubtracts) {
+    ASSERT_THAT(megabytes_per_second(3_mb) + megabytes_per_second(2_mb), Eq(megabytes_per_second(5_mb)));
+    ASSERT_THROW((void)(megabytes_per_second(2_mb) - megabytes_per_second(3_mb)), std::underflow_error);
+}
+
+TEST(AMemoryRate, IsFormattedWithPeriodSuffix) {
+    ASSERT_THAT(std::format("{}", 512_mb / 2s), Eq("256mb/s"));
+    ASSERT_THAT(std::format("{:.1h}", bytes(3_gb) / 2s), Eq("1.5gb/s"));
+    ASSERT_THAT(std::format("{:kb}", 4_mb / 1ms), Eq("4096kb/ms"));
+    ASSERT_THAT(std::format("{}", memory_rate<bytes, std::ratio<7> >(7_b)), Eq("7b/?"));
+    ASSERT_THAT(std::format("{:<9}", 512_mb / 2s), Eq("256mb/s  "));
+}
+
+class AThroughputMeter : public ::testing::Test {
+protected:
+    throughput_meter::clock::time_point start{};
+    throughput_meter meter{1s, 10s, start};
+};
+
+TEST_F(AThroughputMeter, IsZeroUntilUpdated) {
+    meter.record(1_mb);
+    ASSERT_THAT(meter.total(), Eq(1_mb));
+    ASSERT_THAT(meter.average_rate().count(), Eq(0.0));
+    ASSERT_THAT(meter.window_rate().count(), Eq(0.0));
+}
+
+TEST_F(AThroughputMeter, MeasuresConstantRate) {
+    for (int second = 1; second <= 20; ++second) {
+        meter.record(10_mb);
+        meter.update(start + second * 1s);
+    }
+    ASSERT_THAT(meter.average_rate(), Eq(megabytes_per_second(10_mb)));
+    ASSERT_THAT(meter.window_rate(), Eq(megabytes_per_second(10_mb)));
+}
+
+TEST_F(AThroughputMeter, AveragesIndependentlyOfUpdateFrequency) {
+    throughput_meter often{1s, 10s, start};
+    meter.update(start + 1s);
+    often.update(start + 1s);
+    meter.record(1'000_kb);
+    meter.update(start + 2s);
+    for (int step = 1; step <= 10; ++step) {
+        often.record(100_kb);
+        often.update(start + 1s + step * 100ms);
+    }
+    const auto expected = static_cast<double>(bytes(1'000_kb).count()) * (1 - std::exp(-1.0));
+    ASSERT_THAT(meter.average_rate().count(), DoubleNear(expected, 1.0));
+    ASSERT_THAT(often.average_rate().count(), DoubleNear(expected, 1.0));
+}
+
+TEST_F(AThroughputMeter, DecaysAverageAfterStall) {
+    meter.record(10_mb);
+    meter.update(start + 1s);
+    meter.update(start + 2s);
+    const auto expected = static_cast<double>(bytes(10_mb).count()) * std::exp(-1.0);
+    ASSERT_THAT(meter.average_rate().count(), DoubleNear(expected, 1.0));
+}
+
+TEST_F(AThroughputMeter, ForgetsAmountsBeforeWindow) {
+    meter.record(100_mb);
+    for (int second = 1; second <= 15; ++second) {
+        meter.update(start + second * 1s);
+        meter.record(1_mb);
+    }
+    meter.update(start + 16s);
+    ASSERT_THAT(meter.window_rate(), Eq(megabytes_per_second(1_mb)));
+}
+
+TEST_F(AThroughputMeter, MeasuresWholeTimeUntilWindowIsFull) {
+    meter.record(4_mb);
+    meter.update(start + 2s);
+    meter.update(start + 4s);
+    ASSERT_THAT(meter.window_rate(), Eq(megabytes_per_second(1_mb)));
+}
+
+TEST_F(AThroughputMeter, CountsRecordsOfAllThreads) {
+    std::vector<std::jthread> threads;
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([this] {
+            for (int chunk = 0; chunk < 1'000; ++chunk) {
+                meter.record(64_kb);
+            }
+        });
+    }
+    threads.clear();
+    meter.update(start + 1s);
+    ASSERT_THAT(meter.total(), Eq(kilobytes(4 * 1'000 * 64)));
+    ASSERT_THAT(meter.average_rate(), Eq(memory_rate<kilobytes>(kilobytes(4 * 1'000 * 64))));
+}
@@ -0,0 +1,218 @@
+#include "mem_units/memory_scope.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+using ::testing::Eq;
+using ::testing::StartsWith;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+using namespace std::chrono_literals;
+
+namespace {
+    std::vector<memory_scope_record> drained() {
+        std::vector<memory_scope_record> records;
+        (void)memory_tracer::instance().drain([&records](const memory_scope_record &record) { records.push_back(record); });
+        return records;
+    }
+
+    /// Counts one more kilobyte allocated on every call.
+    allocation_counts growing_counts() noexcept {
+        static thread_local std::uint64_t calls = 0;
+        return {.allocated = bytes(kilobytes(++calls))};
+    }
+}
+
+class AMemoryScope : public ::testing::Test {
+protected:
+    void SetUp() override {
+        memory_tracer::instance().set_allocation_counter(nullptr);
+        (void)drained();
+    }
+
+    void TearDown() override {
+        memory_tracer::instance().set_allocation_counter(nullptr);
+    }
+};
+
+TEST_F(AMemoryScope, RecordsCountedAllocations) {
+    {
+        const memory_scope scope("allocating");
+        count_allocation(3_kb);
+        count_deallocation(1_kb);
+    }
+    const auto records = drained();
+    ASSERT_THAT(records.size(), Eq(1));
+    ASSERT_THAT(std::string(records[0].name), Eq("allocating"));
+    ASSERT_THAT(records[0].allocated, Eq(3_kb));
+    ASSERT_THAT(records[0].deallocated, Eq(1_kb));
+    ASSERT_THAT(records[0].depth, Eq(0));
+    ASSERT_THAT(records[0].rss_begin, Eq(0_b));
+}
+
+TEST_F(AMemoryScope, NestsScopes) {
+    {
+        const memory_scope outer("outer");
+        count_allocation(1_kb);
+        {
+            const memory_scope inner("inner");
+            count_allocation(2_kb);
+        }
+    }
+    const auto records = drained();
+    ASSERT_THAT(records.size(), Eq(2));
+    ASSERT_THAT(std::string(records[0].name), Eq("inner"));
+    ASSERT_THAT(records[0].depth, Eq(1));
+    ASSERT_THAT(records[0].allocated, Eq(2_kb));
+    ASSERT_THAT(std::string(records[1].name), Eq("outer"));
+    ASSERT_THAT(records[1].depth, Eq(0));
+    ASSERT_THAT(records[1].allocated, Eq(3_kb));
+    ASSERT_TRUE(records[1].begin <= records[0].begin);
+    ASSERT_TRUE(records[1].duration >= records[0].duration);
+}
+
+TEST_F(AMemoryScope, CountsByGivenAllocationCounter) {
+    memory_tracer::instance().set_allocation_counter(&growing_counts);
+    ASSERT_THAT(memory_tracer::instance().counter(), Eq(&growing_counts));
+    {
+        const memory_scope scope("growing");
+        count_allocation(1_mb);
+    }
+    const auto records = drained();
+    ASSERT_THAT(records.size(), Eq(1));
+    ASSERT_THAT(records[0].allocated, Eq(1_kb));
+}
+
+#if defined(__linux__)
+TEST_F(AMemoryScope, SamplesResidentSetSizeOnRequest) {
+    // mapped directly, since memory freed to the heap by previous tests may still be resident
+    const auto size = bytes(16_mb).count();
+    void *mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapped, MAP_FAILED);
+    {
+        const memory_scope scope("touching", rss_sampling::on);
+        std::memset(mapped, 'x', size);
+    }
+    ::munmap(mapped, size);
+    const auto records = drained();
+    ASSERT_THAT(records.size(), Eq(1));
+    ASSERT_TRUE(records[0].rss_begin > 0_b);
+    ASSERT_TRUE(records[0].rss_end >= records[0].rss_begin + 8_mb);
+}
+#endif
+
+TEST_F(AMemoryScope, KeepsRecordsOfExitedThreads) {
+    std::jthread([] {
+        const memory_scope scope("worker");
+        count_allocation(64_b);
+    }).join();
+    const auto records = drained();
+    ASSERT_THAT(records.size(), Eq(1));
+    ASSERT_THAT(records[0].allocated, Eq(64_b));
+    ASSERT_TRUE(drained().empty());
+}
+
+TEST_F(AMemoryScope, DropsRecordsOfScopesEndingAfterTheRingWasGivenUp) {
+    struct late_scope {
+        ~late_scope() {
+            // frees the ring of this thread, which is marked as exited already
+            (void)drained();
+            const memory_scope scope("late");
+        }
+    };
+    const auto dropped = memory_tracer::instance().dropped();
+    std::jthread([] {
+        // constructed before the ring, so destroyed after it was given up
+        thread_local const late_scope late;
+        const memory_scope scope("worker");
+    }).join();
+    ASSERT_THAT(memory_tracer::instance().dropped(), Eq(dropped + 1));
+    ASSERT_TRUE(drained().empty());
+}
+
+TEST_F(AMemoryScope, DropsRecordsWhenRingIsFull) {
+    const auto dropped = memory_tracer::instance().dropped();
+    for (std::size_t scope = 0; scope < memory_trace_ring::capacity + 10; ++scope) {
+        const memory_scope counted("counted");
+    }
+    ASSERT_THAT(memory_tracer::instance().dropped(), Eq(dropped + 10));
+    ASSERT_THAT(drained().size(), Eq(memory_trace_ring::capacity));
+}
+
+TEST_F(AMemoryScope, IsDrainedByBackgroundThread) {
+    const auto dropped = memory_tracer::instance().dropped();
+    std::vector<memory_scope_record> records;
+    {
+        memory_trace_drainer drainer([&records](const memory_scope_record &record) { records.push_back(record); }, 1ms);
+        std::jthread([] {
+            for (int scope = 0; scope < 10'000; ++scope) {
+                const memory_scope counted("counted");
+            }
+        }).join();
+    }
+    ASSERT_TRUE(records.size() >= memory_trace_ring::capacity);
+    ASSERT_THAT(records.size() + memory_tracer::instance().dropped() - dropped, Eq(10'000));
+}
+
+TEST(AChromeTraceWriter, WritesCompleteEvents) {
+    std::ostringstream out;
+    {
+        chrome_trace_writer writer(out);
+        writer(memory_scope_record{
+            .name = "parse \"batch\"",
+            .begin = std::chrono::steady_clock::time_point(1'234'567ns),
+            .duration = 2'005ns,
+            .allocated = bytes(4_kb),
+            .deallocated = bytes(1_kb),
+            .thread = 3,
+            .depth = 1,
+        });
+        writer(memory_scope_record{.name = "rss", .rss_begin = bytes(2_mb), .rss_end = bytes(1_mb)});
+    }
+    ASSERT_THAT(out.str(), Eq(std::string(R"({"traceEvents":[)") + "\n" +
+        R"({"name":"parse \"batch\"","cat":"memory","ph":"X","pid":1,"tid":3,"ts":1234.567,"dur":2.005,)"
+        R"("args":{"depth":1,"allocated":4096,"deallocated":1024}},)" + "\n" +
+        R"({"name":"rss","cat":"memory","ph":"X","pid":1,"tid":0,"ts":0.000,"dur":0.000,)"
+        R"("args":{"depth":0,"allocated":0,"deallocated":0,"rss_delta":-1048576}}]})" "\n"));
+}
+
+TEST(AChromeTraceWriter, WritesEmptyTrace) {
+    std::ostringstream out;
+    {
+        chrome_trace_writer writer(out);
+    }
+    ASSERT_THAT(out.str(), Eq("{\"traceEvents\":[]}\n"));
+}
+
+TEST(ABinaryTraceWriter, WritesEachNameOnce) {
+    std::ostringstream out;
+    binary_trace_writer writer(out);
+    const char *name = "scope";
+    writer(memory_scope_record{.name = name, .allocated = bytes(1_kb)});
+    writer(memory_scope_record{.name = name, .allocated = bytes(2_kb)});
+    const auto written = out.str();
+    constexpr std::size_t name_entry = 1 + 4 + 4 + 5;
+    constexpr std::size_t scope_entry = 1 + 3 * 4 + 6 * 8;
+    ASSERT_THAT(written, StartsWith("afsmsc01"));
+    ASSERT_THAT(written.size(), Eq(8 + name_entry + 2 * scope_entry));
+    ASSERT_THAT(written.substr(8 + 9, 5), Eq("scope"));
+    std::uint64_t allocated = 0;
+    std::memcpy(&allocated, written.data() + 8 + name_entry + scope_entry + 1 + 3 * 4 + 2 * 8, sizeof(allocated));
+    ASSERT_THAT(allocated, Eq(2'048));
+}
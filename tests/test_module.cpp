@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <format>
+#include <string>
+
+import afs.mem_units;
+
+using ::testing::Eq;
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+// only built with the afs.mem_units module, see MEM_UNITS_BUILD_MODULE in CMakeLists.txt
+
+namespace {
+    using saturating_bytes32 = with_overflow_policy_t<bytes32, saturating_overflow>;
+}
+
+static_assert(MemoryUnitType<kilobytes32>);
+static_assert(std::is_same_v<std::common_type_t<kilobytes, bytes>, bytes>);
+static_assert(1_mb == 1'024_kb);
+
+TEST(AMemUnitsModule, ExportsArithmetic) {
+    ASSERT_THAT(1_kb + 512_b, Eq(1'536_b));
+    ASSERT_THAT(memory_unit_cast<kilobytes>(3_mb), Eq(3'072_kb));
+    ASSERT_THAT(saturating_bytes32(5) - saturating_bytes32(7), Eq(saturating_bytes32(0)));
+}
+
+TEST(AMemUnitsModule, ExportsFormatter) {
+    ASSERT_THAT(std::format("{:h}", 1'536_mb), Eq(std::string("1.5gb")));
+}
+
+TEST(AMemUnitsModule, ExportsKnownUnits) {
+    ASSERT_THAT(memory_unit_suffix<petabytes>(), Eq("pb"));
+    ASSERT_THAT(known_units.size(), Eq(8));
+}
@@ -0,0 +1,159 @@
+#include "mem_units/format.hpp"
+#include "mem_units/parse.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <random>
+#include <string>
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(ASuffix, DenotesKnownUnitCaseInsensitive) {
+    static_assert(unit_from_suffix("bit")->suffix == "bit");
+    static_assert(unit_from_suffix("Bits")->suffix == "bit");
+    static_assert(unit_from_suffix("B")->suffix == "b");
+    static_assert(unit_from_suffix("bytes")->suffix == "b");
+    static_assert(unit_from_suffix("k")->suffix == "kb");
+    static_assert(unit_from_suffix("KB")->suffix == "kb");
+    static_assert(unit_from_suffix("MiB")->suffix == "mb");
+    static_assert(unit_from_suffix("g")->suffix == "gb");
+    static_assert(unit_from_suffix("TiB")->suffix == "tb");
+    static_assert(unit_from_suffix("pb")->suffix == "pb");
+    static_assert(unit_from_suffix("EiB")->suffix == "eb");
+}
+
+TEST(ASuffix, IsRejectedIfUnknown) {
+    static_assert(not unit_from_suffix(""));
+    static_assert(not unit_from_suffix("x"));
+    static_assert(not unit_from_suffix("kbit"));
+    static_assert(not unit_from_suffix("mbb"));
+}
+
+TEST(AParsedMemoryUnit, IsParsedAtCompileTime) {
+    static_assert(parse_memory_unit<kilobytes>("1.5 MiB") == 1'536_kb);
+}
+
+TEST(AParsedMemoryUnit, IsCountOfBytesWithoutSuffix) {
+    ASSERT_THAT(parse_memory_unit<bytes>("4096"), Optional(Eq(4'096_b)));
+}
+
+TEST(AParsedMemoryUnit, SupportsEverySuffixOfTheLibrary) {
+    for (const auto &unit : known_units) {
+        const auto text = std::format("8{}", unit.suffix);
+        const bytes expected(8 * static_cast<bytes::rep>(unit.num) / static_cast<bytes::rep>(unit.den));
+        ASSERT_THAT(parse_memory_unit<bytes>(text), Optional(Eq(expected))) << text;
+    }
+}
+
+TEST(AParsedMemoryUnit, SupportsCommonSpellings) {
+    EXPECT_THAT(parse_memory_unit<bytes>("512k"), Optional(Eq(512_kb)));
+    EXPECT_THAT(parse_memory_unit<megabytes>("1.5GiB"), Optional(Eq(1'536_mb)));
+    EXPECT_THAT(parse_memory_unit<megabytes>("64 MB"), Optional(Eq(64_mb)));
+    EXPECT_THAT(parse_memory_unit<bytes>("  2\tkb \n"), Optional(Eq(2_kb)));
+    EXPECT_THAT(parse_memory_unit<bytes>(".5k"), Optional(Eq(512_b)));
+    EXPECT_THAT(parse_memory_unit<bytes>("16 bits"), Optional(Eq(2_b)));
+    EXPECT_THAT(parse_memory_unit<exabytes>("16eb"), Optional(Eq(16_eb)));
+}
+
+TEST(AParsedMemoryUnit, IsRejectedIfMalformed) {
+    EXPECT_THAT(parse_memory_unit<bytes>(""), Eq(std::unexpected(std::errc::invalid_argument)));
+    EXPECT_THAT(parse_memory_unit<bytes>("  "), Eq(std::unexpected(std::errc::invalid_argument)));
+    EXPECT_THAT(parse_memory_unit<bytes>("kb"), Eq(std::unexpected(std::errc::invalid_argument)));
+    EXPECT_THAT(parse_memory_unit<bytes>("."), Eq(std::unexpected(std::errc::invalid_argument)));
+    EXPECT_THAT(parse_memory_unit<bytes>("-1kb"), Eq(std::unexpected(std::errc::invalid_argument)));
+    EXPECT_THAT(parse_memory_unit<bytes>("12 apples"), Eq(std::unexpected(std::errc::invalid_argument)));
+    EXPECT_THAT(parse_memory_unit<bytes>("1kb 2kb"), Eq(std::unexpected(std::errc::invalid_argument)));
+}
+
+TEST(AParsedMemoryUnit, IsRejectedIfTooBig) {
+    EXPECT_THAT(parse_memory_unit<bytes>("16eb"), Eq(std::unexpected(std::errc::result_out_of_range)));
+    EXPECT_THAT(parse_memory_unit<bytes>("18446744073709551616"), Eq(std::unexpected(std::errc::result_out_of_range)));
+    EXPECT_THAT(parse_memory_unit<bytes>("18446744073709551615"), Optional(Eq(bytes(18'446'744'073'709'551'615ULL))));
+}
+
+TEST(AParsedMemoryUnit, IsRejectedIfNotRepresentableExactly) {
+    EXPECT_THAT(parse_memory_unit<kilobytes>("1000b"), Eq(std::unexpected(std::errc::result_out_of_range)));
+    EXPECT_THAT(parse_memory_unit<bytes>("0.1kb"), Eq(std::unexpected(std::errc::result_out_of_range)));
+}
+
+TEST(AMemoryUnitFromChars, RoundsDownAndReportsLoss) {
+    constexpr std::string_view text = "1500b";
+    kilobytes value{};
+    const auto result = from_chars(text.data(), text.data() + text.size(), value);
+    ASSERT_THAT(result, Eq(memory_unit_from_chars_result{text.data() + text.size(), std::errc{}, false}));
+    ASSERT_THAT(value, Eq(1_kb));
+}
+
+TEST(AMemoryUnitFromChars, StopsBehindTheAmount) {
+    constexpr std::string_view text = "64 MB, 32 MB";
+    megabytes value{};
+    const auto result = from_chars(text.data(), text.data() + text.size(), value);
+    ASSERT_THAT(result, Eq(memory_unit_from_chars_result{text.data() + 5, std::errc{}, true}));
+    ASSERT_THAT(value, Eq(64_mb));
+}
+
+TEST(AMemoryUnitFromChars, DoesNotConsumeTrailingBlanksWithoutSuffix) {
+    constexpr std::string_view text = "42 ";
+    bytes value{};
+    const auto result = from_chars(text.data(), text.data() + text.size(), value);
+    ASSERT_THAT(result.ptr, Eq(text.data() + 2));
+}
+
+TEST(AMemoryUnitFromChars, KeepsValueOnFailure) {
+    constexpr std::string_view text = "1 xb";
+    bytes value = 7_b;
+    const auto result = from_chars(text.data(), text.data() + text.size(), value);
+    ASSERT_THAT(result, Eq(memory_unit_from_chars_result{text.data(), std::errc::invalid_argument, false}));
+    ASSERT_THAT(value, Eq(7_b));
+}
+
+TEST(AMemoryUnitFromChars, TruncatesExcessFractionalDigitsAndReportsLoss) {
+    constexpr std::string_view text = "1.00000000000000000000000001kb";
+    bytes value{};
+    const auto result = from_chars(text.data(), text.data() + text.size(), value);
+    ASSERT_THAT(result.ec, Eq(std::errc{}));
+    ASSERT_FALSE(result.exact);
+    ASSERT_THAT(value, Eq(1_kb));
+}
+
+TEST(AMemoryUnitFromChars, RoundTripsFormattedUnits) {
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 10'000; ++i) {
+        const bytes original(random() >> (random() % 64));
+        bytes parsed{};
+        const auto text = std::format("{}", original);
+        const auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+        ASSERT_THAT(result.ec, Eq(std::errc{})) << text;
+        ASSERT_THAT(parsed, Eq(original)) << text;
+    }
+}
+
+TEST(AMemoryUnitFromChars, SurvivesRandomInput) {
+    constexpr std::string_view alphabet = "0123456789.  \tkKmMgGtTpPeEiIbBytsx-+";
+    std::mt19937_64 random(1'977);
+    for (int i = 0; i < 100'000; ++i) {
+        std::string text(random() % 24, ' ');
+        for (auto &character : text) {
+            character = random() % 8 == 0 ? static_cast<char>(random()) : alphabet[random() % alphabet.size()];
+        }
+        kilobytes value{};
+        const auto result = from_chars(text.data(), text.data() + text.size(), value);
+        ASSERT_GE(result.ptr, text.data());
+        ASSERT_LE(result.ptr, text.data() + text.size());
+        if (result.ec == std::errc::invalid_argument) {
+            ASSERT_THAT(result.ptr, Eq(text.data()));
+        }
+        std::ignore = parse_memory_unit<kilobytes>(text);
+    }
+}
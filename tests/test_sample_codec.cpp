@@ -0,0 +1,146 @@
+#include "mem_units/sample_codec.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    /// Counts spanning all varint lengths, including the extremes of \t MemoryUnit.
+    template<SampleMemoryUnitType MemoryUnit>
+    std::vector<MemoryUnit> samples_of_all_lengths() {
+        using rep = typename MemoryUnit::rep;
+        std::mt19937_64 random(42);
+        std::vector<MemoryUnit> samples{MemoryUnit{std::numeric_limits<rep>::max()}, MemoryUnit{0},
+                                        MemoryUnit{std::numeric_limits<rep>::min()}, MemoryUnit{1}};
+        for (int shift = 0; shift < 64; ++shift) {
+            samples.emplace_back(static_cast<rep>(random() >> shift));
+        }
+        // a slowly changing series, as most samples are
+        for (int step = 0; step < 1'000; ++step) {
+            samples.emplace_back(static_cast<rep>(samples.back().count() + static_cast<rep>(random() % 7) - 3));
+        }
+        return samples;
+    }
+
+    template<SampleMemoryUnitType MemoryUnit>
+    std::vector<MemoryUnit> round_trip(const std::vector<MemoryUnit> &samples) {
+        std::vector<std::byte> encoded;
+        encode_samples(std::span(samples), encoded);
+        std::vector<MemoryUnit> decoded(samples.size());
+        const auto [rest, size, ec] = decode_samples(std::span<const std::byte>(encoded), std::span(decoded));
+        EXPECT_THAT(ec, Eq(std::errc{}));
+        EXPECT_THAT(size, Eq(samples.size()));
+        EXPECT_TRUE(rest.empty());
+        return decoded;
+    }
+
+    template<SampleMemoryUnitType... MemoryUnits>
+    void assert_round_trips() {
+        ([] {
+            const auto samples = samples_of_all_lengths<MemoryUnits>();
+            ASSERT_THAT(round_trip(samples), Eq(samples));
+        }(), ...);
+    }
+}
+
+TEST(ASampleCodec, RoundTripsAllUnits) {
+    assert_round_trips<bits, bytes, kilobytes, megabytes, gigabytes, terabytes, petabytes, exabytes>();
+}
+
+TEST(ASampleCodec, RoundTripsOtherReps) {
+    assert_round_trips<bytes32, kilobytes16, with_rep_t<bytes, std::int64_t>, with_rep_t<kilobytes, std::int8_t> >();
+}
+
+TEST(ASampleCodec, RoundTripsEmptySequence) {
+    ASSERT_TRUE(round_trip(std::vector<bytes>{}).empty());
+}
+
+TEST(ASampleCodec, EncodesSmallDeltasInOneByte) {
+    const std::vector<kilobytes> samples{1'000_kb, 1'001_kb, 999_kb, 999_kb, 1'062_kb};
+    std::vector<std::byte> encoded;
+    encode_samples(std::span(samples), encoded);
+    // ratio 1024 and 1 take three bytes, the size one, the first sample two and the others one each
+    ASSERT_THAT(encoded.size(), Eq(3 + 1 + 2 + 4));
+    ASSERT_THAT(std::vector(encoded.begin() + 6, encoded.end()),
+                ElementsAre(std::byte{2}, std::byte{3}, std::byte{0}, std::byte{126}));
+}
+
+TEST(ASampleCodec, WritesHeaderOncePerBlock) {
+    const std::vector<megabytes> samples(10, 5_mb);
+    std::vector<std::byte> encoded;
+    encode_samples(std::span(samples), encoded);
+    ASSERT_THAT(peek_sample_block(encoded), Eq(sample_block_header{1 << 20, 1, 10}));
+    ASSERT_TRUE(peek_sample_block(encoded)->holds<megabytes>());
+    ASSERT_FALSE(peek_sample_block(encoded)->holds<kilobytes>());
+}
+
+TEST(ASampleCodec, DecodesConsecutiveBlocks) {
+    const std::vector<bytes> first{1_b, 2_b};
+    const std::vector<bytes> second{3_b};
+    std::vector<std::byte> encoded;
+    encode_samples(std::span(first), encoded);
+    encode_samples(std::span(second), encoded);
+    std::vector<bytes> decoded(2);
+    auto result = decode_samples(std::span<const std::byte>(encoded), std::span(decoded));
+    ASSERT_THAT(decoded, ElementsAre(1_b, 2_b));
+    result = decode_samples(result.rest, std::span(decoded));
+    ASSERT_THAT(result.size, Eq(1));
+    ASSERT_THAT(decoded[0], Eq(3_b));
+    ASSERT_TRUE(result.rest.empty());
+}
+
+TEST(ASampleCodec, RejectsOtherUnit) {
+    const std::vector<kilobytes> samples{1_kb};
+    std::vector<std::byte> encoded;
+    encode_samples(std::span(samples), encoded);
+    std::vector<bytes> decoded(1);
+    const auto result = decode_samples(std::span<const std::byte>(encoded), std::span(decoded));
+    ASSERT_THAT(result.ec, Eq(std::errc::invalid_argument));
+    ASSERT_THAT(result.rest.size(), Eq(encoded.size()));
+}
+
+TEST(ASampleCodec, RejectsTruncatedBlock) {
+    const auto samples = samples_of_all_lengths<bytes>();
+    std::vector<std::byte> encoded;
+    encode_samples(std::span(samples), encoded);
+    std::vector<bytes> decoded(samples.size());
+    for (const std::size_t size : {std::size_t{0}, std::size_t{2}, encoded.size() / 2, encoded.size() - 1}) {
+        const auto result = decode_samples(std::span<const std::byte>(encoded).first(size), std::span(decoded));
+        ASSERT_THAT(result.ec, Eq(std::errc::invalid_argument));
+    }
+}
+
+TEST(ASampleCodec, RejectsTooSmallSpans) {
+    const std::vector<bytes> samples{1_b, 2_b};
+    std::vector<std::byte> encoded(max_encoded_size(1));
+    ASSERT_THROW((void)encode_samples(std::span(samples), std::span(encoded)), std::invalid_argument);
+    encoded.clear();
+    encode_samples(std::span(samples), encoded);
+    std::vector<bytes> decoded(1);
+    const auto result = decode_samples(std::span<const std::byte>(encoded), std::span(decoded));
+    ASSERT_THAT(result.ec, Eq(std::errc::result_out_of_range));
+}
+
+TEST(ASampleCodec, RejectsSamplesNotFittingRep) {
+    const std::vector<bytes> samples{bytes{70'000}};
+    std::vector<std::byte> encoded;
+    encode_samples(std::span(samples), encoded);
+    std::vector<bytes16> decoded(1);
+    const auto result = decode_samples(std::span<const std::byte>(encoded), std::span(decoded));
+    ASSERT_THAT(result.ec, Eq(std::errc::result_out_of_range));
+}
@@ -0,0 +1,112 @@
+#include "mem_units/sharded_memory_counter.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+using ::testing::Le;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(AShardedMemoryCounter, IsEmptyWhenConstructed) {
+    const sharded_memory_counter<bytes> counter;
+    ASSERT_THAT(counter.read(), Eq(0_b));
+    ASSERT_THAT(counter.snapshot(), Eq(0_b));
+}
+
+TEST(AShardedMemoryCounter, RoundsShardCountUpToPowerOfTwo) {
+    const sharded_memory_counter<bytes> counter(1_kb, 5);
+    ASSERT_THAT(counter.shard_count(), Eq(8));
+    ASSERT_THAT(counter.error_bound(), Eq(8_kb));
+}
+
+TEST(AShardedMemoryCounter, SnapshotIsExactBelowBatchSize) {
+    sharded_memory_counter<bytes> counter(1_mb);
+    counter.add(3_kb);
+    counter.sub(1'024_b);
+    ASSERT_THAT(counter.snapshot(), Eq(2_kb));
+    ASSERT_THAT(counter.read(), Eq(0_b));
+}
+
+TEST(AShardedMemoryCounter, FoldsIntoReadOnceBatchSizeIsReached) {
+    sharded_memory_counter<bytes> counter(1_kb);
+    counter.add(512_b);
+    counter.add(2_kb);
+    ASSERT_THAT(counter.read(), Eq(2'560_b));
+    ASSERT_THAT(counter.snapshot(), Eq(2'560_b));
+}
+
+TEST(AShardedMemoryCounter, FoldsNegativeAmounts) {
+    sharded_memory_counter<kilobytes> counter(kilobytes(4), 1);
+    counter.add(1_mb);
+    counter.sub(kilobytes(1'020));
+    ASSERT_THAT(counter.read(), Eq(4_kb));
+    counter.sub(3_kb);
+    ASSERT_THAT(counter.read(), Eq(4_kb));
+    ASSERT_THAT(counter.snapshot(), Eq(1_kb));
+}
+
+TEST(AShardedMemoryCounter, IsExactAndBoundedAfterConcurrentModification) {
+    constexpr int thread_count = 16;
+    constexpr int iterations = 20'000;
+    sharded_memory_counter<bytes> counter(64_kb, 4);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&counter, thread] {
+            for (int i = 0; i < iterations; ++i) {
+                counter.add(1_kb);
+                counter.sub(bytes(1'024 - thread % 2));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const bytes expected(thread_count / 2 * iterations);
+    ASSERT_THAT(counter.snapshot(), Eq(expected));
+    ASSERT_THAT((counter.snapshot() - counter.read()).count(), Le(counter.error_bound().count()));
+}
+
+TEST(AShardedMemoryCounter, IsExactWhenMemoryIsReleasedOnAnotherThread) {
+    sharded_memory_counter<bytes> counter(1_mb, 2);
+    std::thread([&counter] { counter.add(4_kb); }).join();
+    std::thread([&counter] { counter.sub(3_kb); }).join();
+    ASSERT_THAT(counter.snapshot(), Eq(1_kb));
+}
+
+TEST(AThisThreadShardIndex, IsReusedAfterThreadExited) {
+    (void) this_thread_shard_index();
+    std::size_t first = 0;
+    std::size_t second = 0;
+    std::thread([&first] { first = this_thread_shard_index(); }).join();
+    std::thread([&second] { second = this_thread_shard_index(); }).join();
+    ASSERT_THAT(second, Eq(first));
+    ASSERT_THAT(first, ::testing::Ne(this_thread_shard_index()));
+}
+
+TEST(AThisThreadShardIndex, IsSharedInThreadLocalsDestroyedAfterItWasGivenBack) {
+    struct late_user {
+        std::size_t *index = nullptr;
+        ~late_user() { *index = this_thread_shard_index(); }
+    };
+    std::size_t own = 0;
+    std::size_t late = 0;
+    std::thread([&own, &late] {
+        // constructed before the number is handed out, so destroyed after it was given back
+        thread_local late_user user;
+        user.index = &late;
+        own = this_thread_shard_index();
+    }).join();
+    ASSERT_THAT(own, ::testing::Ne(shared_shard_index));
+    ASSERT_THAT(late, Eq(shared_shard_index));
+}
@@ -0,0 +1,147 @@
+#include "mem_units/size_histogram.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    using no_sub_buckets = size_buckets<0>;
+    using four_sub_buckets = size_buckets<2>;
+}
+
+TEST(SizeBuckets, AreIndexedByPowerOfTwoOfBits) {
+    static_assert(no_sub_buckets::index(0_b) == 0);
+    static_assert(no_sub_buckets::index(1_bit) == 1);
+    static_assert(no_sub_buckets::index(1_b) == 4);
+    static_assert(no_sub_buckets::index(4_kb) == 16);
+    static_assert(no_sub_buckets::index(bytes(4_kb)) == 16);
+    static_assert(no_sub_buckets::index(4_kb + 1_b) == 16);
+    static_assert(no_sub_buckets::index(8_kb - 1_b) == 16);
+    static_assert(no_sub_buckets::index(bytes{std::numeric_limits<std::uint64_t>::max()}) == 67);
+    ASSERT_THAT(no_sub_buckets::index(exabytes{std::numeric_limits<std::uint64_t>::max()}), Eq(1 + 126));
+}
+
+TEST(SizeBuckets, SplitPowersOfTwoIntoSubBuckets) {
+    static_assert(four_sub_buckets::index(4_kb) == 1 + 15 * 4);
+    static_assert(four_sub_buckets::index(5_kb) == 1 + 15 * 4 + 1);
+    static_assert(four_sub_buckets::index(6_kb) == 1 + 15 * 4 + 2);
+    static_assert(four_sub_buckets::index(7_kb + 1'023_b) == 1 + 15 * 4 + 3);
+    static_assert(four_sub_buckets::index(1_bit) == 1);
+    static_assert(four_sub_buckets::index(bits{3}) == 1 + 4 + 2);
+}
+
+TEST(SizeBuckets, ConvertUnitsWithOtherRatios) {
+    using three_bytes = memory_unit<std::uint64_t, std::ratio<3> >;
+    static_assert(four_sub_buckets::index(three_bytes{1}) == four_sub_buckets::index(bits{24}));
+    static_assert(four_sub_buckets::index(three_bytes{1'000'000}) == four_sub_buckets::index(bytes{3'000'000}));
+    ASSERT_THAT(four_sub_buckets::index(three_bytes{std::numeric_limits<std::uint64_t>::max()}),
+                Eq(four_sub_buckets::index(bytes{std::numeric_limits<std::uint64_t>::max()}) + 6));
+}
+
+TEST(SizeBuckets, HaveBoundsInBytes) {
+    static_assert(four_sub_buckets::lower_bound(four_sub_buckets::index(5_kb)) == 5_kb);
+    static_assert(four_sub_buckets::upper_bound(four_sub_buckets::index(5_kb)) == 6_kb);
+    static_assert(four_sub_buckets::lower_bound(four_sub_buckets::index(5_kb + 100_b)) == 5_kb);
+    static_assert(no_sub_buckets::upper_bound(no_sub_buckets::index(100_b)) == 128_b);
+    static_assert(no_sub_buckets::upper_bound(no_sub_buckets::index(1_bit)) == 1_b);
+    static_assert(no_sub_buckets::upper_bound(no_sub_buckets::count - 1)
+                  == bytes{std::numeric_limits<std::uint64_t>::max()});
+}
+
+TEST(ASizeHistogram, CountsRecordedValues) {
+    size_histogram<> histogram;
+    histogram.record(100_b);
+    histogram.record(120_b, 2);
+    histogram.record(4_kb);
+    const auto snapshot = histogram.snapshot();
+    ASSERT_THAT(snapshot.total(), Eq(4));
+    ASSERT_THAT(snapshot.count(no_sub_buckets::index(100_b)), Eq(3));
+    ASSERT_THAT(snapshot.min(), Eq(128_b));
+    ASSERT_THAT(snapshot.max(), Eq(8_kb));
+}
+
+TEST(ASizeHistogram, CountsValuesRecordedByLateThreadLocals) {
+    struct late_recorder {
+        size_histogram<> *histogram = nullptr;
+        ~late_recorder() { histogram->record(100_b); }
+    };
+    size_histogram<> histogram(1);
+    std::thread([&histogram] {
+        // destroyed after the shard index of the thread was given back, so records into a shared shard
+        thread_local late_recorder recorder;
+        recorder.histogram = &histogram;
+        histogram.record(100_b);
+    }).join();
+    ASSERT_THAT(histogram.snapshot().total(), Eq(2));
+}
+
+TEST(ASizeHistogram, ReturnsPercentiles) {
+    size_histogram<2> histogram;
+    for (int index = 0; index < 99; ++index) {
+        histogram.record(64_b);
+    }
+    histogram.record(1_mb);
+    const auto snapshot = histogram.snapshot();
+    ASSERT_THAT(snapshot.percentile(0.5), Eq(80_b));
+    ASSERT_THAT(snapshot.percentile(0.99), Eq(80_b));
+    ASSERT_THAT(snapshot.percentile(1.0), Eq(1_mb + 256_kb));
+    ASSERT_THAT(snapshot.percentile(0.0), Eq(80_b));
+}
+
+TEST(ASizeHistogram, IsEmptyInitially) {
+    const size_histogram<> histogram;
+    const auto snapshot = histogram.snapshot();
+    ASSERT_THAT(snapshot.total(), Eq(0));
+    ASSERT_THAT(snapshot.percentile(0.99), Eq(0_b));
+    ASSERT_THAT(snapshot.max(), Eq(0_b));
+}
+
+TEST(ASizeHistogram, MergesSnapshots) {
+    size_histogram<> first;
+    size_histogram<> second;
+    first.record(1_kb);
+    second.record(1_kb);
+    second.record(1_mb);
+    auto merged = first.snapshot() + second.snapshot();
+    ASSERT_THAT(merged.total(), Eq(3));
+    ASSERT_THAT(merged.count(no_sub_buckets::index(1_kb)), Eq(2));
+    merged += first.snapshot();
+    ASSERT_THAT(merged.total(), Eq(4));
+}
+
+TEST(ASizeHistogram, Resets) {
+    size_histogram<> histogram;
+    histogram.record(1_kb);
+    histogram.reset();
+    ASSERT_THAT(histogram.snapshot().total(), Eq(0));
+}
+
+TEST(ASizeHistogram, RecordsFromManyThreads) {
+    // fewer shards than threads, so some threads share theirs
+    size_histogram<1> histogram(2);
+    std::vector<std::jthread> threads;
+    for (int thread = 0; thread < 8; ++thread) {
+        threads.emplace_back([&histogram] {
+            for (int index = 0; index < 10'000; ++index) {
+                histogram.record(bytes{static_cast<std::uint64_t>(index % 64 + 1)});
+            }
+        });
+    }
+    threads.clear();
+    const auto snapshot = histogram.snapshot();
+    ASSERT_THAT(snapshot.total(), Eq(80'000));
+    ASSERT_THAT(snapshot.max(), Eq(96_b));
+}
@@ -0,0 +1,121 @@
+#include "mem_units/tracking_memory_resource.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+TEST(AnAllocationSizeClass, IsRoundedUpPowerOfTwo) {
+    static_assert(allocation_size_class(0_b) == 0);
+    static_assert(allocation_size_class(1_b) == 0);
+    static_assert(allocation_size_class(2_b) == 1);
+    static_assert(allocation_size_class(3_b) == 2);
+    static_assert(allocation_size_class(bytes(4_kb)) == 12);
+    static_assert(allocation_size_class(4_kb + 1_b) == 13);
+    ASSERT_THAT(allocation_size_class(bytes(1_eb)), Eq(allocation_size_class_count - 1));
+    ASSERT_THAT(allocation_size_class_limit(12), Eq(4_kb));
+}
+
+TEST(ATrackingMemoryResource, AccountsAllocations) {
+    tracking_memory_resource tracking;
+    void *small = tracking.allocate(24, 8);
+    void *large = tracking.allocate(4'096, 64);
+    auto stats = tracking.stats();
+    ASSERT_THAT(stats.live, Eq(4'120_b));
+    ASSERT_THAT(stats.allocations, Eq(2));
+    ASSERT_THAT(stats.size_classes[5], Eq(1));
+    ASSERT_THAT(stats.size_classes[12], Eq(1));
+
+    tracking.deallocate(large, 4'096, 64);
+    stats = tracking.stats();
+    ASSERT_THAT(stats.live, Eq(24_b));
+    ASSERT_THAT(stats.peak, Eq(4'120_b));
+    ASSERT_THAT(stats.allocated, Eq(4'120_b));
+    ASSERT_THAT(stats.deallocations, Eq(1));
+    tracking.deallocate(small, 24, 8);
+    ASSERT_THAT(tracking.stats().live, Eq(0_b));
+}
+
+TEST(ATrackingMemoryResource, TracksPeakAcrossBatches) {
+    tracking_memory_resource tracking(std::pmr::new_delete_resource(), 1_kb);
+    std::vector<void *> blocks;
+    for (int index = 0; index < 100; ++index) {
+        blocks.push_back(tracking.allocate(100));
+    }
+    for (auto *block : blocks) {
+        tracking.deallocate(block, 100);
+    }
+    blocks.push_back(tracking.allocate(5'000));
+    const auto stats = tracking.stats();
+    ASSERT_THAT(stats.live, Eq(5'000_b));
+    ASSERT_THAT(stats.peak, Eq(10'000_b));
+    ASSERT_THAT(stats.allocated, Eq(15'000_b));
+    tracking.deallocate(blocks.back(), 5'000);
+}
+
+TEST(ATrackingMemoryResource, WorksWithContainers) {
+    tracking_memory_resource tracking;
+    {
+        std::pmr::vector<std::uint64_t> values(&tracking);
+        values.reserve(1'000);
+        ASSERT_THAT(tracking.stats().live, Eq(8'000_b));
+    }
+    const auto stats = tracking.stats();
+    ASSERT_THAT(stats.live, Eq(0_b));
+    ASSERT_THAT(stats.peak, Eq(8'000_b));
+}
+
+TEST(ATrackingMemoryResource, ForwardsToUpstream) {
+    tracking_memory_resource inner;
+    tracking_memory_resource outer(&inner);
+    ASSERT_THAT(outer.upstream(), Eq(&inner));
+    void *block = outer.allocate(64);
+    ASSERT_THAT(inner.stats().live, Eq(64_b));
+    outer.deallocate(block, 64);
+    ASSERT_THAT(inner.stats().live, Eq(0_b));
+    ASSERT_TRUE(outer.is_equal(outer));
+    ASSERT_FALSE(outer.is_equal(inner));
+}
+
+TEST(ATrackingMemoryResource, AccountsAllocationsOfManyThreads) {
+    // fewer shards than threads, so some threads share theirs
+    tracking_memory_resource tracking(std::pmr::new_delete_resource(), 4_kb, 2);
+    std::array<std::vector<void *>, 8> blocks;
+    std::vector<std::jthread> threads;
+    for (auto &thread_blocks : blocks) {
+        threads.emplace_back([&tracking, &thread_blocks] {
+            for (int index = 0; index < 1'000; ++index) {
+                thread_blocks.push_back(tracking.allocate(32));
+            }
+            for (std::size_t index = 0; index < 500; ++index) {
+                tracking.deallocate(thread_blocks[index], 32);
+            }
+        });
+    }
+    threads.clear();
+    const auto stats = tracking.stats();
+    for (const auto &thread_blocks : blocks) {
+        for (std::size_t index = 500; index < thread_blocks.size(); ++index) {
+            tracking.deallocate(thread_blocks[index], 32);
+        }
+    }
+    ASSERT_THAT(stats.allocations, Eq(8'000));
+    ASSERT_THAT(stats.deallocations, Eq(4'000));
+    ASSERT_THAT(stats.live, Eq(128'000_b));
+    ASSERT_THAT(stats.allocated, Eq(256'000_b));
+    ASSERT_THAT(stats.size_classes[5], Eq(8'000));
+    ASSERT_THAT(tracking.stats().live, Eq(0_b));
+}
@@ -2,6 +2,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "../inc/mem_units.hpp"
 
 using ::testing::Eq;
@@ -154,6 +157,51 @@ TEST(AMemoryUnit, CanCompareGreaterWithSmallerUnitType) {
     ASSERT_GT(6000_kb, 2_mb);
 }
 
+TEST(AMemoryUnit, ComparesExactlyAcrossRatios) {
+    static_assert((1_kb <=> 1'024_b) == std::strong_ordering::equal);
+    static_assert((1_kb <=> 1'025_b) == std::strong_ordering::less);
+    static_assert((1'025_b <=> 1_kb) == std::strong_ordering::greater);
+    static_assert(1'023_b < 1_kb && 1'024_b <= 1_kb && 1_kb >= 1'024_b && 1_kb != 1'025_b);
+    static_assert(9_bit > 1_b && 9_bit != 1_b && 8_bit == 1_b);
+}
+
+TEST(AMemoryUnit, ComparesWithoutOverflow) {
+    constexpr bits most_bits(std::numeric_limits<std::uint64_t>::max());
+    static_assert(noexcept(std::declval<const exabytes &>() <=> most_bits));
+    static_assert(16_eb > most_bits);
+    ASSERT_TRUE(exabytes(std::numeric_limits<std::uint64_t>::max()) > most_bits);
+    ASSERT_TRUE(bits(std::uint64_t{1} << 63) == 1_eb);
+    ASSERT_TRUE(bits((std::uint64_t{1} << 63) + 1) > 1_eb);
+}
+
+TEST(AMemoryUnit, ComparesNonMultipleRatios) {
+    using decimal_kilobytes = memory_unit<std::uint64_t, std::ratio<1'000>>;
+    static_assert(decimal_kilobytes(128) == 125_kb);
+    static_assert(decimal_kilobytes(129) > 125_kb);
+    static_assert(decimal_kilobytes(127) < 125_kb);
+    ASSERT_TRUE(decimal_kilobytes(std::numeric_limits<std::uint64_t>::max()) > 1'000_eb);
+}
+
+TEST(AMemoryUnit, ComparesSignedAndFloatingPointReps) {
+    using signed_kilobytes = memory_unit<std::int32_t, kilobytes::ratio>;
+    using signed_bytes = memory_unit<std::int64_t, bytes::ratio>;
+    static_assert(signed_kilobytes(-1) < 0_b);
+    static_assert(signed_kilobytes(-1) == signed_bytes(-1'024));
+    static_assert(signed_kilobytes(-1) < signed_bytes(-1'023));
+    static_assert(signed_kilobytes(-1) > signed_bytes(-1'025));
+    static_assert(signed_bytes(-1) < bytes32(0));
+    using fractional_kilobytes = memory_unit<double, kilobytes::ratio>;
+    static_assert((fractional_kilobytes(0.5) <=> 512_b) == std::partial_ordering::equivalent);
+    static_assert(fractional_kilobytes(0.75) > 512_b);
+}
+
+TEST(AMemoryUnit, IsTotallyOrdered) {
+    static_assert(std::totally_ordered<bytes>);
+    std::vector<kilobytes> values{3_kb, 1_kb, 2_kb};
+    std::ranges::sort(values);
+    ASSERT_THAT(values, ::testing::ElementsAre(1_kb, 2_kb, 3_kb));
+}
+
 TEST(AMemoryUnit, CanCastToSameUnitType) {
     ASSERT_THAT(memory_unit_cast<kilobytes>(42_kb), Eq(42_kb));
 }
@@ -256,4 +304,170 @@ TEST(MultiplicationOverflowCheck, ReturnsTrueIfResultDoesntFitInSignedType) {
     ASSERT_TRUE(wouldMultiplicationOverflow(op1, op2));
     constexpr int8_t op3 = 12, op4 = 11;
     ASSERT_TRUE(wouldMultiplicationOverflow(op3, op4));
-}
\ No newline at end of file
+}
+TEST(AMemoryUnit, ThrowsOnOverflowByDefault) {
+    static_assert(std::is_same_v<bytes::overflow_policy, checked_overflow>);
+    static_assert(not noexcept(1_b + 1_b));
+    ASSERT_THROW(std::ignore = bytes(std::numeric_limits<bytes::rep>::max()) + 1_b, std::overflow_error);
+}
+
+TEST(AMemoryUnit, WithSaturatingPolicyClampsAdditionToMax) {
+    using test_unit = with_overflow_policy_t<memory_unit<std::uint8_t, std::ratio<1>>, saturating_overflow>;
+    ASSERT_THAT((test_unit(250) + test_unit(10)).count(), Eq(255));
+    auto value = test_unit(200);
+    value += test_unit(100);
+    ASSERT_THAT(value.count(), Eq(255));
+}
+
+TEST(AMemoryUnit, WithSaturatingPolicyClampsSubtractionToMin) {
+    ASSERT_THAT(saturating_bytes(10) - saturating_bytes(12), Eq(saturating_bytes(0)));
+}
+
+TEST(AMemoryUnit, WithSaturatingPolicyClampsCastToMax) {
+    constexpr auto converted = memory_unit_cast<saturating_bytes>(exabytes(42));
+    ASSERT_THAT(converted.count(), Eq(std::numeric_limits<saturating_bytes::rep>::max()));
+}
+
+TEST(AMemoryUnit, WithWrappingPolicyWrapsAround) {
+    using test_unit = with_overflow_policy_t<memory_unit<std::int8_t, std::ratio<1>>, wrapping_overflow>;
+    ASSERT_THAT((test_unit(120) + test_unit(10)).count(), Eq(-126));
+    ASSERT_THAT((test_unit(-120) - test_unit(42)).count(), Eq(94));
+    ASSERT_THAT(wrapping_bytes(1) - wrapping_bytes(2), Eq(wrapping_bytes(std::numeric_limits<std::uint64_t>::max())));
+}
+
+TEST(AMemoryUnit, WithUncheckedPolicyBehavesLikeItsRep) {
+    static_assert(sizeof(unchecked_bytes) == sizeof(std::uint64_t));
+    static_assert(std::is_trivially_copyable_v<unchecked_bytes>);
+    static_assert(noexcept(unchecked_bytes{} + unchecked_bytes{}));
+    static_assert(noexcept(unchecked_bytes{} - unchecked_bytes{}));
+    static_assert(noexcept(std::declval<unchecked_bytes&>() += unchecked_bytes{}));
+    constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    static_assert((unchecked_bytes(max) + unchecked_bytes(2)).count() == max + 2);
+    static_assert((unchecked_bytes(0) - unchecked_bytes(1)).count() == 0 - std::uint64_t{1});
+    ASSERT_THAT(unchecked_kilobytes(3) + unchecked_megabytes(1), Eq(unchecked_kilobytes(1027)));
+}
+
+TEST(AMemoryUnit, IsConstructibleFromOtherOverflowPolicy) {
+    const unchecked_bytes converted(2_kb);
+    ASSERT_THAT(converted.count(), Eq(2048));
+}
+
+TEST(AMemoryUnit, HasSuffixIndependentOfOverflowPolicy) {
+    ASSERT_THAT(memory_unit_suffix<saturating_megabytes>(), Eq("mb"));
+}
+
+TEST(AMemoryUnit, CastThrowsExactlyAbovePowerOfTwoThreshold) {
+    constexpr auto threshold = detail::multiplication_threshold<kilobytes::rep, 1'024>;
+    ASSERT_THAT(memory_unit_cast<bytes>(kilobytes(threshold)), Eq(bytes(threshold * 1'024)));
+    ASSERT_THROW(std::ignore = memory_unit_cast<bytes>(kilobytes(threshold + 1)), std::overflow_error);
+}
+
+TEST(AMemoryUnit, CastsBetweenNonPowerOfTwoRatios) {
+    using decimal_kilobytes = memory_unit<std::uint64_t, std::ratio<1'000>>;
+    ASSERT_THAT(memory_unit_cast<bytes>(decimal_kilobytes(3)), Eq(3'000_b));
+    ASSERT_THAT(memory_unit_cast<decimal_kilobytes>(2_kb).count(), Eq(2));
+    ASSERT_THROW(std::ignore = memory_unit_cast<bytes>(decimal_kilobytes(std::numeric_limits<std::uint64_t>::max() / 999)), std::overflow_error);
+}
+
+TEST(PowerOfTwoCheck, DetectsPowersOfTwo) {
+    static_assert(detail::is_power_of_two(1));
+    static_assert(detail::is_power_of_two(1'024));
+    static_assert(detail::is_power_of_two(exabytes::ratio::num));
+    static_assert(not detail::is_power_of_two(0));
+    static_assert(not detail::is_power_of_two(-8));
+    static_assert(not detail::is_power_of_two(1'000));
+}
+
+TEST(Scaling, ShiftsUnsignedRepsByPowersOfTwo) {
+    static_assert(detail::scale_up<1'024>(std::uint64_t{3}) == 3'072);
+    static_assert(detail::scale_down<8>(std::uint64_t{65}) == 8);
+    static_assert(detail::scale_up<1'024>(std::uint8_t{1}) == 0);
+    static_assert(detail::scale_down<1'024>(std::uint8_t{255}) == 0);
+}
+
+TEST(Scaling, MultipliesAndDividesOtherwise) {
+    static_assert(detail::scale_up<1'000>(std::uint64_t{3}) == 3'000);
+    static_assert(detail::scale_up<1'024>(std::int64_t{-3}) == -3'072);
+    static_assert(detail::scale_down<1'000>(std::uint64_t{2'999}) == 2);
+}
+
+TEST(MultiplicationOverflowCheck, UsesCompileTimeThresholdForConstantFactor) {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    static_assert(not wouldMultiplicationOverflow<1>(max));
+    static_assert(not wouldMultiplicationOverflow<8>(max >> 3));
+    static_assert(wouldMultiplicationOverflow<8>((max >> 3) + 1));
+    static_assert(wouldMultiplicationOverflow<65>(std::int8_t{-2}));
+    static_assert(not wouldMultiplicationOverflow<42>(std::int8_t{-3}));
+}
+
+TEST(ACompactMemoryUnit, HasSizeOfItsRep) {
+    static_assert(sizeof(kilobytes32) == sizeof(std::uint32_t));
+    static_assert(sizeof(kilobytes16) == sizeof(std::uint16_t));
+    static_assert(std::is_same_v<with_rep_t<saturating_megabytes, std::uint32_t>::overflow_policy, saturating_overflow>);
+    ASSERT_THAT(memory_unit_suffix<kilobytes16>(), Eq("kb"));
+}
+
+TEST(ACompactMemoryUnit, IsConstructibleFromOtherRep) {
+    constexpr kilobytes32 from_wider(4_mb);
+    static_assert(from_wider.count() == 4'096);
+    constexpr bytes from_narrower(kilobytes16(3));
+    static_assert(from_narrower.count() == 3'072);
+}
+
+TEST(ACompactMemoryUnit, ChecksNarrowingOnConversion) {
+    ASSERT_THROW(kilobytes32{8_tb}, std::overflow_error);
+    ASSERT_THROW(std::ignore = memory_unit_cast<bytes16>(kilobytes32(64)), std::overflow_error);
+    ASSERT_THAT(memory_unit_cast<bytes16>(kilobytes32(63)).count(), Eq(64'512));
+    using saturating_kilobytes16 = with_rep_t<saturating_kilobytes, std::uint16_t>;
+    using wrapping_kilobytes16 = with_rep_t<wrapping_kilobytes, std::uint16_t>;
+    ASSERT_THAT(memory_unit_cast<saturating_kilobytes16>(1_gb).count(), Eq(65'535));
+    ASSERT_THAT(memory_unit_cast<wrapping_kilobytes16>(65'537_kb).count(), Eq(1));
+}
+
+TEST(ACompactMemoryUnit, ChecksNegativeCountsOnConversion) {
+    using signed_kilobytes = memory_unit<std::int32_t, kilobytes::ratio>;
+    ASSERT_THROW(std::ignore = memory_unit_cast<bytes>(signed_kilobytes(-1)), std::underflow_error);
+    ASSERT_THAT(memory_unit_cast<saturating_bytes>(with_rep_t<signed_kilobytes, std::int64_t>(-1)).count(), Eq(0));
+}
+
+TEST(ACompactMemoryUnit, IsAssignableFromOtherRep) {
+    megabytes16 value;
+    value = 2_gb;
+    ASSERT_THAT(value.count(), Eq(2'048));
+    ASSERT_THROW(value = 64_gb, std::overflow_error);
+}
+
+TEST(ACompactMemoryUnit, AddsAndSubtractsInCommonType) {
+    static_assert(std::is_same_v<std::common_type_t<kilobytes32, bytes>, bytes>);
+    static_assert(std::is_same_v<std::common_type_t<kilobytes16, megabytes32>, kilobytes32>);
+    static_assert(std::is_same_v<std::common_type_t<bits16, bits16>, bits16>);
+    const auto sum = kilobytes32(3) + 512_b;
+    static_assert(std::is_same_v<decltype(sum), const bytes>);
+    ASSERT_THAT(sum, Eq(3'584_b));
+    ASSERT_THAT(megabytes16(1) - kilobytes32(24), Eq(kilobytes32(1'000)));
+    ASSERT_THROW(std::ignore = bytes32(1) - bytes16(2), std::underflow_error);
+}
+
+namespace {
+    template<typename Lhs, typename Rhs>
+    concept HasCommonType = requires { typename std::common_type<Lhs, Rhs>::type; };
+}
+
+TEST(ACompactMemoryUnit, HasNoCommonTypeWithOtherOverflowPolicy) {
+    static_assert(HasCommonType<kilobytes32, bytes>);
+    static_assert(not HasCommonType<kilobytes32, saturating_bytes>);
+}
+
+TEST(ACompactMemoryUnit, ComparesWithOtherRep) {
+    ASSERT_THAT(kilobytes16(2), Eq(2'048_b));
+    ASSERT_TRUE(megabytes32(1) > kilobytes16(1'023));
+}
+
+TEST(AFloatingPointMemoryUnit, AddsAndConvertsWithCheckedOverflowPolicy) {
+    using fractional_bytes = with_rep_t<bytes, double>;
+    using fractional_kilobytes = with_rep_t<kilobytes, double>;
+    ASSERT_THAT(fractional_bytes{1.5} + fractional_bytes{0.5}, Eq(2_b));
+    ASSERT_THAT(fractional_bytes{0.5} - fractional_bytes{1.5}, Eq(fractional_bytes{-1.0}));
+    ASSERT_THAT(memory_unit_cast<fractional_kilobytes>(fractional_bytes{512.0}).count(), Eq(0.5));
+    ASSERT_THAT(bytes(fractional_kilobytes{1.5}), Eq(1'536_b));
+}
@@ -0,0 +1,146 @@
+#include "mem_units/weighted_cache.hpp"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+namespace afs::mem_units {
+    template<MemoryUnitType MemoryUnit>
+    void PrintTo(const MemoryUnit& memunit, std::ostream* os) {
+        *os << memunit.count() << memory_unit_suffix<MemoryUnit>();
+    }
+}
+
+using namespace afs::mem_units;
+using namespace afs::mem_units::literals;
+
+namespace {
+    /// Weighs an entry by its value in kilobytes.
+    bytes kilobytes_of(const int &, const int &value) {
+        return bytes(kilobytes(static_cast<std::uint64_t>(value)));
+    }
+}
+
+TEST(AWeightedCache, ReturnsCachedValues) {
+    weighted_cache<std::string, std::string> cache{1_kb};
+    ASSERT_TRUE(cache.put("key", "value"));
+    ASSERT_THAT(cache.get("key"), Optional(Eq("value")));
+    ASSERT_THAT(cache.get("other"), Eq(std::nullopt));
+}
+
+TEST(AWeightedCache, WeighsEntriesByKeyAndValueByDefault) {
+    weighted_cache<std::string, std::string> cache{1_kb, {}, 1};
+    (void)cache.put("key", std::string(100, 'x'));
+    ASSERT_THAT(cache.stats().resident, Eq(103_b));
+}
+
+TEST(AWeightedCache, ReplacesValueOfSameKey) {
+    weighted_cache<int, int> cache{64_kb, kilobytes_of, 1};
+    (void)cache.put(1, 8);
+    (void)cache.put(1, 4);
+    ASSERT_THAT(cache.get(1), Optional(Eq(4)));
+    ASSERT_THAT(cache.stats().resident, Eq(4_kb));
+    ASSERT_THAT(cache.stats().entries, Eq(1));
+}
+
+TEST(AWeightedCache, EvictsUntilNewEntryFits) {
+    weighted_cache<int, int> cache{10_kb, kilobytes_of, 1};
+    for (int key = 0; key < 5; ++key) {
+        (void)cache.put(key, 2);
+    }
+    ASSERT_TRUE(cache.put(5, 5));
+    const auto stats = cache.stats();
+    ASSERT_THAT(stats.resident, Eq(9_kb));
+    ASSERT_THAT(stats.evictions, Eq(3));
+    ASSERT_THAT(cache.get(5), Optional(Eq(5)));
+}
+
+TEST(AWeightedCache, KeepsReferencedEntriesWhenEvicting) {
+    weighted_cache<int, int> cache{4_kb, kilobytes_of, 1};
+    for (int key = 0; key < 4; ++key) {
+        (void)cache.put(key, 1);
+    }
+    (void)cache.get(0);
+    (void)cache.get(2);
+    (void)cache.put(4, 2);
+    ASSERT_TRUE(cache.get(0).has_value());
+    ASSERT_TRUE(cache.get(2).has_value());
+    ASSERT_FALSE(cache.get(1).has_value());
+    ASSERT_FALSE(cache.get(3).has_value());
+}
+
+TEST(AWeightedCache, RejectsEntriesHeavierThanShard) {
+    weighted_cache<int, int> cache{8_kb, kilobytes_of, 2};
+    (void)cache.put(1, 1);
+    ASSERT_FALSE(cache.put(1, 5));
+    ASSERT_THAT(cache.get(1), Eq(std::nullopt));
+}
+
+TEST(AWeightedCache, ErasesEntries) {
+    weighted_cache<int, int> cache{8_kb, kilobytes_of, 1};
+    (void)cache.put(1, 1);
+    ASSERT_TRUE(cache.erase(1));
+    ASSERT_FALSE(cache.erase(1));
+    ASSERT_THAT(cache.stats().resident, Eq(0_b));
+}
+
+TEST(AWeightedCache, CountsHitsAndMisses) {
+    weighted_cache<int, int> cache{8_kb, kilobytes_of};
+    (void)cache.put(1, 1);
+    (void)cache.get(1);
+    (void)cache.get(1);
+    (void)cache.get(2);
+    const auto stats = cache.stats();
+    ASSERT_THAT(stats.hits, Eq(2));
+    ASSERT_THAT(stats.misses, Eq(1));
+    ASSERT_THAT(stats.hit_ratio(), Eq(2.0 / 3.0));
+}
+
+TEST(AWeightedCache, SplitsCapacityEvenlyOverShards) {
+    weighted_cache<int, int> cache{1_mb, kilobytes_of, 3};
+    ASSERT_THAT(cache.shard_count(), Eq(4));
+    ASSERT_THAT(cache.capacity(), Eq(1_mb));
+    for (std::size_t shard = 0; shard < cache.shard_count(); ++shard) {
+        ASSERT_THAT(cache.shard_stats(shard).capacity, Eq(256_kb));
+    }
+}
+
+TEST(AWeightedCache, EvictsWhenShrunk) {
+    weighted_cache<int, int> cache{16_kb, kilobytes_of, 1};
+    for (int key = 0; key < 8; ++key) {
+        (void)cache.put(key, 2);
+    }
+    cache.set_capacity(7_kb);
+    ASSERT_THAT(cache.capacity(), Eq(7_kb));
+    ASSERT_THAT(cache.stats().resident, Eq(6_kb));
+    cache.set_capacity(1_mb);
+    ASSERT_TRUE(cache.put(100, 512));
+}
+
+TEST(AWeightedCache, StaysWithinCapacityUnderConcurrentUse) {
+    weighted_cache<int, int> cache{256_kb, kilobytes_of, 8};
+    {
+        std::vector<std::jthread> threads;
+        for (int thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&cache, thread] {
+                for (int round = 0; round < 10'000; ++round) {
+                    const int key = (round * 7 + thread) % 500;
+                    if (not cache.get(key)) {
+                        (void)cache.put(key, 1 + key % 16);
+                    }
+                }
+            });
+        }
+    }
+    const auto stats = cache.stats();
+    ASSERT_TRUE(stats.resident <= 256_kb);
+    ASSERT_THAT(stats.hits + stats.misses, Eq(80'000));
+    for (std::size_t shard = 0; shard < cache.shard_count(); ++shard) {
+        ASSERT_TRUE(cache.shard_stats(shard).resident <= 32_kb);
+    }
+}